@@ -0,0 +1,811 @@
+// -*- coding: utf-8 -*-
+// bench.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 14:12:37.804519276 (1792332757)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Benchmarks of the services of libpdb with the N-Pancake
+//
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <getopt.h>
+
+#include "../../src/pdb.h"
+#include "../helpers.h"
+
+#include "npancake_t.h"
+
+using namespace std;
+
+extern "C" {
+    char *xstrdup (char *p);
+}
+
+/* Globals */
+char *program_name;                       // The name the program was run with,
+
+static struct option const long_options[] =
+{
+    {"benchmark", required_argument, 0, 'b'},
+    {"goal", required_argument, 0, 'g'},
+    {"ppattern", required_argument, 0, 'p'},
+    {"cpattern", required_argument, 0, 'c'},
+    {"variant", required_argument, 0, 'r'},
+    {"runs", required_argument, 0, 'n'},
+    {"threads", required_argument, 0, 't'},
+    {"file", required_argument, 0, 'f'},
+    {"factors", required_argument, 0, 'k'},
+    {"thresholds", required_argument, 0, 'T'},
+    {"verbose", no_argument, 0, 'v'},
+    {"help", no_argument, 0, 'h'},
+    {"version", no_argument, 0, 'V'},
+    {NULL, 0, NULL, 0}
+};
+
+void bench_open (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                 const vector<string>& variants, const int runs);
+void bench_large (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                  const vector<string>& variants, const int nbthreads, const string& filename);
+void bench_fold (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                 const vector<string>& variants, const vector<int>& factors, const string& filename);
+void bench_partial (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                    const vector<string>& variants, const vector<int>& thresholds);
+void bench_lookup (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                   const vector<string>& variants, const int runs, const int nbthreads, const string& filename);
+void bench_batch (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                  const vector<string>& variants, const int runs);
+static int decode_switches (int argc, char **argv,
+                            string& benchmark, string& goal, string& ppattern, string& cpattern,
+                            string& variants, int& runs, int& nbthreads, string& filename,
+                            string& factors, string& thresholds, bool& want_verbose);
+static void usage (int status);
+
+// main entry point
+int main (int argc, char** argv) {
+
+    string benchmark;                               // benchmark to perform
+    string sgoal;    // explicit representation of the goal in the range [1, N]
+    string ppattern;                  // pattern used to mask values in the PDB
+    string cpattern;       // pattern used to traverse the abstract state space
+    string svariants;                            // variants of the domain
+    int runs;                      // number of times each experiment is run
+    int nbthreads;                           // number of threads to use
+    string filename;                   // file used to store PDBs, if any
+    string sfactors;                     // factors used to fold PDBs
+    string sthresholds;        // thresholds used to create partial PDBs
+    bool want_verbose;                  // whether verbose output was requested
+
+    // variables
+    program_name = argv[0];
+    vector<string> benchmark_choices = {"open", "large", "fold", "partial", "lookup", "batch"};
+    vector<string> variant_choices = {"unit", "heavy-cost"};
+
+    // arg parse ---and trim strings
+    decode_switches (argc, argv, benchmark, sgoal, ppattern, cpattern, svariants, runs, nbthreads, filename, sfactors, sthresholds, want_verbose);
+    sgoal = trim (sgoal);
+    ppattern = trim (ppattern);
+    cpattern = trim (cpattern);
+
+    // parameter checking
+
+    // --benchmark
+    if (!get_choice (benchmark, benchmark_choices)) {
+        cerr << "\n Please, provide a correct name for the benchmark with --benchmark" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --goal
+    if (sgoal == "") {
+        cerr << "\n Please, provide a explicit representation of the goal state" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // check the goal state consists of a permutation of the range [1, N]
+    auto cgoal = string_to_int (sgoal);
+    sort (cgoal.begin (), cgoal.end ());
+    if (adjacent_find (cgoal.begin (), cgoal.end ()) != cgoal.end () ||
+        cgoal[0] != 1 || cgoal[cgoal.size ()-1]!= cgoal.size ()) {
+        cerr << "\n The goal has to be given as a blank separated list of distinct digits in the range [1, N]" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --ppattern
+    if (ppattern == "" || !in (ppattern, "-*") || ppattern.size () != cgoal.size ()) {
+        cerr << "\n Please, provide a pattern with characters '-' and '*' with the same length than the goal" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --cpattern
+    if (cpattern == "") {
+        cpattern = ppattern;
+    } else if (!in (cpattern, "-*") || cpattern.size () != cgoal.size ()) {
+        cerr << "\n The c-pattern can contain only characters '-' and '*' and it must have the same length than the goal" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --variant
+    vector<string> variants = string_to_string (svariants);
+    for (auto& variant : variants) {
+        if (!get_choice (variant, variant_choices)) {
+            cerr << "\n Please, provide correct names for the variants with --variant" << endl;
+            cerr << " See " << program_name << " --help for more details" << endl << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // --runs
+    if (runs < 1) {
+        cerr << "\n The number of runs must be strictly positive" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --threads
+    if (nbthreads < 1) {
+        cerr << "\n The number of threads must be strictly positive" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --file
+    if (filename == "") {
+        filename = (filesystem::temp_directory_path () / "bench.pdb").string ();
+    }
+
+    // --factors
+    vector<int> factors = string_to_int (sfactors);
+    if (factors.empty () || any_of (factors.begin (), factors.end (), [] (int factor) { return factor < 1; })) {
+        cerr << "\n The factors must be a blank separated list of strictly positive numbers" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --thresholds
+    vector<int> thresholds = string_to_int (sthresholds);
+    if (thresholds.empty () || any_of (thresholds.begin (), thresholds.end (), [] (int threshold) { return threshold < 0 || threshold > 255; })) {
+        cerr << "\n The thresholds must be a blank separated list of numbers in the range [0, 255]" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    /* do the work */
+
+    /* !------------------------- INITIALIZATION --------------------------! */
+
+    cout << endl;
+    vector<int> goal = string_to_int (sgoal);
+    cout << " benchmark: " << benchmark << endl;
+    cout << " goal     : "; print (goal); cout << endl;
+    cout << " p-pattern: " << ppattern << endl;
+    cout << " c-pattern: " << cpattern << endl;
+    cout << " variants : "; print (variants); cout << endl;
+    cout << " runs     : " << runs << endl;
+    if (benchmark == "large" || benchmark == "lookup") {
+        cout << " threads  : " << nbthreads << endl;
+    }
+    if (benchmark == "large" || benchmark == "fold" || benchmark == "lookup") {
+        cout << " file     : " << filename << endl;
+    }
+    if (benchmark == "fold") {
+        cout << " factors  : "; print (factors); cout << endl;
+    }
+    if (benchmark == "partial") {
+        cout << " thresholds: "; print (thresholds); cout << endl;
+    }
+    cout << " -------------------------------------------------------------" << endl << endl;
+
+    /* !---------------------------- BENCHMARK ----------------------------! */
+
+    if (benchmark == "open") {
+        bench_open (goal, cpattern, ppattern, variants, runs);
+    } else if (benchmark == "large") {
+        bench_large (goal, cpattern, ppattern, variants, nbthreads, filename);
+    } else if (benchmark == "fold") {
+        bench_fold (goal, cpattern, ppattern, variants, factors, filename);
+    } else if (benchmark == "partial") {
+        bench_partial (goal, cpattern, ppattern, variants, thresholds);
+    } else if (benchmark == "lookup") {
+        bench_lookup (goal, cpattern, ppattern, variants, runs, nbthreads, filename);
+    } else if (benchmark == "batch") {
+        bench_batch (goal, cpattern, ppattern, variants, runs);
+    }
+
+    /* !-------------------------------------------------------------------! */
+
+    // Well done! Keep up the good job!
+    cout << endl;
+    return (EXIT_SUCCESS);
+}
+
+// initialize the N-Pancake with the given variant. The default cost of the
+// heavy-cost variant is computed wrt the c-pattern because that is the one
+// used when searching in the abstract state space
+void init_variant (const string& variant, const vector<int>& goal, const string& cpattern) {
+
+    if (variant == "unit") {
+        npancake_t::init (npancake_variant::unit, 1);
+    } else {
+        npancake_t::init (npancake_variant::heavy_cost,
+                          npancake_t::compute_default_cost (goal, cpattern));
+    }
+}
+
+// generate the PDB with the open list OpenT as many times as given in runs and
+// return the average generation time in seconds. The contents of the last PDB
+// generated and the number of expansions are returned in the last parameters
+template<template<typename> class OpenT>
+double generate (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                 const int runs, vector<pdb::pdbval_t>& contents, size_t& nbexpansions) {
+
+    double elapsed = 0.0;
+    for (auto i = 0 ; i < runs ; i++) {
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        outpdb.generate<OpenT> (false);
+        elapsed += 1e-9*chrono::duration_cast<chrono::nanoseconds>(outpdb.get_elapsed_time ()).count();
+
+        // copy the contents of the PDB of the last run
+        if (i == runs - 1) {
+            contents = vector<pdb::pdbval_t> (outpdb.capacity ());
+            for (pdb::pdboff_t j = 0 ; j < outpdb.capacity () ; j++) {
+                contents[j] = outpdb[j];
+            }
+            nbexpansions = outpdb.get_nbexpansions ();
+        }
+    }
+    return elapsed / runs;
+}
+
+// compare the generation of PDBs using open_t, ring_t and radix_t as open
+// lists with every variant. The contents of all PDBs are verified to be the
+// same
+void bench_open (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                 const vector<string>& variants, const int runs) {
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+        cout << " variant: " << variant << endl;
+        cout << "   open list |   time (s) |  speedup | # expansions | PDB" << endl;
+        cout << "  -----------+------------+----------+--------------+-----" << endl;
+
+        // use open_t as the reference
+        vector<pdb::pdbval_t> reference, contents;
+        size_t nbexpansions;
+        double base = generate<pdb::open_t> (goal, cpattern, ppattern, runs, reference, nbexpansions);
+
+        auto show = [&] (const string& name, const double elapsed, const bool ok) {
+            cout << "   " << setw (9) << name << " | "
+                 << fixed << setprecision (6) << setw (10) << elapsed << " | "
+                 << setprecision (2) << setw (8) << base / elapsed << " | "
+                 << setw (12) << nbexpansions << " | " << (ok ? "Ok!" : "Differ!") << endl;
+        };
+        show ("open_t", base, true);
+
+        double elapsed = generate<pdb::ring_t> (goal, cpattern, ppattern, runs, contents, nbexpansions);
+        show ("ring_t", elapsed, contents == reference);
+
+        elapsed = generate<pdb::radix_t> (goal, cpattern, ppattern, runs, contents, nbexpansions);
+        show ("radix_t", elapsed, contents == reference);
+        cout << endl;
+    }
+}
+
+// exercise all services of libpdb involved in the lifecycle of a large PDB with
+// every variant: generation (both in memory and directly in the file),
+// validation, write, read, map and verification. The time and throughput of
+// every phase are shown, and the contents of the PDB read are verified to be
+// the same generated
+void bench_large (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                  const vector<string>& variants, const int nbthreads, const string& filename) {
+
+    // return the number of seconds since the given start
+    auto seconds = [] (const chrono::time_point<chrono::high_resolution_clock>& start) {
+        return 1e-9*chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now () - start).count();
+    };
+
+    pdb::pdboff_t pspace = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ppattern);
+    double mbytes = 1e-6 * pdb::encoding_bytes (pdb::pdb_encoding::byte, pspace);
+    cout << " address space: " << pspace << " (" << fixed << setprecision (2) << mbytes << " MB)" << endl << endl;
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+        cout << " variant: " << variant << endl;
+        cout << "   phase      |   time (s) |       MB/s | result" << endl;
+        cout << "  ------------+------------+------------+--------" << endl;
+
+        auto show = [&] (const string& name, const double elapsed, const bool ok) {
+            cout << "   " << setw (10) << left << name << right << " | "
+                 << fixed << setprecision (6) << setw (10) << elapsed << " | "
+                 << setprecision (2) << setw (10) << mbytes / elapsed << " | "
+                 << (ok ? "Ok!" : "Failed!") << endl;
+        };
+
+        // generation in memory
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        auto start = chrono::high_resolution_clock::now ();
+        outpdb.generate (false, nbthreads);
+        show ("generate", seconds (start), true);
+
+        // validation
+        start = chrono::high_resolution_clock::now ();
+        bool ok = outpdb.doctor ();
+        show ("doctor", seconds (start), ok);
+
+        // write
+        start = chrono::high_resolution_clock::now ();
+        ok = outpdb.write (filename, pdb::pdb_format::v2, nbthreads);
+        show ("write", seconds (start), ok);
+
+        // read, verifying that the contents are the same generated
+        {
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb (filename);
+            start = chrono::high_resolution_clock::now ();
+            ok = inpdb.read () == pspace;
+            show ("read", seconds (start), ok);
+
+            start = chrono::high_resolution_clock::now ();
+            ok = inpdb.verify (nbthreads);
+            show ("verify", seconds (start), ok);
+
+            start = chrono::high_resolution_clock::now ();
+            ok = true;
+            for (pdb::pdboff_t idx = 0 ; ok && idx < pspace ; idx++) {
+                ok = pdb::pdbval_t (outpdb[idx] - 1) == inpdb[idx];
+            }
+            show ("compare", seconds (start), ok);
+        }
+
+        // map
+        {
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb (filename);
+            start = chrono::high_resolution_clock::now ();
+            ok = inpdb.map (pdb::pdb_advice::sequential) == pspace && inpdb.verify (nbthreads);
+            show ("map+verify", seconds (start), ok);
+        }
+
+        // generation directly in the file
+        {
+            pdb::outpdb<pdb::node_t<npancake_t>> mpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+            mpdb.map (filename);
+            start = chrono::high_resolution_clock::now ();
+            mpdb.generate (false, nbthreads);
+            ok = mpdb.write (filename, pdb::pdb_format::v2, nbthreads);
+            show ("in-place", seconds (start), ok);
+        }
+
+        error_code ec;
+        filesystem::remove (filename, ec);
+        cout << endl;
+    }
+}
+
+// fold the PDB with every factor and grouping with every variant, and show
+// the memory taken by the cells and the average h lost wrt the original PDB,
+// so that the factor can be chosen per pattern. The folded PDB is verified to
+// be admissible, i.e., its values never exceed those of the original PDB
+void bench_fold (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                 const vector<string>& variants, const vector<int>& factors, const string& filename) {
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+
+        // generate the PDB, and read it from a file as folded PDBs are
+        // built from PDBs which have been already loaded
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        outpdb.generate (false);
+        if (!outpdb.write (filename, pdb::pdb_format::v2)) {
+            cerr << " Error while writing the PDB into " << filename << endl << endl;
+            exit(EXIT_FAILURE);
+        }
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (filename);
+        pdb::pdboff_t pspace = inpdb.read ();
+        double mbytes = 1e-6 * inpdb.get_nbbytes ();
+        double sum = 0.0;
+        for (pdb::pdboff_t idx = 0 ; idx < pspace ; idx++) {
+            sum += inpdb[idx];
+        }
+
+        cout << " variant: " << variant << " (" << fixed << setprecision (2) << mbytes << " MB, average h: "
+             << setprecision (4) << sum / pspace << ")" << endl;
+        cout << "   factor | grouping |       MB |  saved (%) | avg h lost | result" << endl;
+        cout << "  --------+----------+----------+------------+------------+--------" << endl;
+
+        for (auto factor : factors) {
+            for (auto grouping : {pdb::pdb_grouping::block, pdb::pdb_grouping::modulo}) {
+                pdb::folded<pdb::node_t<npancake_t>> fpdb (inpdb, factor, grouping);
+                bool ok = true;
+                for (pdb::pdboff_t idx = 0 ; ok && idx < pspace ; idx++) {
+                    ok = fpdb[fpdb.cell (idx)] <= inpdb[idx];
+                }
+                double fbytes = 1e-6 * fpdb.get_nbbytes ();
+                cout << "   " << setw (6) << factor << " | " << setw (8) << pdb::to_string (grouping) << " | "
+                     << setprecision (2) << setw (8) << fbytes << " | "
+                     << setw (10) << 100.0 * (1.0 - fbytes / mbytes) << " | "
+                     << setprecision (4) << setw (10) << fpdb.get_loss () << " | "
+                     << (ok ? "Ok!" : "Inadmissible!") << endl;
+            }
+        }
+
+        error_code ec;
+        filesystem::remove (filename, ec);
+        cout << endl;
+    }
+}
+
+// create a partial PDB with every threshold and every variant, and show the
+// number of locations stored, the memory they take, and the fraction of the
+// sum of all values retained, so that the threshold can be chosen per
+// pattern. The values of the partial PDB are verified to be either the same of
+// the original PDB or zero for those locations whose value does not exceed the
+// threshold
+void bench_partial (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                    const vector<string>& variants, const vector<int>& thresholds) {
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+
+        // generate the PDB
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        outpdb.generate (false);
+        pdb::pdboff_t pspace = outpdb.capacity ();
+        double mbytes = 1e-6 * pdb::encoding_bytes (outpdb.best_encoding (), pspace);
+        double sum = 0.0;
+        for (pdb::pdboff_t idx = 0 ; idx < pspace ; idx++) {
+            sum += pdb::pdbval_t (outpdb[idx] - 1);
+        }
+
+        cout << " variant: " << variant << " (" << fixed << setprecision (2) << mbytes << " MB, average h: "
+             << setprecision (4) << sum / pspace << ")" << endl;
+        cout << "   threshold | entries (%) |       MB |  saved (%) | retained (%) | avg h lost | result" << endl;
+        cout << "  -----------+-------------+----------+------------+--------------+------------+--------" << endl;
+
+        for (auto threshold : thresholds) {
+            pdb::partial<pdb::node_t<npancake_t>> ppdb (outpdb, pdb::pdbval_t (threshold));
+            bool ok = true;
+            for (pdb::pdboff_t idx = 0 ; ok && idx < pspace ; idx++) {
+                pdb::pdbval_t value = pdb::pdbval_t (outpdb[idx] - 1);
+                ok = (value > threshold) ? ppdb[idx] == value : ppdb[idx] == 0;
+            }
+            double pbytes = 1e-6 * ppdb.get_nbbytes ();
+            cout << "   " << setw (9) << threshold << " | "
+                 << setprecision (2) << setw (11) << 100.0 * ppdb.get_nbentries () / pspace << " | "
+                 << setw (8) << pbytes << " | "
+                 << setw (10) << 100.0 * (1.0 - pbytes / mbytes) << " | "
+                 << setw (12) << 100.0 * ppdb.get_retained () << " | "
+                 << setprecision (4) << setw (10) << ppdb.get_loss () << " | "
+                 << (ok ? "Ok!" : "Differ!") << endl;
+        }
+        cout << endl;
+    }
+}
+
+// read the PDB with every combination of pages and placement with every
+// variant, and look up random locations with all threads. The time per lookup
+// and the pages actually used are shown, along with the speedup wrt normal
+// pages placed locally, so that the effect of TLB misses and remote accesses
+// can be measured. The sum of all values looked up is verified to be the same
+// in all cases
+void bench_lookup (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                   const vector<string>& variants, const int runs, const int nbthreads, const string& filename) {
+
+    // number of lookups performed by every thread in every run
+    const size_t nblookups = 1 << 22;
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+
+        // generate the PDB and write it, as it is read with every policy
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        outpdb.generate (false, nbthreads);
+        if (!outpdb.write (filename, pdb::pdb_format::v2, nbthreads, outpdb.best_encoding ())) {
+            cerr << " Error while writing the PDB into " << filename << endl << endl;
+            exit(EXIT_FAILURE);
+        }
+        pdb::pdboff_t pspace = outpdb.capacity ();
+
+        // every thread looks up the same random locations with every policy
+        vector<vector<pdb::pdboff_t>> locations (nbthreads, vector<pdb::pdboff_t> (nblookups));
+        mt19937_64 generator (pspace);
+        for (auto& ilocations : locations) {
+            for (auto& location : ilocations) {
+                location = generator () % pspace;
+            }
+        }
+
+        cout << " variant: " << variant << " (" << pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ppattern)
+             << " entries, " << nbthreads << " threads, " << pdb::numa_nodes () << " NUMA nodes)" << endl;
+        cout << "   pages       | placement  | pages used  |  ns/lookup |  speedup | result" << endl;
+        cout << "  -------------+------------+-------------+------------+----------+--------" << endl;
+
+        double base = 0.0;
+        unsigned long long reference = 0;
+        for (auto placement : {pdb::pdb_placement::local, pdb::pdb_placement::interleave, pdb::pdb_placement::replicate}) {
+            for (auto pages : {pdb::pdb_pages::normal, pdb::pdb_pages::transparent,
+                               pdb::pdb_pages::huge_2m, pdb::pdb_pages::huge_1g}) {
+
+                pdb::inpdb<pdb::node_t<npancake_t>> inpdb (filename);
+                inpdb.place (pages, placement);
+                if (inpdb.read (nbthreads) != pspace) {
+                    cerr << " Error while reading the PDB from " << filename << endl << endl;
+                    exit(EXIT_FAILURE);
+                }
+
+                // look up all locations with all threads and add their values
+                double elapsed = 0.0;
+                unsigned long long sum = 0;
+                for (auto run = 0 ; run < runs ; run++) {
+                    vector<unsigned long long> sums (nbthreads, 0);
+                    vector<thread> threads;
+                    auto start = chrono::high_resolution_clock::now ();
+                    for (auto id = 0 ; id < nbthreads ; id++) {
+                        threads.push_back (thread ([&inpdb, &locations, &sums, id] () {
+                            unsigned long long isum = 0;
+                            for (auto location : locations[id]) {
+                                isum += inpdb[location];
+                            }
+                            sums[id] = isum;
+                        }));
+                    }
+                    for (auto& ithread : threads) {
+                        ithread.join ();
+                    }
+                    elapsed += 1e-9*chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now () - start).count();
+                    for (auto isum : sums) {
+                        sum += isum;
+                    }
+                }
+                double nsecs = 1e9 * elapsed / (double (runs) * nbthreads * nblookups);
+                if (base == 0.0) {
+                    base = nsecs;
+                    reference = sum;
+                }
+                cout << "   " << setw (11) << left << pdb::to_string (pages) << " | "
+                     << setw (10) << pdb::to_string (placement) << " | "
+                     << setw (11) << pdb::to_string (inpdb.get_pages_used ()) << right << " | "
+                     << fixed << setprecision (2) << setw (10) << nsecs << " | "
+                     << setw (8) << base / nsecs << " | "
+                     << (sum == reference ? "Ok!" : "Differ!") << endl;
+            }
+        }
+
+        error_code ec;
+        filesystem::remove (filename, ec);
+        cout << endl;
+    }
+}
+
+// generate the PDB with every variant and evaluate all children of the nodes
+// found along a random walk, either looking up every child separately or with
+// a batched lookup which prefetches the locations of all children before
+// gathering their values. The time per child and the speedup are shown, and
+// the values of both lookups are verified to be the same. The benefit is only
+// noticeable with PDBs which do not fit in the cache
+void bench_batch (const vector<int>& goal, const string& cpattern, const string& ppattern,
+                  const vector<string>& variants, const int runs) {
+
+    // number of nodes of the random walk
+    const size_t nbnodes = 1 << 16;
+
+    for (const auto& variant : variants) {
+
+        init_variant (variant, goal, cpattern);
+
+        // generate the PDB
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+        outpdb.generate (false);
+
+        // compute the children of all nodes of a random walk starting from
+        // the goal
+        vector<vector<tuple<pdb::pdbval_t, npancake_t>>> successors (nbnodes);
+        mt19937_64 generator (nbnodes);
+        npancake_t node (goal);
+        for (auto& isuccessors : successors) {
+            node.children (isuccessors);
+            node = get<1> (isuccessors[generator () % isuccessors.size ()]);
+        }
+        const size_t nbchildren = nbnodes * (goal.size () - 1);
+
+        cout << " variant: " << variant << " (" << fixed << setprecision (2)
+             << 1e-6 * pdb::encoding_bytes (pdb::pdb_encoding::byte, outpdb.capacity ()) << " MB, "
+             << nbchildren << " children)" << endl;
+        cout << "   lookup   | ns/child |  speedup | result" << endl;
+        cout << "  ----------+----------+----------+--------" << endl;
+
+        // look up every child separately
+        vector<pdb::pdbval_t> reference;
+        double base = 0.0;
+        for (auto run = 0 ; run < runs ; run++) {
+            reference.clear ();
+            auto start = chrono::high_resolution_clock::now ();
+            for (const auto& isuccessors : successors) {
+                for (const auto& [cost, child] : isuccessors) {
+                    reference.push_back (outpdb[child.get_perm ()]);
+                }
+            }
+            base += 1e-9*chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now () - start).count();
+        }
+        base = 1e9 * base / (double (runs) * nbchildren);
+
+        // and with batched lookups
+        vector<pdb::pdbval_t> contents;
+        vector<pdb::pdboff_t> indices;
+        vector<pdb::pdbval_t> values;
+        double elapsed = 0.0;
+        for (auto run = 0 ; run < runs ; run++) {
+            contents.clear ();
+            auto start = chrono::high_resolution_clock::now ();
+            for (const auto& isuccessors : successors) {
+                outpdb.lookup (isuccessors, indices, values);
+                contents.insert (contents.end (), values.begin (), values.end ());
+            }
+            elapsed += 1e-9*chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now () - start).count();
+        }
+        elapsed = 1e9 * elapsed / (double (runs) * nbchildren);
+
+        cout << "   serial   | " << setprecision (2) << setw (8) << base << " | "
+             << setw (8) << 1.0 << " | Ok!" << endl;
+        cout << "   batched  | " << setw (8) << elapsed << " | "
+             << setw (8) << base / elapsed << " | "
+             << (contents == reference ? "Ok!" : "Differ!") << endl;
+        cout << endl;
+    }
+}
+
+// Set all the option flags according to the switches specified. Return the
+// index of the first non-option argument
+static int
+decode_switches (int argc, char **argv,
+                 string& benchmark, string& goal, string& ppattern, string& cpattern,
+                 string& variants, int& runs, int& nbthreads, string& filename,
+                 string& factors, string& thresholds, bool& want_verbose) {
+
+    int c;
+
+    // Default values
+    benchmark = "";
+    goal = "";
+    ppattern = "";
+    cpattern = "";
+    variants = "unit heavy-cost";
+    runs = 1;
+    nbthreads = 1;
+    filename = "";
+    factors = "1 2 4 8 16 32 64";
+    thresholds = "0 1 2 4 8 16 32";
+    want_verbose = false;
+
+    while ((c = getopt_long (argc, argv,
+                             "b:" /* benchmark */
+                             "g:" /* goal */
+                             "p:" /* ppattern */
+                             "c:" /* cpattern */
+                             "r:" /* variant */
+                             "n:" /* runs */
+                             "t:" /* threads */
+                             "f:" /* file */
+                             "k:" /* factors */
+                             "T:" /* thresholds */
+                             "v"  /* verbose */
+                             "h"  /* help */
+                             "V", /* version */
+                             long_options, (int *) 0)) != EOF) {
+        switch (c) {
+        case 'b':  /* --benchmark */
+            benchmark = optarg;
+            break;
+        case 'g':  /* --goal */
+            goal = optarg;
+            break;
+        case 'p':  /* --ppattern */
+            ppattern = optarg;
+            break;
+        case 'c':  /* --cpattern */
+            cpattern = optarg;
+            break;
+        case 'r': /* --variant */
+            variants = optarg;
+            break;
+        case 'n': /* --runs */
+            runs = atoi (optarg);
+            break;
+        case 't': /* --threads */
+            nbthreads = atoi (optarg);
+            break;
+        case 'f': /* --file */
+            filename = optarg;
+            break;
+        case 'k': /* --factors */
+            factors = optarg;
+            break;
+        case 'T': /* --thresholds */
+            thresholds = optarg;
+            break;
+        case 'v':  /* --verbose */
+            want_verbose = true;
+            break;
+        case 'V':
+            cout << " pdb (n-pancake bench) " << PDB_VERSION << endl;
+            cout << " " << CMAKE_BUILD_TYPE << " Build Type" << endl << endl;
+            exit (EXIT_SUCCESS);
+        case 'h':
+            usage (EXIT_SUCCESS);
+        default:
+            cout << endl << " Unknown argument!" << endl;
+            usage (EXIT_FAILURE);
+        }
+    }
+    return optind;
+}
+
+
+static void
+usage (int status)
+{
+    cout << endl << " " << program_name << " tool used to benchmark the services of libpdb with the N-Pancake puzzle" << endl << endl;
+    cout << " Usage: " << program_name << " [OPTIONS]" << endl << endl;
+    cout << "\
+ Mandatory arguments:\n\
+      -b, --benchmark [STRING]   benchmark to perform. Choices are:\n\
+                                    open: generation of PDBs with different open lists (open_t, ring_t and radix_t)\n\
+                                    large: generation, validation, write, read and verification of a large PDB,\n\
+                                           e.g., with billions of entries\n\
+                                    fold: memory saved and average h lost when folding a PDB with different\n\
+                                          factors and groupings\n\
+                                    partial: memory taken and information retained by partial PDBs storing only\n\
+                                             the values above different thresholds\n\
+                                    lookup: time of random lookups with all threads with every combination of\n\
+                                            pages and NUMA placement\n\
+                                    batch: time of looking up all children of random nodes, either separately or with\n\
+                                           batched lookups which prefetch them first. Use PDBs larger than the cache\n\
+      -g, --goal     [STRING]    explicit representation of the goal state with a blank separated list of digits\n\
+                                 in the range [1, N].\n\
+      -p, --ppattern [STRING]    specify the pattern mask to use to generate the PDB. The pattern consist only of characters\n\
+                                 '*' and '-', where the former indicates that the i-th symbol in the goal is abstracted, \n\
+                                 whereas the latter indicates that the i-th symbol is preserved\n\
+\n\
+ Optional arguments:\n\
+      -c, --cpattern [STRING]    specify the pattern mask to use to traverse the abstract space. It is defined like --ppattern\n\
+                                 and must be either a superset or equal to the ppattern. It equals, by default, the ppattern\n\
+      -r, --variant  [STRING]    blank separated list of variants of the n-Pancake to consider. Choices are {unit, heavy-cost}.\n\
+                                 By default, both are used\n\
+      -n, --runs     [INT]       number of times each experiment is repeated. Times are averaged. By default, 1\n\
+      -t, --threads  [INT]       number of threads used by the large and lookup benchmarks. By default, 1\n\
+      -f, --file     [STRING]    file used by the large, fold and lookup benchmarks to store the PDB. By default, bench.pdb\n\
+                                 in the temporary directory. It is removed at the end\n\
+      -k, --factors  [STRING]    blank separated list of factors used by the fold benchmark. By default, 1 2 4 8 16 32 64\n\
+      -T, --thresholds [STRING]  blank separated list of thresholds used by the partial benchmark. By default,\n\
+                                 0 1 2 4 8 16 32\n\
+ Misc arguments:\n\
+      --verbose                  print more information\n\
+      -h, --help                 display this help and exit\n\
+      -V, --version              output version information and exit\n\
+\n";
+    exit (status);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
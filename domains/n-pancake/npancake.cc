@@ -44,6 +44,15 @@ static struct option const long_options[] =
     {"ppattern", required_argument, 0, 'p'},
     {"cpattern", required_argument, 0, 'c'},
     {"variant", required_argument, 0, 'r'},
+    {"mode", required_argument, 0, 'M'},
+    {"read-graph", required_argument, 0, 'G'},
+    {"write-graph", required_argument, 0, 'w'},
+    {"threads", required_argument, 0, 't'},
+    {"workers", required_argument, 0, 'k'},
+    {"mmap", no_argument, 0, 'm'},
+    {"shard-size", required_argument, 0, 's'},
+    {"encoding", required_argument, 0, 'e'},
+    {"compression", required_argument, 0, 'z'},
     {"no-doctor", no_argument, 0, 'D'},
     {"verbose", no_argument, 0, 'v'},
     {"help", no_argument, 0, 'h'},
@@ -51,10 +60,11 @@ static struct option const long_options[] =
     {NULL, 0, NULL, 0}
 };
 
-pdb::pdbval_t default_cost (const vector<int>& goal, const string pattern);
+void set_cost_model (pdb::graph_t& graph, const string& variant, const pdb::pdbval_t cost);
 static int decode_switches (int argc, char **argv,
                             string& filename, string& goal, string& ppattern, string& cpattern, string& variant,
-                            bool& no_doctor, bool& want_verbose);
+                            string& mode, string& rgraph, string& wgraph, int& nbthreads, int& nbworkers, bool& use_mmap,
+                            long long& shard_size, string& encoding, string& compression, bool& no_doctor, bool& want_verbose);
 static void usage (int status);
 
 // main entry point
@@ -65,6 +75,15 @@ int main (int argc, char** argv) {
     string ppattern;                  // pattern used to mask values in the PDB
     string cpattern;       // pattern used to traverse the abstract state space
     string variant;                                    // variant of the domain
+    string mode;                          // mode of the PDB, either max or add
+    string rgraph;                // file with the abstract graph to read from
+    string wgraph;                 // file with the abstract graph to write to
+    int nbthreads;                       // number of threads used to generate
+    int nbworkers;                     // number of processes used to generate
+    bool use_mmap;           // whether the PDB is generated in the file or not
+    long long shard_size;      // number of locations per shard, if sharded
+    string encoding;                  // encoding of the values in the file
+    string compression;            // compression of the values in the file
     bool no_doctor;                    // whether the doctor is disabled or not
     bool want_verbose;                  // whether verbose output was requested
     chrono::time_point<chrono::system_clock> tstart, tend;          // CPU time
@@ -72,9 +91,12 @@ int main (int argc, char** argv) {
     // variables
     program_name = argv[0];
     vector<string> variant_choices = {"unit", "heavy-cost"};
+    vector<string> mode_choices = {"max", "add"};
+    vector<string> encoding_choices = {"auto", "byte", "nibble", "mod3", "tribble", "word"};
+    vector<string> compression_choices = {"none", "rle"};
 
     // arg parse ---and trim strings
-    decode_switches (argc, argv, filename, sgoal, ppattern, cpattern, variant, no_doctor, want_verbose);
+    decode_switches (argc, argv, filename, sgoal, ppattern, cpattern, variant, mode, rgraph, wgraph, nbthreads, nbworkers, use_mmap, shard_size, encoding, compression, no_doctor, want_verbose);
     sgoal = trim (sgoal);
     ppattern = trim (ppattern);
     cpattern = trim (cpattern);
@@ -165,6 +187,85 @@ int main (int argc, char** argv) {
         exit(EXIT_FAILURE);
     }
 
+    // --mode
+    if (!get_choice (mode, mode_choices)) {
+        cerr << "\n Please, provide a correct name for the mode with --mode" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    pdb::pdb_mode pdb_mode = (mode == "add") ? pdb::pdb_mode::add : pdb::pdb_mode::max;
+
+    // --threads
+    if (nbthreads < 1) {
+        cerr << "\n The number of threads must be strictly positive" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --workers
+    if (nbworkers < 1) {
+        cerr << "\n The number of workers must be strictly positive" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (nbworkers > 1 && nbthreads > 1) {
+        cerr << "\n The PDB can be generated either with several threads or several workers, but not both" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (nbworkers > 1 && rgraph != "") {
+        cerr << "\n PDBs generated from an abstract graph can not use several workers" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --shard-size
+    if (shard_size < 0) {
+        cerr << "\n The number of locations per shard must be strictly positive" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (shard_size > 0 && use_mmap) {
+        cerr << "\n PDBs generated with --mmap can not be written in shards" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --encoding
+    if (!get_choice (encoding, encoding_choices)) {
+        cerr << "\n Please, provide a correct name for the encoding with --encoding" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    pdb::pdb_encoding pdb_encoding = (encoding == "mod3") ? pdb::pdb_encoding::mod3 :
+        (encoding == "nibble") ? pdb::pdb_encoding::nibble :
+        (encoding == "tribble") ? pdb::pdb_encoding::tribble :
+        (encoding == "word") ? pdb::pdb_encoding::word : pdb::pdb_encoding::byte;
+    if (encoding != "auto" && pdb_encoding != pdb::pdb_encoding::byte && (use_mmap || shard_size > 0)) {
+        cerr << "\n PDBs generated with --mmap or written in shards can only be encoded in bytes" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (pdb_encoding == pdb::pdb_encoding::mod3 && pdb_mode == pdb::pdb_mode::add) {
+        cerr << "\n Additive PDBs can not be encoded modulo 3" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // --compression
+    if (!get_choice (compression, compression_choices)) {
+        cerr << "\n Please, provide a correct name for the compression with --compression" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+    pdb::pdb_compression pdb_compression = (compression == "rle") ? pdb::pdb_compression::rle :
+        pdb::pdb_compression::none;
+    if (pdb_compression != pdb::pdb_compression::none && (use_mmap || shard_size > 0)) {
+        cerr << "\n PDBs generated with --mmap or written in shards can not be compressed" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
     /* do the work */
 
     /* !------------------------- INITIALIZATION --------------------------! */
@@ -172,14 +273,33 @@ int main (int argc, char** argv) {
     cout << endl;
     vector<int> goal = string_to_int (sgoal);
     cout << " file     : " << filename << endl;
-    cout << " PDB mode : " << "MAX" << endl;
+    cout << " PDB mode : " << ((pdb_mode == pdb::pdb_mode::add) ? "ADD" : "MAX") << endl;
     cout << " goal     : "; print (goal); cout << endl;
     cout << " p-pattern: " << ppattern << endl;
     cout << " c-pattern: " << cpattern << endl;
+    if (rgraph != "") {
+        cout << " graph    : " << rgraph << endl;
+    }
+    if (nbthreads > 1) {
+        cout << " threads  : " << nbthreads << endl;
+    }
+    if (nbworkers > 1) {
+        cout << " workers  : " << nbworkers << endl;
+    }
+    if (shard_size > 0) {
+        cout << " shards   : " << shard_size << " locations each" << endl;
+    }
+    if (encoding != "auto") {
+        cout << " encoding : " << encoding << endl;
+    }
+    if (pdb_compression != pdb::pdb_compression::none) {
+        cout << " compress : " << compression << endl;
+    }
     cout << " variant  : " << variant;
 
     // set the variant and default cost that corresponds to it and the selected
     // pattern, which should be the c-pattern, the one used during the search
+    pdb::pdbval_t cost = 1;
     if (variant == "unit") {
         npancake_t::init (npancake_variant::unit, 1);
     } else {
@@ -187,7 +307,7 @@ int main (int argc, char** argv) {
         // in case the selected variant is the heavy-cost then the default cost
         // has to be computed. This is done wrt the c-pattern because that is
         // the one used when searching in the abstract state space
-        pdb::pdbval_t cost = default_cost (goal, cpattern);
+        cost = npancake_t::compute_default_cost (goal, cpattern);
         npancake_t::init (npancake_variant::heavy_cost, cost);
 
         // and show this information on the console
@@ -200,8 +320,26 @@ int main (int argc, char** argv) {
 
     // create an output PDB and generate it showing a progress bar
     tstart = chrono::system_clock::now ();
-    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
-    outpdb.generate (false);
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb_mode, goal, cpattern, ppattern);
+    if (use_mmap) {
+        outpdb.map (filename);
+    }
+    if (rgraph != "") {
+
+        // in case a graph has been given, the PDB is generated traversing it
+        // with the cost model of the selected variant
+        pdb::graph_t graph;
+        if (!graph.read (rgraph)) {
+            cerr << " Fatal Error: it was not possible to read the graph from the given filename" << endl;
+            return (EXIT_FAILURE);
+        }
+        set_cost_model (graph, variant, cost);
+        outpdb.generate (graph, false);
+    } else if (nbworkers > 1) {
+        outpdb.generate_workers (nbworkers, false);
+    } else {
+        outpdb.generate (false, nbthreads);
+    }
     cout << endl << endl;;
 
     // check whether the PDB has been correctly generated
@@ -217,11 +355,45 @@ int main (int argc, char** argv) {
     }
     tend = chrono::system_clock::now ();
 
-    // If so, write it to the file
-    if (!outpdb.write (filename)) {
+    // in case no encoding was given, use the narrowest one for the values of
+    // the PDB, unless it was generated in the file, which is then finished
+    // with the encoding used to generate it
+    if (encoding == "auto") {
+        pdb_encoding = use_mmap ? outpdb.get_encoding () : outpdb.best_encoding ();
+    }
+
+    // If so, write it to the file, or split it into shards if requested
+    if (shard_size > 0 && !outpdb.fits (pdb::pdb_encoding::byte)) {
+        cerr << " Fatal Error: the values of the PDB can not be written in shards, which store them in bytes" << endl;
+        return (EXIT_FAILURE);
+    } else if (shard_size > 0) {
+        if (!outpdb.write_shards (filename, pdb::pdboff_t (shard_size), nbthreads)) {
+            cerr << " Fatal Error: it was not possible to write the shards of the PDB next to the given filename" << endl;
+        }
+    } else if (use_mmap && pdb_encoding != outpdb.get_encoding ()) {
+        cerr << " Fatal Error: the PDB was generated with " << pdb::to_string (outpdb.get_encoding ())
+             << " encoding and it can not be written with the given encoding" << endl;
+        return (EXIT_FAILURE);
+    } else if (!use_mmap && !outpdb.fits (pdb_encoding)) {
+        cerr << " Fatal Error: the values of the PDB can not be written with the given encoding" << endl;
+        return (EXIT_FAILURE);
+    } else if (!outpdb.write (filename, pdb::pdb_format::v2, nbthreads, pdb_encoding, pdb_compression)) {
         cerr << " Fatal Error: it was not possible to write the PDB to the given filename" << endl;
     }
 
+    // in case it was requested, write also the abstract graph. It is generated
+    // with the heavy-cost variant and a default cost equal to zero so that
+    // cost classes are the discs below the spatula, or zero if they have been
+    // abstracted away. Any variant can be then regenerated from it
+    if (wgraph != "") {
+        pdb::graph_t graph;
+        npancake_t::init (npancake_variant::heavy_cost, 0);
+        outpdb.generate_graph (graph, false);
+        if (!graph.write (wgraph)) {
+            cerr << " Fatal Error: it was not possible to write the graph to the given filename" << endl;
+        }
+    }
+
     // show a summary of information
     cout << " Doctor       : ";
     if (!no_doctor) {
@@ -232,6 +404,9 @@ int main (int argc, char** argv) {
     cout << endl;
     cout << " Length       : " << length << endl;
     cout << " Address space: " << pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ppattern) << endl;
+    if (shard_size <= 0) {
+        cout << " Encoding     : " << pdb::to_string (pdb_encoding) << endl;
+    }
     cout << " 🕒 CPU time  : " << endl;
     cout << "    💻 Generation: " << 1e-9*chrono::duration_cast<chrono::nanoseconds>(outpdb.get_elapsed_time ()).count() << " seconds" << endl;
     cout << "       Total     : " << 1e-9*chrono::duration_cast<chrono::nanoseconds>(tend - tstart).count() << " seconds" << endl;
@@ -243,23 +418,23 @@ int main (int argc, char** argv) {
     return (EXIT_SUCCESS);
 }
 
-// given a pattern defined with respect to a goal, get the default cost defined
-// as the minimum value among the symbols being abstracted. Obviously, if all
-// symbols are abstracted, then the minimum integer defined in the goal is
-// returned as the default cost
-pdb::pdbval_t default_cost (const vector<int>& goal, const string pattern) {
-
-    // the default cost is defined as the cost of the minimum symbol among those
-    // abstracted
-    pdb::pdbval_t cost = std::numeric_limits<pdb::pdbval_t>::max();
-    for (auto i = 0 ; i < int (goal.size ()) ; i++) {
+// set the cost model of a graph generated with the heavy-cost variant and a
+// default cost equal to zero (i.e., where classes are the discs below the
+// spatula or zero if they are abstracted away) according to the given variant
+// and default cost
+void set_cost_model (pdb::graph_t& graph, const string& variant, const pdb::pdbval_t cost) {
 
-        // Update the default cost if this symbol is abstracted and its value is
-        // less than the incumbent value
-        cost = (pattern[i] == '*' && goal[i] < cost) ? goal[i] : cost;
+    // in the unit variant all operators cost the same
+    if (variant == "unit") {
+        for (auto i = 0 ; i <= std::numeric_limits<pdb::pdbval_t>::max () ; i++) {
+            graph.set_cost (pdb::pdbval_t (i), 1);
+        }
+        return;
     }
 
-    return cost;
+    // in the heavy-cost variant, the cost of every operator is the disc below
+    // the spatula, and the default cost otherwise
+    graph.set_cost (0, cost);
 }
 
 
@@ -268,7 +443,8 @@ pdb::pdbval_t default_cost (const vector<int>& goal, const string pattern) {
 static int
 decode_switches (int argc, char **argv,
                  string& filename, string& goal, string& ppattern, string& cpattern, string& variant,
-                 bool& no_doctor, bool& want_verbose) {
+                 string& mode, string& rgraph, string& wgraph, int& nbthreads, int& nbworkers, bool& use_mmap,
+                 long long& shard_size, string& encoding, string& compression, bool& no_doctor, bool& want_verbose) {
 
     int c;
 
@@ -278,15 +454,33 @@ decode_switches (int argc, char **argv,
     ppattern = "";
     cpattern = "";
     variant = "unit";
+    mode = "max";
+    rgraph = "";
+    wgraph = "";
+    nbthreads = 1;
+    nbworkers = 1;
+    use_mmap = false;
+    shard_size = 0;
+    encoding = "auto";
+    compression = "none";
     no_doctor = false;
     want_verbose = false;
 
     while ((c = getopt_long (argc, argv,
-                             "f"  /* file */
-                             "g"  /* goal */
-                             "p"  /* ppattern */
-                             "c"  /* cpattern */
-                             "r"  /* variant */
+                             "f:" /* file */
+                             "g:" /* goal */
+                             "p:" /* ppattern */
+                             "c:" /* cpattern */
+                             "r:" /* variant */
+                             "M:" /* mode */
+                             "G:" /* read-graph */
+                             "w:" /* write-graph */
+                             "t:" /* threads */
+                             "k:" /* workers */
+                             "m"  /* mmap */
+                             "s:" /* shard-size */
+                             "e:" /* encoding */
+                             "z:" /* compression */
                              "D"  /* no-doctor */
                              "v"  /* verbose */
                              "h"  /* help */
@@ -308,6 +502,33 @@ decode_switches (int argc, char **argv,
         case 'r': /* --variant */
             variant = optarg;
             break;
+        case 'M': /* --mode */
+            mode = optarg;
+            break;
+        case 'G': /* --read-graph */
+            rgraph = optarg;
+            break;
+        case 'w': /* --write-graph */
+            wgraph = optarg;
+            break;
+        case 't': /* --threads */
+            nbthreads = atoi (optarg);
+            break;
+        case 'k': /* --workers */
+            nbworkers = atoi (optarg);
+            break;
+        case 'm':  /* --mmap */
+            use_mmap = true;
+            break;
+        case 's':  /* --shard-size */
+            shard_size = atoll (optarg);
+            break;
+        case 'e':  /* --encoding */
+            encoding = optarg;
+            break;
+        case 'z':  /* --compression */
+            compression = optarg;
+            break;
         case 'D':  /* --no-doctor */
             no_doctor = true;
             break;
@@ -347,6 +568,33 @@ usage (int status)
  Optional arguments:\n\
       -c, --cpattern [STRING]    specify the pattern mask to use to traverse the abstract space. It is defined like --ppattern\n\
                                  and must be either a superset or equal to the ppattern. It equals, by default, the ppattern\n\
+      -M, --mode     [STRING]    mode of the PDB. Choices are {max, add}. Additive PDBs charge only the reversals whose\n\
+                                 disc right below the spatula is preserved by the ppattern, so that PDBs with disjoint\n\
+                                 ppatterns can be added. By default, max\n\
+      -G, --read-graph [STRING]  if given, the PDB is generated traversing the abstract graph stored in this file with the\n\
+                                 cost model of the selected variant, instead of searching the abstract state space\n\
+      -w, --write-graph [STRING] if given, the abstract graph is written to this file after generating the PDB. It can be\n\
+                                 used later with --read-graph to regenerate the PDB with any variant\n\
+      -t, --threads  [INT]       number of threads used to generate the PDB. All nodes with the same g-value are expanded\n\
+                                 in parallel. By default, 1\n\
+      -k, --workers  [INT]       number of processes used to generate the PDB. Every one owns a slice of the abstract\n\
+                                 state space and they exchange their frontiers through temporary files. It can not be\n\
+                                 used along with --threads or --read-graph. By default, 1\n\
+      -m, --mmap                 if given, the PDB is generated directly in a shared mapping of the output file, so that\n\
+                                 writing it requires no copy\n\
+      -s, --shard-size [INT]     if given, the PDB is split into shards with this number of locations each. The index is\n\
+                                 written to --file, and every shard is written next to it with the suffix .k, where k\n\
+                                 is the number of the shard. Shards are written by as many threads as given in --threads\n\
+      -e, --encoding [STRING]    encoding of the values in the file. Choices are {auto, byte, nibble, mod3, tribble, word}.\n\
+                                 Nibbles take half the space but they can only store values up to 15. mod3 takes a\n\
+                                 quarter of the space but it can only be used if the values of adjacent states differ at\n\
+                                 most in one, e.g., with the unit variant, and never with --mode add. tribble takes 12\n\
+                                 bits per value and word two bytes, so that they store values up to 4095 and 65535\n\
+                                 respectively. Only auto and byte can be used with --mmap or --shard-size. By default,\n\
+                                 auto is used, i.e., the narrowest among byte, tribble and word that can store all values\n\
+      -z, --compression [STRING] compression of the values in the file. Choices are {none, rle}. With rle, the file is\n\
+                                 split into blocks compressed independently, which can be read all at once or decoded\n\
+                                 on demand. It can not be used with --mmap or --shard-size. By default, none is used\n\
       -D, --no-doctor            If given, the automated error checking is disabled. Otherwise, the PDB is verified for\n\
                                  correctness\n\
  Misc arguments:\n\
@@ -16,7 +16,9 @@
 #include<algorithm>
 #include<iostream>
 #include<iterator>
+#include<limits>
 #include<string>
+#include<tuple>
 #include<vector>
 
 #include "../../src/PDBdefs.h"
@@ -40,6 +42,15 @@ private:
     static int _n;                                 // length of the permutation
     std::vector<int> _perm;                                      // permutation
 
+    // every reversal is charged in additive PDBs to the disc immediately below
+    // the spatula, i.e., the same one used to compute its cost in the
+    // heavy-cost variant, so that every reversal is charged to one pattern
+    // only. Reversals of the whole stack are charged to the table, which is
+    // never preserved. Children record the owner of the reversal that
+    // generated them, which is pdb::NONPAT if it is the table or it has been
+    // abstracted away
+    int _owner;
+
     // this implementation acknowledges different variants:
     //
     //    + unit: the cost of every operator is the same and equal to one
@@ -69,6 +80,15 @@ private:
 
     // methods
 
+    // set the length of the permutations. It is written only if it changes so
+    // that states can be created concurrently by different threads once the
+    // length has been set
+    static void _set_n (int n) {
+        if (_n != n) {
+            _n = n;
+        }
+    }
+
     // flip the first k positions of this permutation
     std::vector<int> _flip (int k) {
 
@@ -88,17 +108,19 @@ public:
     // constructor assumes that all integers are distinct and belong to the
     // range [1, n] and a number of abstracted symbols represented with
     // pdb::NONPAT
-    npancake_t (const std::vector<int>& perm) :
-        _perm { perm }
+    npancake_t (const std::vector<int>& perm, const int owner = pdb::NONPAT) :
+        _perm  {  perm },
+        _owner { owner }
         {
-            _n = perm.size ();
+            _set_n (perm.size ());
         }
 
     // And also with an initializer list
     npancake_t (std::initializer_list<int> perm) :
-        _perm { perm }
+        _perm  {          perm },
+        _owner { pdb::NONPAT }
         {
-            _n = perm.size ();
+            _set_n (perm.size ());
         }
 
     // getters
@@ -111,6 +133,9 @@ public:
     const std::vector<int>& get_perm () const {
         return _perm;
     }
+    int get_owner () const {
+        return _owner;
+    }
     static npancake_variant get_variant () {
         return _variant;
     }
@@ -166,6 +191,56 @@ public:
         _default_cost = default_cost;
     }
 
+    // given a pattern defined with respect to a goal, return the default cost
+    // defined as the minimum value among the symbols being abstracted.
+    // Obviously, if all symbols are abstracted, then the minimum integer
+    // defined in the goal is returned as the default cost. If no symbol is
+    // abstracted, the default cost is never used, and the minimum integer
+    // defined in the goal is returned as well
+    static pdb::pdbval_t compute_default_cost (const std::vector<int>& goal, const std::string& pattern) {
+
+        pdb::pdbval_t cost = std::numeric_limits<pdb::pdbval_t>::max();
+        for (auto i = 0 ; i < int (goal.size ()) ; i++) {
+
+            // Update the default cost if this symbol is abstracted and its
+            // value is less than the incumbent value
+            cost = (pattern[i] == '*' && goal[i] < cost) ? goal[i] : cost;
+        }
+        if (cost == std::numeric_limits<pdb::pdbval_t>::max()) {
+            cost = pdb::pdbval_t (*std::min_element (goal.begin (), goal.end ()));
+        }
+        return cost;
+    }
+
+    // return an upper bound of the cost of the optimal path from any state to
+    // the given goal, either abstract or not. Any permutation of length n > 1
+    // can be sorted with at most 2n-3 reversals, bringing every disc to the
+    // top and then down to its location, and thus the bound is 2n-3 times
+    // the largest cost of any operator: one in the unit variant, and the
+    // largest among the table, any disc and the default cost in the
+    // heavy-cost variant
+    static pdb::pdboff_t cost_bound (const std::vector<int>& goal) {
+
+        const pdb::pdboff_t n = goal.size ();
+        if (n < 2) {
+            return 0;
+        }
+        pdb::pdboff_t cost = 1;
+        if (_variant == npancake_variant::heavy_cost) {
+            cost = std::max ({pdb::pdboff_t (1 + n),
+                              pdb::pdboff_t (*std::max_element (goal.begin (), goal.end ())),
+                              pdb::pdboff_t (_default_cost)});
+        }
+        return (2*n - 3) * cost;
+    }
+
+    // the values of dual states are admissible only in the unit variant, as
+    // the cost of every reversal in the heavy-cost variant depends on the
+    // disc right below the spatula
+    static bool dual_admissible () {
+        return _variant == npancake_variant::unit;
+    }
+
     // return the children of this state as a vector of tuples with two
     // elements: first, the g-value of each node, and then the node itself.
     // Because this implementation honors both real and abstract states, the
@@ -206,10 +281,10 @@ public:
             }
 
             // Add this successor to the vector of successors along with its
-            // cost
+            // cost, and the disc the reversal is charged to
             successors.push_back (std::tuple<pdb::pdbval_t, npancake_t>{
                     g,
-                    npancake_t (_flip (i))});
+                    npancake_t (_flip (i), (i == _n-1) ? int (pdb::NONPAT) : _perm[1+i])});
         }
     }
 
@@ -29,6 +29,8 @@ static struct option const long_options[] =
 {
     {"file", required_argument, 0, 'f'},
     {"perm", required_argument, 0, 'p'},
+    {"mmap", no_argument, 0, 'm'},
+    {"threads", required_argument, 0, 't'},
     {"verbose", no_argument, 0, 'v'},
     {"help", no_argument, 0, 'h'},
     {"version", no_argument, 0, 'V'},
@@ -37,7 +39,7 @@ static struct option const long_options[] =
 
 static int decode_switches (int argc, char **argv,
                             string& filename, string& perm,
-                            bool& want_verbose);
+                            bool& use_mmap, int& nbthreads, bool& want_verbose);
 static void usage (int status);
 
 // main entry point
@@ -45,6 +47,8 @@ int main (int argc, char** argv) {
 
     string filename;                            // file with all cases to solve
     string perm;                       // permutation to query, if any is given
+    bool use_mmap;            // whether PDBs are mapped in memory or not
+    int nbthreads;                  // number of threads used to load the PDBs
     bool want_verbose;                  // whether verbose output was requested
     chrono::time_point<chrono::system_clock> tstart, tend;          // CPU time
 
@@ -52,7 +56,7 @@ int main (int argc, char** argv) {
     program_name = argv[0];
 
     // arg parse ---and trim strings
-    decode_switches (argc, argv, filename, perm, want_verbose);
+    decode_switches (argc, argv, filename, perm, use_mmap, nbthreads, want_verbose);
     filename = trim (filename);
     perm = trim (perm);
 
@@ -68,6 +72,13 @@ int main (int argc, char** argv) {
     // get all the different pattern databases given in a vector
     vector<string> filenames = string_to_string (filename);
 
+    // --threads
+    if (nbthreads < 0) {
+        cerr << "\n The number of threads can not be negative" << endl;
+        cerr << " See " << program_name << " --help for more details" << endl << endl;
+        exit(EXIT_FAILURE);
+    }
+
     // --perm
     //
     // it is not mandatory to provide a permutation. In case it is given, verify
@@ -123,82 +134,167 @@ int main (int argc, char** argv) {
     int idx = 0;
     pdb::pdb_mode mode;
     vector<int> pdb_goal;
-    vector<int> vals;
-    for (const auto ifile: filenames) {
+    vector<pdb::pdbval_t> vals;
+    // summarize the information of a PDB, either stored in a single file or
+    // in shards, and query it if a permutation was given. It returns false if
+    // the PDB is not compatible with the previous ones
+    auto report = [&] (auto& ipdb) {
+
+        // and provide a summary of information
+        vector<int> ipdb_goal = ipdb.get_goal ();
+        cout << " \t‣ Goal         : "; print<int> (ipdb_goal); cout << endl;
+
+        // In case this goal is different than the goal used in other
+        // previous PDBs issue an error
+        if (pdb_goal.size () > 0 && pdb_goal.size () != ipdb_goal.size ()) {
+            cout << endl << " \t\tError: non-compatible PDBs (goals of different size)" << endl << endl;
+            return false;
+        }
 
-        cout << " • " << ifile << ": " << endl;
+        if (pdb_goal.size () > 0 && pdb_goal != ipdb_goal) {
+            cout << endl << " \t\tError: non-compatible PDBs (different goals)" << endl << endl;
+            return false;
+        }
 
-        // open this PDB
-        pdb::inpdb<pdb::node_t<npancake_t>> ipdb (ifile);
+        // if this is the first PDB, copy its goal
+        if (idx == 0) {
+            pdb_goal = ipdb_goal;
+        }
 
-        // access this PDB and provide a summary of information
-        if (!ipdb.read ()) {
-            cerr << " \tError: " << ipdb.get_in_error_message () << endl << endl;
-            return (EXIT_FAILURE);
+        cout << " \t‣ PDB mode     : ";
+        if (ipdb.get_pdb_mode () == pdb::pdb_mode::max) {
+            cout << "MAX" << endl;
+        } else if (ipdb.get_pdb_mode () == pdb::pdb_mode::add) {
+            cout << "ADD" << endl;
         } else {
+            cerr << "\tError: Unknown type" << endl << endl;
+            return false;
+        }
 
-            // and provide a summary of information
-            vector<int> ipdb_goal = ipdb.get_goal ();
-            cout << " \t‣ Goal         : "; print<int> (ipdb_goal); cout << endl;
+        // In case this PDB has a mode different than the previous ones
+        // issue an error
+        if (idx > 0 && mode != ipdb.get_pdb_mode ()) {
+            cout << endl << " \t\tError: non-compatible PDBs (different mode)" << endl << endl;
+            return false;
+        }
 
-            // In case this goal is different than the goal used in other
-            // previous PDBs issue an error
-            if (pdb_goal.size () > 0 && pdb_goal.size () != ipdb_goal.size ()) {
-                cout << endl << " \t\tError: non-compatible PDBs (goals of different size)" << endl << endl;
-                return (EXIT_FAILURE);
-            }
+        // If this is the first PDB, copy its mode
+        if (idx == 0) {
+            mode = ipdb.get_pdb_mode ();
+        }
 
-            if (pdb_goal.size () > 0 && pdb_goal != ipdb_goal) {
-                cout << endl << " \t\tError: non-compatible PDBs (different goals)" << endl << endl;
-                return (EXIT_FAILURE);
-            }
+        // show the patterns and also the size of the abstract state
+        cout << " \t‣ p-pattern    : " << ipdb.get_ppattern () << endl;
+        cout << " \t‣ c-pattern    : " << ipdb.get_cpattern () << endl;
+        cout << " \t‣ address space: " << ipdb.get_address_space () << endl;
+        cout << " \t‣ format       : " << ((ipdb.get_format () == pdb::pdb_format::v1) ? "v1" : "v2") << endl;
+        cout << " \t‣ compression  : " << pdb::to_string (ipdb.get_compression ()) << endl;
+        cout << " \t‣ encoding     : " << pdb::to_string (ipdb.get_encoding ()) << endl;
+
+        // in case a permutation has been given
+        if (perm.size () > 0) {
+
+            // before querying the PDB, ensure that this permutation is
+            // compatible with it
+            cout << " \t‣ value        : ";
+            if (ipdb_goal.size () != vperm.size ()) {
+                cout << endl << " \t\tError: non-compatible permutations (different size)" << endl << endl;
+                return false;
+            } else {
 
-            // if this is the first PDB, copy its goal
-            if (idx == 0) {
-                pdb_goal = ipdb_goal;
+                // Otherwise, show the value. Values encoded modulo 3 are
+                // recovered from the abstract goal, which might fail if the
+                // file is not consistent
+                try {
+                    vals.push_back (ipdb.value (vperm));
+                } catch (const exception& e) {
+                    cout << endl << " \t\tError:" << e.what () << endl << endl;
+                    return false;
+                }
+                cout << vals[vals.size ()-1] << endl;
+            }
+        }
+        return true;
+    };
+
+    // all PDBs stored in a single file are loaded simultaneously before
+    // reporting them. Those read are also verified, while mapped PDBs are
+    // not, so that their pages are still loaded on demand. PDBs stored in
+    // shards are opened on demand instead, so that only the shard storing
+    // the permutation, if any, is loaded
+    vector<bool> sharded;
+    vector<filesystem::path> paths;
+    for (const auto& ifile: filenames) {
+        sharded.push_back (pdb::index_t::probe (ifile));
+        if (!sharded.back ()) {
+            paths.push_back (ifile);
+        }
+    }
+    // if any of them could not be loaded or they are not compatible, e.g.,
+    // additive PDBs with overlapping patterns, their values are not reported
+    pdb::heuristic_set<pdb::node_t<npancake_t>> ipdbs (paths);
+    const bool loaded = use_mmap ? ipdbs.map (nbthreads, false) : ipdbs.read (nbthreads);
+    if (!loaded) {
+        for (size_t i = 0 ; i < ipdbs.size () ; i++) {
+            if (ipdbs[i].get_in_error () != pdb::in_error_message::no_error) {
+                cerr << " • " << paths[i] << ": " << endl;
+                break;
             }
+        }
+        cerr << " \tError: " << ipdbs.get_in_error_message () << endl << endl;
+        return (EXIT_FAILURE);
+    }
 
-            cout << " \t‣ PDB mode     : ";
-            if (ipdb.get_pdb_mode () == pdb::pdb_mode::max) {
-                cout << "MAX" << endl;
-            } else if (ipdb.get_pdb_mode () == pdb::pdb_mode::max) {
-                cout << "ADD" << endl;
-            } else {
-                cerr << "\tError: Unknown type" << endl << endl;
+    // PDBs stored in shards are opened before reporting any, so that the
+    // p-patterns of additive PDBs are verified to be disjoint along with
+    // those in the heuristic set
+    vector<unique_ptr<pdb::inshards<pdb::node_t<npancake_t>>>> ishards;
+    vector<string> ppatterns;
+    bool additive = true;
+    for (size_t i = 0 ; i < ipdbs.size () ; i++) {
+        ppatterns.push_back (ipdbs[i].get_ppattern ());
+        additive = additive && ipdbs[i].get_pdb_mode () == pdb::pdb_mode::add;
+    }
+    for (auto ifile = 0 ; ifile < int (filenames.size ()) ; ifile++) {
+        if (sharded[ifile]) {
+            ishards.push_back (make_unique<pdb::inshards<pdb::node_t<npancake_t>>> (filenames[ifile]));
+            if (!ishards.back ()->open ()) {
+                cerr << " • " << filenames[ifile] << ": " << endl;
+                cerr << " \tError: " << ishards.back ()->get_in_error_message () << endl << endl;
                 return (EXIT_FAILURE);
             }
+            ppatterns.push_back (ishards.back ()->get_ppattern ());
+            additive = additive && ishards.back ()->get_pdb_mode () == pdb::pdb_mode::add;
+        }
+    }
+    if (additive && !pdb::heuristic_set<pdb::node_t<npancake_t>>::disjoint (ppatterns)) {
+        cerr << " \tError: " << pdb::to_string (pdb::in_error_message::pdb_patterns_overlap) << endl << endl;
+        return (EXIT_FAILURE);
+    }
+
+    for (auto ifile = 0, jfile = 0, kfile = 0 ; ifile < int (filenames.size ()) ; ifile++) {
 
-            // In case this PDB has a mode different than the previous ones
-            // issue an error
-            if (idx > 0 && mode != ipdb.get_pdb_mode ()) {
-                cout << endl << " \t\tError: non-compatible PDBs (different mode)" << endl << endl;
+        cout << " • " << filenames[ifile] << ": " << endl;
+
+        if (sharded[ifile]) {
+            auto& ishard = *ishards[kfile++];
+            if (!report (ishard)) {
                 return (EXIT_FAILURE);
             }
+            cout << " \t‣ shards       : " << ishard.get_nbloaded () << "/" << ishard.get_nbshards () << " loaded" << endl;
+        } else {
 
-            // If this is the first PDB, copy its mode
-            if (idx == 0) {
-                mode = ipdb.get_pdb_mode ();
+            // access this PDB and provide a summary of information. If
+            // requested, the PDB was mapped in memory so that its pages are
+            // shared with other processes
+            auto& ipdb = ipdbs[jfile++];
+            if (!report (ipdb)) {
+                return (EXIT_FAILURE);
             }
 
-            // show the patterns and also the size of the abstract state
-            cout << " \t‣ p-pattern    : " << ipdb.get_ppattern () << endl;
-            cout << " \t‣ c-pattern    : " << ipdb.get_cpattern () << endl;
-            cout << " \t‣ address space: " << ipdb.get_address_space () << endl;
-            // in case a permutation has been given
-            if (perm.size () > 0) {
-
-                // before querying the PDB, ensure that this permutation is
-                // compatible with it
-                cout << " \t‣ value        : ";
-                if (ipdb_goal.size () != vperm.size ()) {
-                    cout << endl << " \t\tError: non-compatible permutations (different size)" << endl << endl;
-                    return (EXIT_FAILURE);
-                } else {
-
-                    // Otherwise, show the value
-                    vals.push_back (int (ipdb[vperm]));
-                    cout << vals[vals.size ()-1] << endl;
-                }
+            // and the throughput of the read, unless it was mapped
+            if (!use_mmap) {
+                cout << " \t‣ read         : " << ipdb.get_throughput () << " MB/s" << endl;
             }
         }
 
@@ -208,15 +304,11 @@ int main (int argc, char** argv) {
         cout << endl;
     }
 
-    // Show the final value
-    cout << " Value ";
-    if (mode == pdb::pdb_mode::max) {
-
-        // compute the maximum
-        auto maxi = max_element (vals.begin (), vals.end ());
-        cout << "(MAX)  : " << *maxi << endl;
-    } else {
-        cout << "(ADD)  : " << "not implemented yet!" << endl;
+    // Show the final value, if a permutation was given, combining the
+    // values of all PDBs according to their mode
+    if (perm.size () > 0) {
+        cout << " Value " << ((mode == pdb::pdb_mode::max) ? "(MAX)" : "(ADD)") << "  : "
+             << pdb::heuristic_set<pdb::node_t<npancake_t>>::combine (mode, vals) << endl;
     }
 
     tend = chrono::system_clock::now ();
@@ -225,6 +317,13 @@ int main (int argc, char** argv) {
     // cout << " Address space: " << pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ppattern) << endl;
     cout << " 🕒 CPU time" << endl;
     cout << "    💿 Query  : " << 1e-9*chrono::duration_cast<chrono::nanoseconds>(tend - tstart).count() << " seconds" << endl;
+    if (ipdbs.size () > 0) {
+        cout << "    📂 Load   : " << 1e-3*ipdbs.get_elapsed_time ().count () << " seconds";
+        if (!use_mmap) {
+            cout << " (" << ipdbs.get_throughput () << " MB/s)";
+        }
+        cout << endl;
+    }
 
 
     // Well done! Keep up the good job!
@@ -237,18 +336,22 @@ int main (int argc, char** argv) {
 static int
 decode_switches (int argc, char **argv,
                  string& filename, string& perm,
-                 bool& want_verbose) {
+                 bool& use_mmap, int& nbthreads, bool& want_verbose) {
 
     int c;
 
     // Default values
     filename = "";
     perm = "";
+    use_mmap = false;
+    nbthreads = 0;
     want_verbose = false;
 
     while ((c = getopt_long (argc, argv,
-                             "f"  /* file */
-                             "p"  /* perm */
+                             "f:" /* file */
+                             "p:" /* perm */
+                             "m"  /* mmap */
+                             "t:" /* threads */
                              "v"  /* verbose */
                              "h"  /* help */
                              "V", /* version */
@@ -260,6 +363,12 @@ decode_switches (int argc, char **argv,
         case 'p':  /* --perm */
             perm = optarg;
             break;
+        case 'm':  /* --mmap */
+            use_mmap = true;
+            break;
+        case 't':  /* --threads */
+            nbthreads = atoi (optarg);
+            break;
         case 'v':  /* --verbose */
             want_verbose = true;
             break;
@@ -288,13 +397,18 @@ usage (int status)
       -f, --file     [STRING]  pattern database filename(s). If more than one is given, they have to be separated by\n\
                                blanks (so that it is assumed that filenames contain no blanks), and the result of the\n\
                                query automatically combines the heuristic values accordingly, i.e., MAX PDBs return\n\
-                               the max of all values, and ADD PDBs return the addition\n\
+                               the max of all values, and ADD PDBs return the addition. If the index of a PDB stored\n\
+                               in shards is given, only the shard storing the permutation is loaded\n\
 \n\
  Optional arguments:\n\
       -p, --perm     [STRING]  permutation to consider. It has to be given explicitly, and must contain the same symbols\n\
                                appearing in the explicit definition of the goal given in each PDB.\n\
                                If no permutation is given, then only information about the PDBs given with --file is\n\
                                provided\n\
+      -m, --mmap               map the PDBs in memory instead of reading them. Pages are loaded on demand and shared\n\
+                               with any other process mapping the same files\n\
+      -t, --threads  [INT]     number of threads used to load, and verify, all PDBs simultaneously. By default, one\n\
+                               per PDB\n\
  Misc arguments:\n\
       --verbose                print more information\n\
       -h, --help               display this help and exit\n\
@@ -14,6 +14,7 @@
 #define _PDBDEFS_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace pdb {
@@ -23,6 +24,97 @@ namespace pdb {
     // Types of PDBs
     enum class pdb_mode {max, add};
 
+    // Hints given to the kernel about the access pattern to PDBs mapped in
+    // memory. They correspond to MADV_NORMAL, MADV_RANDOM, MADV_SEQUENTIAL and
+    // MADV_WILLNEED respectively
+    enum class pdb_advice {normal, random, sequential, willneed};
+
+    // Pages used to store the values of PDBs in anonymous memory:
+    //
+    //    normal: pages of the size given by the system
+    //
+    //    transparent: the memory is aligned to 2 MB and the kernel is asked
+    //                 to back it with transparent huge pages (MADV_HUGEPAGE)
+    //
+    //    huge_2m, huge_1g: explicit huge pages of 2 MB and 1 GB taken from
+    //                      the pool reserved by the administrator
+    //                      (MAP_HUGETLB). If the pool is exhausted,
+    //                      transparent huge pages are used instead
+    enum class pdb_pages {normal, transparent, huge_2m, huge_1g};
+
+    // Placement of the pages of PDBs among the NUMA nodes of the host:
+    //
+    //    local: pages are allocated in the node of the thread which first
+    //           writes them, as usual
+    //
+    //    interleave: pages are spread round-robin among all nodes, so that
+    //                random lookups from any node are equally fast
+    //
+    //    replicate: once the PDB is complete, a copy is made in every node,
+    //               and every thread looks up the copy of its own node
+    enum class pdb_placement {local, interleave, replicate};
+
+    // Formats of the files storing PDBs:
+    //
+    //    v1: a bare header with the mode, the goal and both patterns
+    //        immediately followed by the values of the PDB
+    //
+    //    v2: a versioned header with the description of the encoding and
+    //        ranking of the values, a histogram of the values and the CRC32C
+    //        of every block of data, followed by the values of the PDB
+    //        starting at an offset aligned to the page size
+    enum class pdb_format {v1, v2};
+
+    // Encodings of the values stored either in memory or in files:
+    //
+    //    byte: every value takes exactly one byte
+    //
+    //    nibble: every value takes four bits, so that two values are packed
+    //            in every byte, the first one in the least significant bits.
+    //            It can store only values in the range [0, 15]
+    //
+    //    mod3: every value is stored modulo 3 in two bits, so that four
+    //          values are packed in every byte. It can be used only with
+    //          PDBs whose values differ at most in one unit between adjacent
+    //          abstract states, e.g., unit-cost domains, because the value
+    //          of a state is then recovered from the value of any neighbour
+    //
+    //    tribble: every value takes twelve bits, so that two values are
+    //             packed in every three bytes, the first one in the least
+    //             significant bits. It can store only values in the range
+    //             [0, 4095]
+    //
+    //    word: every value takes two bytes in little-endian
+    //
+    // Encodings are numbered in the order they were introduced, so that the
+    // number of every encoding recorded in files never changes
+    enum class pdb_encoding {byte, nibble, mod3, tribble, word};
+
+    // Compression of the values stored in files with format v2:
+    //
+    //    none: values are stored right after the header, so that they can
+    //          be directly mapped in memory
+    //
+    //    rle: every block of values is compressed independently with a
+    //         run-length encoding followed by a Huffman code (see
+    //         block_compress), and the offset of every block is given in a
+    //         block index right after the header, so that any block can be
+    //         decoded without decoding the others
+    enum class pdb_compression {none, rle};
+
+    // Ranking functions used to map abstract states to locations in the PDB
+    enum class pdb_ranking {myrvold_ruskey};
+
+    // Groupings of the locations of a PDB folded into a smaller one, so that
+    // every cell stores the minimum of all locations mapped to it:
+    //
+    //    block: k consecutive locations are mapped to the same cell, i.e.,
+    //           location r is mapped to cell r/k
+    //
+    //    modulo: locations are mapped to the m cells in a round-robin
+    //            fashion, i.e., location r is mapped to cell r%m
+    enum class pdb_grouping {block, modulo};
+
     // Plausible errors during the generation (outpdb/inpdb) of PDBs
     //
     //    no_error: everything *seems* okay
@@ -76,14 +168,237 @@ namespace pdb {
         pdb_ppattern_could_not_be_read,
         pdb_cpattern_could_not_be_read,
         pdb_incorrect_size,
-        pdb_g_values_could_not_be_read
+        pdb_g_values_could_not_be_read,
+        pdb_could_not_be_mapped,
+        pdb_could_not_be_locked,
+        pdb_format_not_supported,
+        pdb_header_could_not_be_read,
+        pdb_header_corrupted,
+        pdb_checksum_mismatch,
+        pdb_index_corrupted,
+        pdb_shard_mismatch,
+        pdb_block_corrupted,
+        pdb_goal_mismatch,
+        pdb_mode_mismatch,
+        pdb_patterns_overlap,
+        pdb_not_additive
     };
 
+    // return a string explaining the given error
+    inline std::string to_string (const in_error_message error) {
+        std::string output;
+        switch (error) {
+            case in_error_message::no_error:
+                output = "No error";
+                break;
+            case in_error_message::file_does_not_exist:
+                output = "File does not exist";
+                break;
+            case in_error_message::non_regular_file:
+                output = "Non regular file";
+                break;
+            case in_error_message::file_could_not_be_opened:
+                output = "File could not be opened";
+                break;
+            case in_error_message::size_could_not_be_determined:
+                output = "Size could not be determined";
+                break;
+            case in_error_message::pdb_mode_could_not_be_read:
+                output = "PDB mode could not be read";
+                break;
+            case in_error_message::pdb_length_could_not_be_read:
+                output = "Length could not be read";
+                break;
+            case in_error_message::pdb_goal_could_not_be_read:
+                output = "The goal could not be read";
+                break;
+            case in_error_message::pdb_ppattern_could_not_be_read:
+                output = "The ppattern could not be read";
+                break;
+            case in_error_message::pdb_cpattern_could_not_be_read:
+                output = "The ppattern could not be read";
+                break;
+            case in_error_message::pdb_incorrect_size:
+                output = "Incorrect size";
+                break;
+            case in_error_message::pdb_g_values_could_not_be_read:
+                output = "g-values could not be read";
+                break;
+            case in_error_message::pdb_could_not_be_mapped:
+                output = "The PDB could not be mapped in memory";
+                break;
+            case in_error_message::pdb_could_not_be_locked:
+                output = "The PDB could not be locked in memory";
+                break;
+            case in_error_message::pdb_format_not_supported:
+                output = "Format not supported";
+                break;
+            case in_error_message::pdb_header_could_not_be_read:
+                output = "The header could not be read";
+                break;
+            case in_error_message::pdb_header_corrupted:
+                output = "The header is corrupted";
+                break;
+            case in_error_message::pdb_checksum_mismatch:
+                output = "The contents of the PDB do not match their checksums";
+                break;
+            case in_error_message::pdb_index_corrupted:
+                output = "The index of the shards is corrupted";
+                break;
+            case in_error_message::pdb_shard_mismatch:
+                output = "A shard does not match the index";
+                break;
+            case in_error_message::pdb_block_corrupted:
+                output = "A compressed block is corrupted";
+                break;
+            case in_error_message::pdb_goal_mismatch:
+                output = "The PDBs have different goals";
+                break;
+            case in_error_message::pdb_mode_mismatch:
+                output = "The PDBs have different modes";
+                break;
+            case in_error_message::pdb_patterns_overlap:
+                output = "The patterns of additive PDBs are not disjoint";
+                break;
+            case in_error_message::pdb_not_additive:
+                output = "The domain does not support additive PDBs";
+                break;
+        }
+        return output;
+    }
+
     // indices to the pattern database are as long as size_t
     typedef unsigned long long int pdboff_t;
 
-    // values stored in a pdb are (for the time being) unsigned bytes
-    typedef uint8_t pdbval_t;
+    // values stored in a pdb are unsigned integers with 16 bits, so that the
+    // cost of abstract states can exceed 255 in domains with heavy costs.
+    // Note however that they are stored with any of the encodings above, so
+    // that every value takes only as many bits as its encoding
+    typedef uint16_t pdbval_t;
+
+    // return the number of bits used to store every value with the given
+    // encoding
+    constexpr int encoding_bits (const pdb_encoding encoding) {
+        switch (encoding) {
+            case pdb_encoding::mod3:
+                return 2;
+            case pdb_encoding::nibble:
+                return 4;
+            case pdb_encoding::tribble:
+                return 12;
+            case pdb_encoding::word:
+                return 16;
+            default:
+                return 8;
+        }
+    }
+
+    // return the maximum value that can be stored with the given encoding.
+    // Note that values encoded modulo 3 are never larger than 2
+    constexpr pdbval_t encoding_max (const pdb_encoding encoding) {
+        return pdbval_t ((1u << encoding_bits (encoding)) - 1);
+    }
+
+    // return the encoding with the least number of bits which can store all
+    // values in the range [0, value] and which is not computed modulo 3,
+    // i.e., byte, tribble or word. Nibbles are never returned so that every
+    // value takes at least one byte unless explicitly requested otherwise
+    constexpr pdb_encoding encoding_for (const pdboff_t value) {
+        return (value <= encoding_max (pdb_encoding::byte)) ? pdb_encoding::byte :
+            (value <= encoding_max (pdb_encoding::tribble)) ? pdb_encoding::tribble : pdb_encoding::word;
+    }
+
+    // return the i-th value stored in the given bytes with the given
+    // encoding. Values wider than one byte take two consecutive bytes in
+    // little-endian. In case the index is incorrect, the behaviour is
+    // undefined
+    inline pdbval_t encoding_get (const uint8_t* bytes, const pdboff_t i, const pdb_encoding encoding) {
+        const int bits = encoding_bits (encoding);
+        const pdboff_t bit = i * bits;
+        uint32_t window = bytes[bit >> 3];
+        if (bits > 8) {
+            window |= uint32_t (bytes[(bit >> 3) + 1]) << 8;
+        }
+        return pdbval_t ((window >> (bit & 7)) & encoding_max (encoding));
+    }
+
+    // write the given value as the i-th value stored in the given bytes with
+    // the given encoding without modifying any other. Bits of the value
+    // exceeding the encoding are ignored. In case the index is incorrect, the
+    // behaviour is undefined
+    inline void encoding_set (uint8_t* bytes, const pdboff_t i, const pdbval_t value, const pdb_encoding encoding) {
+        const int bits = encoding_bits (encoding);
+        const pdboff_t bit = i * bits;
+        const int shift = int (bit & 7);
+        const uint32_t mask = uint32_t (encoding_max (encoding)) << shift;
+        uint32_t window = bytes[bit >> 3];
+        if (bits > 8) {
+            window |= uint32_t (bytes[(bit >> 3) + 1]) << 8;
+        }
+        window = (window & ~mask) | ((uint32_t (value) << shift) & mask);
+        bytes[bit >> 3] = uint8_t (window);
+        if (bits > 8) {
+            bytes[(bit >> 3) + 1] = uint8_t (window >> 8);
+        }
+    }
+
+    // return the number of bytes necessary to store the given number of
+    // values with the given encoding
+    constexpr pdboff_t encoding_bytes (const pdb_encoding encoding, const pdboff_t nbvalues) {
+        return (nbvalues * encoding_bits (encoding) + 7) / 8;
+    }
+
+    // return a string with the name of the given encoding
+    inline std::string to_string (const pdb_encoding encoding) {
+        switch (encoding) {
+            case pdb_encoding::mod3:
+                return "mod3";
+            case pdb_encoding::nibble:
+                return "nibble";
+            case pdb_encoding::tribble:
+                return "tribble";
+            case pdb_encoding::word:
+                return "word";
+            default:
+                return "byte";
+        }
+    }
+
+    // return a string with the name of the given compression
+    inline std::string to_string (const pdb_compression compression) {
+        return (compression == pdb_compression::rle) ? "rle" : "none";
+    }
+
+    // return a string with the name of the given pages
+    inline std::string to_string (const pdb_pages pages) {
+        switch (pages) {
+            case pdb_pages::transparent:
+                return "transparent";
+            case pdb_pages::huge_2m:
+                return "huge-2m";
+            case pdb_pages::huge_1g:
+                return "huge-1g";
+            default:
+                return "normal";
+        }
+    }
+
+    // return a string with the name of the given placement
+    inline std::string to_string (const pdb_placement placement) {
+        switch (placement) {
+            case pdb_placement::interleave:
+                return "interleave";
+            case pdb_placement::replicate:
+                return "replicate";
+            default:
+                return "local";
+        }
+    }
+
+    // return a string with the name of the given grouping
+    inline std::string to_string (const pdb_grouping grouping) {
+        return (grouping == pdb_grouping::modulo) ? "modulo" : "block";
+    }
 
     // Type constraints
     //
@@ -102,6 +417,39 @@ namespace pdb {
         { item.get_perm () } -> std::same_as<const std::vector<int>&>;
     };
 
+    // Additionally, types can bound the cost of the optimal path from any
+    // state to the given goal with a static service 'cost_bound'. If given,
+    // PDBs are generated storing every value in one byte only if the bound
+    // fits in it, and in two bytes otherwise. If it is not given, all values
+    // are assumed to fit in one byte
+    template<typename T>
+    concept pdb_bounded = pdb_type<T> && requires (const std::vector<int>& goal) {
+        { T::cost_bound (goal) } -> std::convertible_to<pdboff_t>;
+    };
+
+    // Additive PDBs (pdb_mode::add) can only be generated for types whose
+    // children return with 'get_owner' the only symbol the operator that
+    // generated them is charged to, or NONPAT if it is charged to none. The
+    // owner must be known in abstract states whenever it is preserved, so
+    // that every PDB charges only the operators owned by the symbols of its
+    // p-pattern, and thus the values of PDBs whose p-patterns preserve
+    // disjoint sets of symbols can be added
+    template<typename T>
+    concept pdb_additive = pdb_type<T> && requires (const T& item) {
+        { item.get_owner () } -> std::convertible_to<int>;
+    };
+
+    // Finally, the values of dual states (see pdb_t::dual) can only be looked
+    // up for types whose static service 'dual_admissible' returns true. It
+    // must do so only if operators move symbols between locations regardless
+    // of them, the inverse of every operator is also an operator, and costs
+    // do not depend on the symbols moved, so that the distance of any
+    // permutation to the goal equals the distance of its dual state
+    template<typename T>
+    concept pdb_dual = pdb_type<T> && requires {
+        { T::dual_admissible () } -> std::convertible_to<bool>;
+    };
+
     // Constants
     //
     // An entry equal to zero in the pattern database means unused entry. Because of
@@ -0,0 +1,212 @@
+// -*- coding: utf-8 -*-
+// PDBevaluator.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 03:24:51.730194562 (1792380291)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Evaluation of heuristic sets against a cost bound
+//
+
+#ifndef _PDBEVALUATOR_H_
+#define _PDBEVALUATOR_H_
+
+#include<algorithm>
+#include<limits>
+#include<numeric>
+#include<vector>
+
+#include "PDBheuristic_set.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class evaluator;
+
+    // Class definition
+    //
+    // evaluators look up the PDBs of a heuristic set only until the
+    // combination of their values exceeds a given bound, e.g., the threshold
+    // of an iteration of IDA*, where it only matters whether the heuristic
+    // value of a state exceeds it. PDBs are looked up in decreasing order of
+    // their historical pruning power: with pdb_mode::max, the fraction of
+    // their lookups which exceeded the bound on their own; with
+    // pdb_mode::add, the average value returned. PDBs are sorted again every
+    // sort_period evaluations.
+    //
+    // Evaluators keep statistics of their own, and thus every thread should
+    // use a different one over the same heuristic set
+    template<typename T>
+    requires pdb_type<T>
+    class evaluator<node_t<T>> {
+
+    private:
+
+        // INVARIANT: evaluators look up the PDBs of a heuristic set in the
+        // order given in _order. The inverse of every permutation evaluated
+        // is stored in _inverse to avoid allocating memory in every
+        // evaluation
+        const heuristic_set<node_t<T>>& _hset;
+        std::vector<size_t> _order;
+        std::vector<int> _inverse;
+
+        // number of evaluations, how many of them exceeded the bound, and
+        // the number of lookups saved, i.e., those not performed because the
+        // bound was already exceeded
+        pdboff_t _nbevaluations;
+        pdboff_t _nbcutoffs;
+        pdboff_t _nbsaved;
+
+        // for every PDB, the number of lookups, how many of them exceeded the
+        // bound, and the sum of all values returned
+        std::vector<pdboff_t> _nblookups;
+        std::vector<pdboff_t> _nbprunes;
+        std::vector<pdboff_t> _sum;
+
+        // return the pruning power of the i-th PDB. PDBs which have never
+        // been looked up are deemed to be the strongest so that they are
+        // tried at least once
+        double _power (const size_t i) const {
+            if (!_nblookups[i]) {
+                return std::numeric_limits<double>::max ();
+            }
+            return double ((_hset.get_pdb_mode () == pdb_mode::max) ? _nbprunes[i] : _sum[i]) / _nblookups[i];
+        }
+
+        // sort all PDBs in decreasing order of their pruning power. Ties are
+        // broken in favour of the current order
+        void _sort () {
+            std::vector<double> power (_order.size ());
+            for (size_t i = 0 ; i < _order.size () ; i++) {
+                power[i] = _power (i);
+            }
+            std::stable_sort (_order.begin (), _order.end (),
+                              [&power] (const size_t i, const size_t j) { return power[i] > power[j]; });
+        }
+
+    public:
+
+        // PDBs are sorted again every sort_period evaluations
+        static constexpr pdboff_t sort_period = 1024;
+
+        // Default constructors are forbidden
+        evaluator () = delete;
+
+        // Explicit constructor ---evaluators are built over a heuristic set
+        // which has been already loaded, and it must outlive them. Initially,
+        // PDBs are looked up in the same order of the heuristic set
+        evaluator (const heuristic_set<node_t<T>>& hset) :
+            _hset          {                      hset },
+            _order         (              hset.size () ),
+            _nbevaluations {                         0 },
+            _nbcutoffs     {                         0 },
+            _nbsaved       {                         0 },
+            _nblookups     (hset.size (), pdboff_t (0) ),
+            _nbprunes      (hset.size (), pdboff_t (0) ),
+            _sum           (hset.size (), pdboff_t (0) )
+            {
+                std::iota (_order.begin (), _order.end (), 0);
+            }
+
+        // getters
+        const heuristic_set<node_t<T>>& get_heuristic_set () const {
+            return _hset;
+        }
+        const pdboff_t get_nbevaluations () const {
+            return _nbevaluations;
+        }
+        const pdboff_t get_nbcutoffs () const {
+            return _nbcutoffs;
+        }
+        const pdboff_t get_nbsaved () const {
+            return _nbsaved;
+        }
+
+        // return the number of lookups performed over all PDBs
+        const pdboff_t get_nblookups () const {
+            return std::accumulate (_nblookups.begin (), _nblookups.end (), pdboff_t (0));
+        }
+
+        // return the number of lookups performed in the i-th PDB, and how
+        // many of them exceeded the bound on their own
+        const pdboff_t get_nblookups (const size_t i) const {
+            return _nblookups[i];
+        }
+        const pdboff_t get_nbprunes (const size_t i) const {
+            return _nbprunes[i];
+        }
+
+        // return the order in which PDBs are currently looked up, as indices
+        // of the heuristic set
+        const std::vector<size_t>& get_order () const {
+            return _order;
+        }
+
+        // methods
+
+        // return the value of the given permutation if it is less or equal
+        // than bound. Otherwise, return a value strictly larger than bound
+        // and less or equal than the value of the permutation, which is
+        // computed looking up as few PDBs as possible. Values encoded modulo
+        // 3 are recovered from the abstract goal (see inpdb::value)
+        pdbval_t evaluate (const std::vector<int>& perm, const pdbval_t bound) {
+
+            _nbevaluations++;
+            if (_order.empty ()) {
+                return 0;
+            }
+            _hset.invert (perm, _inverse);
+
+            // look up the PDBs until the combination of their values exceeds
+            // the bound
+            pdboff_t h = 0;
+            size_t nblookups = 0;
+            while (nblookups < _order.size ()) {
+                const size_t i = _order[nblookups++];
+                const pdbval_t value = _hset.value (i, perm, _inverse);
+                _nblookups[i]++;
+                _sum[i] += value;
+                if (value > bound) {
+                    _nbprunes[i]++;
+                }
+                h = (_hset.get_pdb_mode () == pdb_mode::max) ? std::max (h, pdboff_t (value)) : h + value;
+                if (h > bound) {
+                    _nbcutoffs++;
+                    break;
+                }
+            }
+            _nbsaved += _order.size () - nblookups;
+
+            if (!(_nbevaluations % sort_period)) {
+                _sort ();
+            }
+            return pdbval_t (std::min (h, pdboff_t (std::numeric_limits<pdbval_t>::max ())));
+        }
+
+        // return true if the value of the given permutation is strictly
+        // larger than bound
+        bool exceeds (const std::vector<int>& perm, const pdbval_t bound) {
+            return evaluate (perm, bound) > bound;
+        }
+
+        // reset all statistics and restore the order of the heuristic set
+        void reset () {
+            std::iota (_order.begin (), _order.end (), 0);
+            _nbevaluations = _nbcutoffs = _nbsaved = 0;
+            std::fill (_nblookups.begin (), _nblookups.end (), 0);
+            std::fill (_nbprunes.begin (), _nbprunes.end (), 0);
+            std::fill (_sum.begin (), _sum.end (), 0);
+        }
+
+    }; // class evaluator<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBEVALUATOR_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
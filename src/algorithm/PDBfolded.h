@@ -0,0 +1,180 @@
+// -*- coding: utf-8 -*-
+// PDBfolded.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:02:15.417330862 (1792364535)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Lossy compression of PDBs folding several locations into one cell
+//
+
+#ifndef _PDBFOLDED_H_
+#define _PDBFOLDED_H_
+
+#include<algorithm>
+#include<limits>
+#include<stdexcept>
+#include<utility>
+#include<vector>
+
+#include "PDBpdb.h"
+#include "PDBinpdb.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class folded;
+
+    // Class definition
+    //
+    // folded PDBs are a lossy compression of a PDB which has been already
+    // loaded: every k locations of the original PDB are grouped (see
+    // pdb_grouping) into one cell which stores the minimum of all of them,
+    // so that the memory required is divided by k. Because the value of
+    // every cell never exceeds the value of any location mapped to it,
+    // heuristics computed with folded PDBs are still admissible (though
+    // less informed), and thus, a folded PDB of a larger pattern can be
+    // used instead of an exact PDB of a smaller one taking the same memory.
+    //
+    // Permutations are ranked as in the original PDB and their rank is then
+    // mapped to the cell storing their value
+    template<typename T>
+    requires pdb_type<T>
+    class folded<node_t<T>> : public pdb<node_t<T>> {
+
+    private:
+
+        // INVARIANT: folded PDBs store one cell for every _factor locations
+        // of the original PDB, whose address space is recorded separately,
+        // grouped as given in _grouping
+        pdboff_t _factor;
+        pdb_grouping _grouping;
+        pdboff_t _address_space;
+
+        // they also record the total difference between the values of the
+        // original PDB and the values of their cells
+        pdboff_t _nblost;
+
+    public:
+
+        // Default constructors are forbidden
+        folded () = delete;
+
+        // Explicit constructor ---folded PDBs are built from a PDB which has
+        // been already loaded (either read or mapped) grouping every factor
+        // locations into one cell. The values are stored with the same
+        // encoding of the original PDB, which can not be mod3 because the
+        // minimum of values encoded modulo 3 is meaningless. In case the
+        // factor is null or the encoding is mod3, an exception is raised
+        folded (const inpdb<node_t<T>>& source, const pdboff_t factor,
+                const pdb_grouping grouping = pdb_grouping::block) :
+            pdb<node_t<T>>(source.get_pdb_mode (), source.get_goal (),
+                           source.get_cpattern (), source.get_ppattern ()),
+            _factor        {                   factor },
+            _grouping      {                 grouping },
+            _address_space { source.get_address_space () },
+            _nblost        {                        0 }
+            {
+                if (!_factor) {
+                    throw std::invalid_argument (" [folded] The factor must be strictly positive");
+                }
+                if (source.get_encoding () == pdb_encoding::mod3) {
+                    throw std::invalid_argument (" [folded] PDBs encoded modulo 3 can not be folded");
+                }
+
+                // create the PDB with the cells, which ranks permutations
+                // with the pattern of the original PDB
+                const pdboff_t nbcells = (_address_space + _factor - 1) / _factor;
+                pdb<node_t<T>>::_pdb = new pdb_t<node_t<T>> (nbcells, source.get_encoding ());
+                pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+                // every cell is computed with all locations mapped to it,
+                // which are consecutive with the block grouping, and nbcells
+                // apart from each other with the modulo grouping
+                const pdboff_t first = (_grouping == pdb_grouping::block) ? _factor : 1;
+                const pdboff_t step = (_grouping == pdb_grouping::block) ? 1 : nbcells;
+                for (pdboff_t cell = 0 ; cell < nbcells ; cell++) {
+                    const pdboff_t start = cell * first;
+                    const pdboff_t end = std::min (_address_space, start + _factor * step);
+                    pdbval_t value = std::numeric_limits<pdbval_t>::max ();
+                    for (pdboff_t location = start ; location < end ; location += step) {
+                        value = std::min (value, source[location]);
+                    }
+                    for (pdboff_t location = start ; location < end ; location += step) {
+                        _nblost += source[location] - value;
+                    }
+                    pdb<node_t<T>>::_pdb->insert (cell, value);
+                }
+            }
+
+        // getters
+        const pdboff_t get_factor () const {
+            return _factor;
+        }
+        const pdb_grouping get_grouping () const {
+            return _grouping;
+        }
+        const pdb_encoding get_encoding () const {
+            return pdb<node_t<T>>::_pdb->get_encoding ();
+        }
+
+        // return the address space of the original PDB
+        pdboff_t get_address_space () const {
+            return _address_space;
+        }
+
+        // return the number of bytes taken by all cells
+        pdboff_t get_nbbytes () const {
+            return encoding_bytes (get_encoding (), pdb<node_t<T>>::capacity ());
+        }
+
+        // return the average difference between the values of the original
+        // PDB and those of this one over all locations of the original PDB
+        double get_loss () const {
+            return _address_space ? double (_nblost) / _address_space : 0.0;
+        }
+
+        // return the cell storing the value of the given location of the
+        // original PDB. In case the location exceeds its address space, the
+        // behaviour is undefined
+        pdboff_t cell (const pdboff_t location) const {
+            return (_grouping == pdb_grouping::block) ? location / _factor : location % pdb<node_t<T>>::capacity ();
+        }
+
+        // operator overloading
+
+        // Given a correct index to a cell, return its value. In case the
+        // index is out of bounds, the behaviour is undefined
+        pdbval_t operator[] (const pdboff_t index) const {
+            return (*pdb<node_t<T>>::_pdb)[index];
+        }
+
+        // get the value corresponding to the given permutation as a vector of
+        // integers, which is never larger than its value in the original PDB
+        const pdbval_t operator[] (const std::vector<int>& perm) const {
+            return pdb<node_t<T>>::_pdb->at (cell (pdb<node_t<T>>::_pdb->rank (perm)));
+        }
+
+        // methods
+
+        // return the value of the given permutation. It is provided to look
+        // up folded PDBs with the same interface of inpdb
+        pdbval_t value (const std::vector<int>& perm) const {
+            return (*this)[perm];
+        }
+        pdbval_t value (const std::vector<int>& perm, const pdbval_t parent_h) const {
+            return (*this)[perm];
+        }
+
+    }; // class folded<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBFOLDED_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,307 @@
+// -*- coding: utf-8 -*-
+// PDBheuristic_set.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 02:41:09.271853604 (1792377669)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Heuristics combining several PDBs
+//
+
+#ifndef _PDBHEURISTIC_SET_H_
+#define _PDBHEURISTIC_SET_H_
+
+#include<algorithm>
+#include<chrono>
+#include<filesystem>
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "PDBinpdbs.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class heuristic_set;
+
+    // Class definition
+    //
+    // heuristic sets load a collection of PDBs (see inpdbs) and evaluate
+    // states with all of them in one pass, combining their values either
+    // with their maximum (pdb_mode::max) or their sum (pdb_mode::add). All
+    // PDBs must have been generated with the same goal and mode, and the
+    // p-patterns of additive PDBs must preserve disjoint sets of symbols (see
+    // 'disjoint') of a domain which supports them (see pdb_additive). This
+    // is checked only once when they are loaded, and then the inverse of
+    // every permutation evaluated is computed only once and shared among all
+    // of them to rank it.
+    //
+    // Once loaded, heuristic sets are never modified, and thus they can be
+    // used to evaluate states from any number of threads simultaneously
+    template<typename T>
+    requires pdb_type<T>
+    class heuristic_set<node_t<T>> {
+
+    private:
+
+        // INVARIANT: heuristic sets keep all PDBs in an instance of inpdbs,
+        // in the same order given in the constructor. Once loaded, all of
+        // them share the same goal and mode, which is the one used to
+        // combine their values
+        inpdbs<node_t<T>> _pdbs;
+        pdb_mode _mode;
+
+        // the first error found while loading the PDBs, if any
+        in_error_message _in_error;
+
+        // verify that all PDBs were loaded and that they are compatible, i.e.,
+        // that all of them have the same goal and mode, and that their
+        // p-patterns are disjoint if they are additive, which is only allowed
+        // for domains supporting additive PDBs (see pdb_additive). It returns
+        // true if they are and false otherwise, and the error is recorded in
+        // _in_error
+        bool _check () {
+            _in_error = in_error_message::no_error;
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                const inpdb<node_t<T>>& ipdb = _pdbs[i];
+                if (ipdb.get_in_error () != in_error_message::no_error) {
+                    _in_error = ipdb.get_in_error ();
+                } else if (ipdb.get_goal () != _pdbs[0].get_goal ()) {
+                    _in_error = in_error_message::pdb_goal_mismatch;
+                } else if (ipdb.get_pdb_mode () != _pdbs[0].get_pdb_mode ()) {
+                    _in_error = in_error_message::pdb_mode_mismatch;
+                }
+                if (_in_error != in_error_message::no_error) {
+                    return false;
+                }
+            }
+            if (_pdbs.size () > 0) {
+                _mode = _pdbs[0].get_pdb_mode ();
+            }
+            if (_mode == pdb_mode::add) {
+                if (!pdb_additive<T>) {
+                    _in_error = in_error_message::pdb_not_additive;
+                    return false;
+                }
+                std::vector<std::string> patterns;
+                for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                    patterns.push_back (_pdbs[i].get_ppattern ());
+                }
+                if (!disjoint (patterns)) {
+                    _in_error = in_error_message::pdb_patterns_overlap;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    public:
+
+        // Default constructors are forbidden
+        heuristic_set () = delete;
+
+        // Explicit constructor ---the paths to the files with the PDBs have to
+        // be provided. No PDB is loaded until either 'read' or 'map' is used
+        heuristic_set (const std::vector<std::filesystem::path>& paths) :
+            _pdbs     {                    paths },
+            _mode     {            pdb_mode::max },
+            _in_error { in_error_message::no_error }
+            {}
+
+        // getters
+        size_t size () const {
+            return _pdbs.size ();
+        }
+        const pdb_mode get_pdb_mode () const {
+            return _mode;
+        }
+        const in_error_message get_in_error () const {
+            return _in_error;
+        }
+        const std::chrono::duration<double, std::milli> get_elapsed_time () const {
+            return _pdbs.get_elapsed_time ();
+        }
+        const size_t get_nbbytes () const {
+            return _pdbs.get_nbbytes ();
+        }
+        double get_throughput () const {
+            return _pdbs.get_throughput ();
+        }
+
+        // return all PDBs of this set, e.g., to perform batched lookups
+        const inpdbs<node_t<T>>& get_pdbs () const {
+            return _pdbs;
+        }
+
+        // operator overloading
+
+        // return the i-th PDB, in the same order given in the constructor
+        const inpdb<node_t<T>>& operator[] (const size_t i) const {
+            return _pdbs[i];
+        }
+
+        // methods
+
+        // return the combination of the given values with the given mode,
+        // i.e., either their maximum or their sum. Sums which can not be
+        // represented are saturated to the largest value
+        static pdbval_t combine (const pdb_mode mode, const std::vector<pdbval_t>& values) {
+            if (mode == pdb_mode::max) {
+                return values.empty () ? pdbval_t (0) : *std::max_element (values.begin (), values.end ());
+            }
+            pdboff_t sum = 0;
+            for (auto value : values) {
+                sum += value;
+            }
+            return pdbval_t (std::min (sum, pdboff_t (std::numeric_limits<pdbval_t>::max ())));
+        }
+
+        // return true if no symbol is preserved by more than one of the given
+        // patterns, all of them defined wrt the same goal, so that the values
+        // of additive PDBs generated with them can be added (see
+        // outpdb::generate). Patterns with different lengths are never
+        // disjoint
+        static bool disjoint (const std::vector<std::string>& patterns) {
+            if (patterns.empty ()) {
+                return true;
+            }
+            std::vector<bool> preserved (patterns[0].size (), false);
+            for (const auto& pattern : patterns) {
+                if (pattern.size () != preserved.size ()) {
+                    return false;
+                }
+                for (size_t i = 0 ; i < pattern.size () ; i++) {
+                    if (pattern[i] == '-') {
+                        if (preserved[i]) {
+                            return false;
+                        }
+                        preserved[i] = true;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // read all PDBs simultaneously (see inpdbs::read) and return true if
+        // all of them were successfully read and they are compatible, and
+        // false otherwise. The error is available in get_in_error
+        bool read (const int nbthreads = 0, const bool check = true) {
+            const bool loaded = _pdbs.read (nbthreads, check);
+            return _check () && loaded;
+        }
+
+        // map all PDBs simultaneously (see inpdbs::map) and return true if
+        // all of them were successfully mapped and they are compatible, and
+        // false otherwise. The error is available in get_in_error
+        bool map (const int nbthreads = 0, const bool check = true,
+                  const pdb_advice advice = pdb_advice::random,
+                  const bool prefault = false, const bool lock = false) {
+            const bool loaded = _pdbs.map (nbthreads, check, advice, prefault, lock);
+            return _check () && loaded;
+        }
+
+        // write in inverse the location of every symbol in the given
+        // permutation, which is shared by all PDBs to rank it (see
+        // pdb_t::invert). The set must contain at least one PDB
+        void invert (const std::vector<int>& perm, std::vector<int>& inverse) const {
+            _pdbs[0].invert (perm, inverse);
+        }
+
+        // return the value of the given permutation in the i-th PDB, where
+        // inverse is its inverse as computed by 'invert'. Values encoded
+        // modulo 3 are recovered from the abstract goal (see inpdb::value)
+        pdbval_t value (const size_t i, const std::vector<int>& perm, const std::vector<int>& inverse) const {
+            const inpdb<node_t<T>>& ipdb = _pdbs[i];
+            return (ipdb.get_encoding () == pdb_encoding::mod3) ? ipdb.value (perm) : ipdb.at_inverse (inverse);
+        }
+
+        // return the value of the given permutation, i.e., the combination of
+        // its values in all PDBs, which are written in values. Values encoded
+        // modulo 3 are recovered from the abstract goal (see inpdb::value),
+        // so that this service should be used only with the start state of a
+        // search
+        pdbval_t evaluate (const std::vector<int>& perm, std::vector<pdbval_t>& values) const {
+            values.resize (_pdbs.size ());
+            if (_pdbs.size () == 0) {
+                return 0;
+            }
+            std::vector<int> inverse;
+            invert (perm, inverse);
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                values[i] = value (i, perm, inverse);
+            }
+            return combine (_mode, values);
+        }
+        pdbval_t evaluate (const std::vector<int>& perm) const {
+            std::vector<pdbval_t> values;
+            return evaluate (perm, values);
+        }
+
+        // return the maximum of the value of the given full permutation and
+        // the value of its dual state (see inpdb::dual_value), each one
+        // combining the values of all PDBs. The locations of the symbols in
+        // both are computed only once and shared among all of them. Note
+        // that regular and dual values are never mixed in the same
+        // combination, so that additive PDBs remain admissible. An exception
+        // is thrown if dual lookups are not admissible in the domain
+        pdbval_t evaluate_dual (const std::vector<int>& perm) const {
+            if (!inpdb<node_t<T>>::dual_admissible ()) {
+                throw std::invalid_argument (" [heuristic_set::evaluate_dual] Dual lookups are not admissible in this domain");
+            }
+            if (_pdbs.size () == 0) {
+                return 0;
+            }
+            std::vector<int> inverse, dual;
+            _pdbs[0].invert (perm, inverse, dual);
+            std::vector<pdbval_t> values (_pdbs.size ()), dvalues (_pdbs.size ());
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                const inpdb<node_t<T>>& ipdb = _pdbs[i];
+                if (ipdb.get_encoding () == pdb_encoding::mod3) {
+                    values[i] = ipdb.value (perm);
+                    dvalues[i] = ipdb.dual_value (perm);
+                } else {
+                    values[i] = ipdb.at_inverse (inverse);
+                    dvalues[i] = ipdb.at_inverse (dual);
+                }
+            }
+            return std::max (combine (_mode, values), combine (_mode, dvalues));
+        }
+
+        // return the value of the given permutation during a search, where
+        // parent_h[i] is the value of its parent in the i-th PDB (see
+        // inpdb::value). The values of the permutation in all PDBs are
+        // written in values, so that they can be given to its children
+        pdbval_t evaluate (const std::vector<int>& perm, const std::vector<pdbval_t>& parent_h,
+                           std::vector<pdbval_t>& values) const {
+            values.resize (_pdbs.size ());
+            if (_pdbs.size () == 0) {
+                return 0;
+            }
+            std::vector<int> inverse;
+            invert (perm, inverse);
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                const inpdb<node_t<T>>& ipdb = _pdbs[i];
+                values[i] = ipdb.decode (ipdb.at_inverse (inverse), parent_h[i]);
+            }
+            return combine (_mode, values);
+        }
+
+        // return a string representing the current error
+        std::string get_in_error_message () const {
+            return to_string (_in_error);
+        }
+
+    }; // class heuristic_set<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBHEURISTIC_SET_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
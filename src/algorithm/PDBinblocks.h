@@ -0,0 +1,394 @@
+// -*- coding: utf-8 -*-
+// PDBinblocks.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:52:52.740391568 (1792367572)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Reading compressed PDBs which are decoded on demand
+//
+
+#ifndef _PDBINBLOCKS_H_
+#define _PDBINBLOCKS_H_
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<filesystem>
+#include<fstream>
+#include<list>
+#include<mutex>
+#include<stdexcept>
+#include<thread>
+#include<unordered_map>
+#include<utility>
+#include<vector>
+
+#include "PDBpdb.h"
+#include "../structs/PDBheader_t.h"
+#include "../utils/PDBcodec.h"
+#include "../utils/PDBcrc32c.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class inblocks;
+
+    // Class definition
+    //
+    // inblocks read PDBs whose values are compressed (see pdb_compression)
+    // using nodes of any type provided that they satisfy the type constraint
+    // pdb_type, e.g., npancakes. Unlike inpdb, the values are kept
+    // compressed in memory, and every block is decoded only when one of its
+    // values is accessed. The last blocks decoded are kept in a small cache,
+    // and the least recently used one is evicted when it is full. Thus, the
+    // memory taken is the size of the compressed file plus the cache.
+    //
+    // Values can be stored with any encoding but mod3, whose values can not
+    // be recovered without accessing many other blocks. Lookups are
+    // thread-safe
+    template<typename T>
+    requires pdb_type<T>
+    class inblocks<node_t<T>> : public pdb<node_t<T>> {
+
+    private:
+
+        // INVARIANT: inblocks are retrieved from a file whose path is
+        // recorded separately. Its header describes the blocks, and the
+        // compressed blocks are kept in _data at the offsets given in _index
+        std::filesystem::path _path;
+        header_t _header;
+        std::vector<pdboff_t> _index;
+        std::vector<uint8_t> _data;
+
+        // and read as many values as the size of the abstract state
+        pdboff_t _address_space;
+
+        // type of error generated while reading the PDB from the filesystem
+        in_error_message _in_error;
+
+        // blocks decoded are kept in a cache with at most _cache_blocks
+        // blocks. _lru stores the blocks from the most to the least recently
+        // used, and every block in the cache records its location in _lru
+        size_t _cache_blocks;
+        mutable std::mutex _lock;
+        mutable std::list<pdboff_t> _lru;
+        mutable std::unordered_map<pdboff_t, std::pair<std::vector<uint8_t>, std::list<pdboff_t>::iterator>> _cache;
+        mutable size_t _nbhits;
+        mutable size_t _nbmisses;
+
+        // inblocks also record the time spent reading the compressed blocks
+        std::chrono::duration<double, std::milli> _elapsed_time;
+
+        // decode the given block into out and return true if it was
+        // successfully decoded and false otherwise
+        bool _decode (const pdboff_t block, std::vector<uint8_t>& out) const {
+            out.resize (_header.get_block_length (block));
+            return block_decompress (_data.data () + _index[block], _index[block+1] - _index[block],
+                                     out.data (), out.size ());
+        }
+
+        // return the given byte of the values, decoding its block if it is
+        // not in the cache. If the block is corrupted, an exception is raised
+        uint8_t _byte (const pdboff_t byte) const {
+
+            const pdboff_t block = byte / _header.get_block_size ();
+            std::lock_guard<std::mutex> guard (_lock);
+            auto entry = _cache.find (block);
+            if (entry != _cache.end ()) {
+                _nbhits++;
+                _lru.splice (_lru.begin (), _lru, entry->second.second);
+            } else {
+                _nbmisses++;
+
+                // make room for this block, reusing the buffer of the least
+                // recently used one
+                std::vector<uint8_t> buffer;
+                if (_cache.size () >= _cache_blocks) {
+                    auto victim = _cache.find (_lru.back ());
+                    buffer = std::move (victim->second.first);
+                    _cache.erase (victim);
+                    _lru.pop_back ();
+                }
+                if (!_decode (block, buffer)) {
+                    throw std::runtime_error (" [inblocks] Block " + std::to_string (block) + " is corrupted");
+                }
+                _lru.push_front (block);
+                entry = _cache.emplace (block, std::make_pair (std::move (buffer), _lru.begin ())).first;
+            }
+            return entry->second.first[byte % _header.get_block_size ()];
+        }
+
+        // return the value at the given location. Values wider than one byte
+        // take two consecutive bytes, which might be found in different
+        // blocks (see encoding_get). If any block is corrupted, an exception
+        // is raised
+        pdbval_t _value (const pdboff_t location) const {
+
+            const pdb_encoding encoding = _header.get_encoding ();
+            const int bits = encoding_bits (encoding);
+            const pdboff_t bit = location * bits;
+            uint32_t window = _byte (bit >> 3);
+            if (bits > 8) {
+                window |= uint32_t (_byte ((bit >> 3) + 1)) << 8;
+            }
+            return pdbval_t ((window >> (bit & 7)) & encoding_max (encoding));
+        }
+
+    public:
+
+        // Default constructors are forbidden
+        inblocks () = delete;
+
+        // Explicit constructor ---the path to the file with the PDB has to be
+        // provided
+        inblocks (const std::filesystem::path path) :
+            pdb<node_t<T>>(pdb_mode::max, std::vector<int>(), "", ""),
+            _path          {                      path },
+            _address_space {                         0 },
+            _in_error      { in_error_message::no_error},
+            _cache_blocks  {      default_cache_blocks },
+            _nbhits        {                         0 },
+            _nbmisses      {                         0 },
+            _elapsed_time  {                         0 }
+            {}
+
+        // by default, the cache keeps 64 blocks
+        static constexpr size_t default_cache_blocks = 64;
+
+        // getters
+        const std::filesystem::path& get_path () const {
+            return _path;
+        }
+        const header_t& get_header () const {
+            return _header;
+        }
+        pdboff_t get_address_space () const {
+            return _address_space;
+        }
+        const in_error_message get_in_error () const {
+            return _in_error;
+        }
+        const pdb_format get_format () const {
+            return pdb_format::v2;
+        }
+        const pdb_encoding get_encoding () const {
+            return _header.get_encoding ();
+        }
+        const pdb_compression get_compression () const {
+            return _header.get_compression ();
+        }
+        const std::chrono::duration<double, std::milli> get_elapsed_time () const {
+            return _elapsed_time;
+        }
+
+        // return the number of bytes read from the file, which are kept in
+        // memory
+        const size_t get_nbbytes () const {
+            return _header.get_index_bytes () + _data.size ();
+        }
+
+        // return the number of accesses to blocks served from the cache, one
+        // per lookup (or two with values wider than one byte), and the
+        // number of blocks decoded
+        size_t get_nbhits () const {
+            std::lock_guard<std::mutex> guard (_lock);
+            return _nbhits;
+        }
+        size_t get_nbmisses () const {
+            std::lock_guard<std::mutex> guard (_lock);
+            return _nbmisses;
+        }
+
+        // return the number of blocks currently in the cache
+        size_t get_nbcached () const {
+            std::lock_guard<std::mutex> guard (_lock);
+            return _cache.size ();
+        }
+
+        // return the throughput of the last read, in MB/s. If no data has
+        // been read yet, zero is returned
+        double get_throughput () const {
+            return (_elapsed_time.count () > 0) ? (1e-3 * get_nbbytes () / _elapsed_time.count ()) : 0.0;
+        }
+
+        // operator overloading
+
+        // Given a correct index to the address space in this PDB, return the
+        // value at its location, decoding its block if necessary. In case the
+        // index is out of bounds, the behaviour is undefined. In case the
+        // block is corrupted, an exception is raised
+        pdbval_t operator[] (const pdboff_t index) const {
+            return _value (index);
+        }
+
+        // get the value corresponding to the given permutation as a vector
+        // of integers, decoding its block if necessary. Make sure to invoke
+        // this service only after using 'open'. In case the block is
+        // corrupted, an exception is raised
+        const pdbval_t operator[] (const std::vector<int>& perm) const {
+            return _value (pdb<node_t<T>>::_pdb->rank (perm));
+        }
+
+        // methods
+
+        // return the value of the given permutation, decoding its block if
+        // necessary. Because values encoded modulo 3 are not supported, the
+        // value of the parent, if given, is ignored (see inpdb::value)
+        pdbval_t value (const std::vector<int>& perm) const {
+            return (*this)[perm];
+        }
+        pdbval_t value (const std::vector<int>& perm, const pdbval_t parent_h) const {
+            return (*this)[perm];
+        }
+
+        // return the size of the abstract state of this PDB. Call this method
+        // only after using 'open'. Otherwise, the results are undefined.
+        pdboff_t address_space () const {
+            return _address_space;
+        }
+
+        // return the number of available positions in the PDB
+        size_t capacity () const {
+            return _address_space;
+        }
+
+        // read the header, the block index and all compressed blocks of the
+        // file found in the path used for constructing this instance, and
+        // prepare the PDB to decode them on demand keeping at most the given
+        // number of blocks decoded. No block is decoded. It returns the size
+        // of the abstract space or zero if any error happened
+        pdboff_t open (const size_t cache_blocks = default_cache_blocks) {
+
+            if (!cache_blocks) {
+                throw std::invalid_argument (" [inblocks::open] The cache must have room for one block at least");
+            }
+            if (!std::filesystem::exists(_path)) {
+                _in_error = in_error_message::file_does_not_exist;
+                return pdboff_t (0);
+            }
+            if (!std::filesystem::is_regular_file(_path)) {
+                _in_error = in_error_message::non_regular_file;
+                return pdboff_t (0);
+            }
+            std::ifstream pdbfile (_path, std::ios::binary | std::ios::ate);
+            if (!pdbfile) {
+                _in_error = in_error_message::file_could_not_be_opened;
+                return pdboff_t (0);
+            }
+            std::streamsize pdbsize = pdbfile.tellg();
+            if (pdbsize < 0) {
+                _in_error = in_error_message::size_could_not_be_determined;
+                return pdboff_t (0);
+            }
+            pdbfile.seekg(0, std::ios::beg);
+
+            // read the header, which must describe compressed values with
+            // an encoding other than mod3
+            auto start = std::chrono::high_resolution_clock::now();
+            if (!_header.deserialize (pdbfile, pdbsize, _in_error)) {
+                return pdboff_t (0);
+            }
+            if (_header.get_compression () == pdb_compression::none ||
+                _header.get_encoding () == pdb_encoding::mod3) {
+                _in_error = in_error_message::pdb_format_not_supported;
+                return pdboff_t (0);
+            }
+
+            // copy the description of the PDB and verify the address space is
+            // consistent with the p-pattern
+            pdb<node_t<T>>::_mode = _header.get_mode ();
+            pdb<node_t<T>>::_goal = _header.get_goal ();
+            pdb<node_t<T>>::_p_pattern = _header.get_ppattern ();
+            pdb<node_t<T>>::_c_pattern = _header.get_cpattern ();
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            if (pspace != _header.get_address_space ()) {
+                _in_error = in_error_message::pdb_incorrect_size;
+                return pdboff_t (0);
+            }
+
+            // read the block index and all compressed blocks
+            pdbfile.seekg(_header.get_offset (), std::ios::beg);
+            if (!_header.deserialize_index (pdbfile, pdboff_t (pdbsize), _index, _in_error)) {
+                return pdboff_t (0);
+            }
+            _data = std::vector<uint8_t> (_index.back ());
+            if (!pdbfile.read (reinterpret_cast<char*> (_data.data ()), std::streamsize (_data.size ()))) {
+                _in_error = in_error_message::pdb_g_values_could_not_be_read;
+                return pdboff_t (0);
+            }
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+
+            // the PDB is used only to rank permutations, and thus it takes
+            // no room at all
+            if (pdb<node_t<T>>::_pdb != nullptr) {
+                delete pdb<node_t<T>>::_pdb;
+            }
+            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>));
+            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pdboff_t (0));
+            pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+            // and start with an empty cache
+            std::lock_guard<std::mutex> guard (_lock);
+            _cache_blocks = cache_blocks;
+            _cache.clear ();
+            _lru.clear ();
+            _nbhits = _nbmisses = 0;
+
+            // set the size of the abstract state of this PDB
+            _address_space = pspace;
+            return pspace;
+        }
+
+        // verify the integrity of the values of the PDB, which must have been
+        // opened, and return true if they are correct and false otherwise.
+        // Every block is decoded (without being cached) and its checksum is
+        // compared with that stored in the header. Blocks are distributed
+        // among the given number of threads
+        bool verify (const int nbthreads = 1) {
+
+            const pdboff_t nbblocks = _header.get_nbblocks ();
+            std::atomic<bool> failed = false;
+            auto worker = [&] (const pdboff_t id, const pdboff_t nbworkers) {
+                std::vector<uint8_t> buffer;
+                for (pdboff_t block = id ; block < nbblocks && !failed ; block += nbworkers) {
+                    if (!_decode (block, buffer) ||
+                        crc32c (buffer.data (), buffer.size ()) != _header.get_checksums ()[block]) {
+                        failed = true;
+                    }
+                }
+            };
+            const pdboff_t nbworkers = std::max (pdboff_t (1), std::min (pdboff_t (std::max (nbthreads, 1)), nbblocks));
+            std::vector<std::thread> threads;
+            for (pdboff_t id = 1 ; id < nbworkers ; id++) {
+                threads.push_back (std::thread (worker, id, nbworkers));
+            }
+            worker (0, nbworkers);
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+            if (failed) {
+                _in_error = in_error_message::pdb_checksum_mismatch;
+                return false;
+            }
+            return true;
+        }
+
+        // return a string representing the current error
+        std::string get_in_error_message () const {
+            return to_string (_in_error);
+        }
+
+    }; // class inblocks<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBINBLOCKS_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -13,10 +13,19 @@
 #ifndef _PDBINPDB_H_
 #define _PDBINPDB_H_
 
+#include<algorithm>
+#include<atomic>
+#include<chrono>
 #include<fstream>
 #include<filesystem>
+#include<limits>
+#include<stdexcept>
+#include<thread>
+#include<tuple>
 
 #include "PDBpdb.h"
+#include "../structs/PDBheader_t.h"
+#include "../utils/PDBcodec.h"
 
 namespace pdb {
 
@@ -44,45 +53,22 @@ namespace pdb {
         // type of error generated while reading the PDB from the filesystem
         in_error_message _in_error;
 
-    public:
-
-        // Default constructors are forbidden
-        inpdb () = delete;
+        // files can be stored in different formats. In case of v2, the header
+        // is kept to verify the contents of the PDB
+        pdb_format _format;
+        header_t _header;
 
-        // Explicit constructor ---the path to the file with the information of
-        // the PDB has to be provided
-        inpdb (const std::filesystem::path path) :
-            pdb<node_t<T>>(pdb_mode::max, std::vector<int>(), "", ""),
-            _path          {                      path },
-            _address_space {                         0 },
-            _in_error      { in_error_message::no_error}
-            {}
+        // inPDBs also record the time spent reading their contents, and the
+        // number of bytes read
+        std::chrono::duration<double, std::milli> _elapsed_time;
+        size_t _nbbytes;
 
-        // getters
-        const std::filesystem::path& get_path () const {
-            return _path;
-        }
-
-        // getters
-        pdboff_t get_address_space () const {
-            return _address_space;
-        }
-        const in_error_message get_in_error () const {
-            return _in_error;
-        }
-
-        // methods
-
-        // return the size of the abstract state of this PDB. Call this method
-        // only after using 'read'. Otherwise, the rsults are undefined.
-        pdboff_t address_space () const {
-            return _address_space;
-        }
-
-        // retrieve the contents from the filename found in the path used for
-        // constructing this instance and return the size of its abstract space
-        // or zero if any error happened.
-        pdboff_t read() {
+        // open the file found in the path used for constructing this instance
+        // with pdbfile and read its header, leaving pdbfile right at the
+        // beginning of the data. It returns the size of the abstract state
+        // space and the offset of the data in the file, or zero if any error
+        // happened
+        pdboff_t _read_header (std::ifstream& pdbfile, pdboff_t& offset) {
 
             // Check if the file exists and is readable
             if (!std::filesystem::exists(_path)) {
@@ -97,7 +83,7 @@ namespace pdb {
             }
 
             // open the file in binary mode at end to get its size
-            std::ifstream pdbfile(_path, std::ios::binary | std::ios::ate);
+            pdbfile.open (_path, std::ios::binary | std::ios::ate);
             if (!pdbfile) {
                 _in_error = in_error_message::file_could_not_be_opened;
                 return pdboff_t (0);
@@ -113,15 +99,29 @@ namespace pdb {
             // start reading all fields of the PDB from the beginning
             pdbfile.seekg(0, std::ios::beg);
 
+            // files with format v2 start with a magic number, whereas files
+            // with format v1 start with the mode
+            std::vector<uint8_t> hmagic (3, 0);
+            if (!pdbfile.read(reinterpret_cast<char*>(hmagic.data()), hmagic.size ())) {
+                _in_error = in_error_message::pdb_mode_could_not_be_read;
+                return pdboff_t (0);
+            }
+            pdbfile.seekg(0, std::ios::beg);
+            if (std::equal (hmagic.begin (), hmagic.end (), header_t::magic)) {
+                _format = pdb_format::v2;
+                return _read_header_v2 (pdbfile, pdbsize, offset);
+            }
+            _format = pdb_format::v1;
+
             // 1. Determine whether this is a MAX or ADD pdb
-            std::vector<pdbval_t> hmode (3, 0);
+            std::vector<uint8_t> hmode (3, 0);
             if (!pdbfile.read(reinterpret_cast<char*>(hmode.data()), hmode.size ())) {
                 _in_error = in_error_message::pdb_mode_could_not_be_read;
                 return pdboff_t (0);
             }
-            if (hmode == std::vector<pdbval_t>{'M', 'A', 'X'}) {
+            if (hmode == std::vector<uint8_t>{'M', 'A', 'X'}) {
                 pdb<node_t<T>>::_mode = pdb_mode::max;
-            } else if (hmode == std::vector<pdbval_t>{'A', 'D', 'D'}) {
+            } else if (hmode == std::vector<uint8_t>{'A', 'D', 'D'}) {
                 pdb<node_t<T>>::_mode = pdb_mode::add;
             }  else {
                 return 0;
@@ -166,26 +166,288 @@ namespace pdb {
             // 6. Read data. The number of locations should be equal to the size
             // of the abstract state induced by the _p_pattern
             pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
-            if (pspace + 3 + 1 + length*3 != pdbsize) {
+            offset = 3 + 1 + length*3;
+            if (pspace + offset != pdbsize) {
                 _in_error = in_error_message::pdb_incorrect_size;
                 return pdboff_t (0);
             }
 
-            // initialize the PDB data member to write data into it
-            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>(pspace)));
-            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pspace);
+            return pspace;
+        }
+
+        // read the header of a file with format v2 from pdbfile, whose size
+        // is given in pdbsize. It returns the size of the abstract state space
+        // and the offset of the data in the file, or zero if any error
+        // happened
+        pdboff_t _read_header_v2 (std::ifstream& pdbfile, const pdboff_t pdbsize, pdboff_t& offset) {
+
+            if (!_header.deserialize (pdbfile, pdbsize, _in_error)) {
+                return pdboff_t (0);
+            }
+
+            // copy the description of the PDB
+            pdb<node_t<T>>::_mode = _header.get_mode ();
+            pdb<node_t<T>>::_goal = _header.get_goal ();
+            pdb<node_t<T>>::_p_pattern = _header.get_ppattern ();
+            pdb<node_t<T>>::_c_pattern = _header.get_cpattern ();
+
+            // and verify the address space is consistent with the p-pattern
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            if (pspace != _header.get_address_space ()) {
+                _in_error = in_error_message::pdb_incorrect_size;
+                return pdboff_t (0);
+            }
+            offset = _header.get_offset ();
+            pdbfile.seekg(offset, std::ios::beg);
+
+            return pspace;
+        }
+
+        // read the compressed values of a file with format v2 from pdbfile,
+        // which must be positioned right at the block index, and decompress
+        // them into the PDB with the given number of threads. It returns the
+        // size of the abstract state space, or zero if any error happened
+        pdboff_t _read_compressed (std::ifstream& pdbfile, const pdboff_t pspace, const int nbthreads) {
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // read the block index and then all compressed blocks at once
+            std::vector<pdboff_t> index;
+            pdbfile.seekg (0, std::ios::end);
+            pdboff_t pdbsize = pdboff_t (pdbfile.tellg ());
+            pdbfile.seekg (_header.get_offset (), std::ios::beg);
+            if (!_header.deserialize_index (pdbfile, pdbsize, index, _in_error)) {
+                return pdboff_t (0);
+            }
+            std::vector<uint8_t> data (index.back ());
+            for (size_t done = 0 ; done < data.size () ; ) {
+                size_t chunk = std::min (read_chunk_bytes, data.size () - done);
+                if (!pdbfile.read (reinterpret_cast<char*> (data.data () + done), std::streamsize (chunk))) {
+                    _in_error = in_error_message::pdb_g_values_could_not_be_read;
+                    return pdboff_t (0);
+                }
+                done += chunk;
+            }
+
+            // and decompress every block directly into the storage of the PDB.
+            // Every thread decompresses the blocks i, i+nbthreads, ...
+            uint8_t* storage = pdb<node_t<T>>::_pdb->get_storage ().data ();
+            const pdboff_t nbblocks = _header.get_nbblocks ();
+            std::atomic<bool> failed = false;
+            auto worker = [&] (const pdboff_t id, const pdboff_t nbworkers) {
+                for (pdboff_t block = id ; block < nbblocks && !failed ; block += nbworkers) {
+                    if (!block_decompress (data.data () + index[block], index[block+1] - index[block],
+                                           storage + block * _header.get_block_size (),
+                                           _header.get_block_length (block))) {
+                        failed = true;
+                    }
+                }
+            };
+            const pdboff_t nbworkers = std::max (pdboff_t (1), std::min (pdboff_t (std::max (nbthreads, 1)), nbblocks));
+            std::vector<std::thread> threads;
+            for (pdboff_t id = 1 ; id < nbworkers ; id++) {
+                threads.push_back (std::thread (worker, id, nbworkers));
+            }
+            worker (0, nbworkers);
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+            if (failed) {
+                _in_error = in_error_message::pdb_block_corrupted;
+                return pdboff_t (0);
+            }
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+            _nbbytes = _header.get_index_bytes () + data.size ();
+
+            // copy the PDB to every NUMA node, if requested
+            pdb<node_t<T>>::_replicate ();
+
+            // set the size of the abstract state of this PDB
+            _address_space = pspace;
+            return pspace;
+        }
+
+    public:
+
+        // Default constructors are forbidden
+        inpdb () = delete;
+
+        // Explicit constructor ---the path to the file with the information of
+        // the PDB has to be provided
+        inpdb (const std::filesystem::path path) :
+            pdb<node_t<T>>(pdb_mode::max, std::vector<int>(), "", ""),
+            _path          {                      path },
+            _address_space {                         0 },
+            _in_error      { in_error_message::no_error},
+            _format        {           pdb_format::v1 },
+            _elapsed_time  {                         0 },
+            _nbbytes       {                         0 }
+            {}
+
+        // g-values are read from files in chunks of this size, which is a
+        // multiple of the page size
+        static constexpr size_t read_chunk_bytes = 8 * 1024 * 1024;
+
+        // getters
+        const std::filesystem::path& get_path () const {
+            return _path;
+        }
+
+        // getters
+        pdboff_t get_address_space () const {
+            return _address_space;
+        }
+        const in_error_message get_in_error () const {
+            return _in_error;
+        }
+        const pdb_format get_format () const {
+            return _format;
+        }
+
+        // return the encoding of the values of the PDB. Files with format v1
+        // always store one value per byte
+        const pdb_encoding get_encoding () const {
+            return (_format == pdb_format::v2) ? _header.get_encoding () : pdb_encoding::byte;
+        }
+
+        // return the compression of the values of the PDB in its file. Files
+        // with format v1 are never compressed
+        const pdb_compression get_compression () const {
+            return (_format == pdb_format::v2) ? _header.get_compression () : pdb_compression::none;
+        }
+        const header_t& get_header () const {
+            return _header;
+        }
+        const std::chrono::duration<double, std::milli> get_elapsed_time () const {
+            return _elapsed_time;
+        }
+        const size_t get_nbbytes () const {
+            return _nbbytes;
+        }
+
+        // return the throughput of the last read, in MB/s. If no data has
+        // been read yet, zero is returned
+        double get_throughput () const {
+            return (_elapsed_time.count () > 0) ? (1e-3 * _nbbytes / _elapsed_time.count ()) : 0.0;
+        }
+
+        // methods
+
+        // return the size of the abstract state of this PDB. Call this method
+        // only after using either 'read' or 'map'. Otherwise, the rsults are
+        // undefined.
+        pdboff_t address_space () const {
+            return _address_space;
+        }
+
+        // retrieve the contents from the filename found in the path used for
+        // constructing this instance and return the size of its abstract space
+        // or zero if any error happened. If the values are compressed, all
+        // blocks are read at once and then they are decompressed with the
+        // given number of threads. Values are stored in memory with the pages
+        // and placement given with 'place'. Note that interleaved pages are
+        // allocated as they are read, whereas replicated PDBs are copied to
+        // every NUMA node once they have been read
+        pdboff_t read (const int nbthreads = 1) {
+
+            // read the header and get the size of the abstract state space
+            std::ifstream pdbfile;
+            pdboff_t offset;
+            pdboff_t pspace = _read_header (pdbfile, offset);
+            if (!pspace) {
+                return pdboff_t (0);
+            }
+
+            // initialize the PDB data member to write data into it, with the
+            // same encoding used in the file
+            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>));
+            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pspace, get_encoding (),
+                                                                    pdb<node_t<T>>::_pages,
+                                                                    pdb<node_t<T>>::_placement);
             pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
 
-            // and populate the PDB data member
-            std::vector<pdbval_t> gvals (pspace, 0);
-            if (!pdbfile.read(reinterpret_cast<char*>(gvals.data()), pspace)) {
-                _in_error = in_error_message::pdb_g_values_could_not_be_read;
+            // compressed values are decompressed into the storage of the PDB
+            if (get_compression () != pdb_compression::none) {
+                return _read_compressed (pdbfile, pspace, nbthreads);
+            }
+
+            // and populate it streaming the g-values directly into its
+            // storage in large chunks, so that data is copied only once from
+            // the file into the PDB
+            auto start = std::chrono::high_resolution_clock::now();
+            auto storage = pdb<node_t<T>>::_pdb->get_storage ();
+            char* address = reinterpret_cast<char*>(storage.data ());
+            size_t nbbytes = storage.size ();
+            for (size_t done = 0 ; done < nbbytes ; ) {
+                size_t chunk = std::min (read_chunk_bytes, nbbytes - done);
+                if (!pdbfile.read(address + done, std::streamsize (chunk))) {
+                    _in_error = in_error_message::pdb_g_values_could_not_be_read;
+                    return pdboff_t (0);
+                }
+                done += chunk;
+            }
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+            _nbbytes = nbbytes;
+
+            // copy the PDB to every NUMA node, if requested
+            pdb<node_t<T>>::_replicate ();
+
+            // set the size of the abstract state of this PDB
+            _address_space = pspace;
+
+            // and return the number of abstract states found in the PDB
+            return pspace;
+        }
+
+        // map the contents of the file found in the path used for constructing
+        // this instance in memory instead of reading them, and return the size
+        // of its abstract space or zero if any error happened. No copy of the
+        // data is made, and all processes mapping the same file share the same
+        // physical memory. The resulting PDB is read-only.
+        //
+        // The expected access pattern is given to the kernel with advice. If
+        // prefault is true, all pages are read before returning, so that no
+        // page fault happens later; if lock is true, pages are locked in memory
+        // so that they are never swapped out. If replication was requested
+        // with 'place', the PDB is copied to every NUMA node, and the pages
+        // of the file are used only while copying them
+        pdboff_t map (const pdb_advice advice = pdb_advice::random,
+                      const bool prefault = false, const bool lock = false) {
+
+            // read the header and get the size of the abstract state space
+            std::ifstream pdbfile;
+            pdboff_t offset;
+            pdboff_t pspace = _read_header (pdbfile, offset);
+            if (!pspace) {
                 return pdboff_t (0);
             }
-            for (pdboff_t i = 0 ; i < pspace ; i++) {
-                (*pdb<node_t<T>>::_pdb)[i]=gvals[i];
+            pdbfile.close ();
+
+            // compressed values can not be mapped
+            if (get_compression () != pdb_compression::none) {
+                _in_error = in_error_message::pdb_format_not_supported;
+                return pdboff_t (0);
             }
 
+            // map the data stored right after the header
+            region_t region;
+            if (!region.map (_path, offset, encoding_bytes (get_encoding (), pspace), advice, prefault)) {
+                _in_error = in_error_message::pdb_could_not_be_mapped;
+                return pdboff_t (0);
+            }
+            if (lock && !region.lock ()) {
+                _in_error = in_error_message::pdb_could_not_be_locked;
+                return pdboff_t (0);
+            }
+
+            // and create the PDB data member as a view of the region
+            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>));
+            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (std::move (region), get_encoding (), pspace);
+            pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+            pdb<node_t<T>>::_replicate ();
+
             // set the size of the abstract state of this PDB
             _address_space = pspace;
 
@@ -193,48 +455,149 @@ namespace pdb {
             return pspace;
         }
 
+        // verify the integrity of the values of the PDB, which must have been
+        // loaded with either 'read' or 'map', and return true if they are
+        // correct and false otherwise. The checksum of every block of data
+        // and the histogram of values are computed with the given number of
+        // threads and compared with those stored in the header. Files with
+        // format v1 do not store this information and they are always deemed
+        // correct
+        bool verify (const int nbthreads = 1) {
+
+            if (_format == pdb_format::v1) {
+                return true;
+            }
+
+            std::vector<pdboff_t> histogram;
+            std::vector<uint32_t> checksums;
+            _header.summarize (pdb<node_t<T>>::_pdb->get_address (), histogram, checksums, nbthreads);
+            if (checksums != _header.get_checksums () || histogram != _header.get_histogram ()) {
+                _in_error = in_error_message::pdb_checksum_mismatch;
+                return false;
+            }
+            return true;
+        }
+
+        // return the value of the given permutation during a search, where
+        // parent_h is the value of its parent, i.e., an adjacent state. With
+        // values encoded modulo 3, the value is the only one which differs
+        // at most in one unit from parent_h and has the remainder stored.
+        // Otherwise, the value stored is returned and parent_h is ignored
+        pdbval_t value (const std::vector<int>& perm, const pdbval_t parent_h) const {
+            return decode (pdb<node_t<T>>::_pdb->at (pdb<node_t<T>>::_pdb->rank (perm)), parent_h);
+        }
+
+        // batched version of 'value' for all successors of a state, as
+        // returned by the service 'children' of the domain, whose value is
+        // parent_h: write in values the value of every successor. The
+        // locations of all of them are prefetched before gathering any value
+        // (see pdb::lookup), and they are written in indices so that its
+        // memory can be reused between calls
+        void value (const std::vector<std::tuple<pdbval_t, T>>& successors, const pdbval_t parent_h,
+                    std::vector<pdboff_t>& indices, std::vector<pdbval_t>& values) const {
+            pdb<node_t<T>>::lookup (successors, indices, values);
+            if (get_encoding () == pdb_encoding::mod3) {
+                for (auto& value : values) {
+                    value = decode (value, parent_h);
+                }
+            }
+        }
+
+        // return the value of a state given the code stored at its location,
+        // and the value of an adjacent state, parent_h. With values encoded
+        // modulo 3, it is the only one which differs at most in one unit from
+        // parent_h and has the remainder stored. Otherwise, the code is the
+        // value and parent_h is ignored
+        pdbval_t decode (const pdbval_t code, const pdbval_t parent_h) const {
+            if (get_encoding () != pdb_encoding::mod3) {
+                return code;
+            }
+            return pdbval_t (parent_h + (code + 4 - parent_h % 3) % 3 - 1);
+        }
+
+        // return the value of the given permutation. With values encoded
+        // modulo 3, it is recovered descending from the permutation to the
+        // abstract goal through adjacent abstract states whose value
+        // decreases in one unit, so that the value is the number of steps.
+        // Thus, it should be used only with the start state of a search, and
+        // 'value' with the value of the parent with all its descendants. In
+        // case the descent gets stuck, an exception is raised
+        pdbval_t value (const std::vector<int>& perm) const {
+
+            const pdb_t<node_t<T>>& ipdb = *pdb<node_t<T>>::_pdb;
+            if (get_encoding () != pdb_encoding::mod3) {
+                return ipdb.at (ipdb.rank (perm));
+            }
+            const pdboff_t goal = ipdb.rank (ipdb.mask (pdb<node_t<T>>::_goal));
+            std::vector<int> current = ipdb.mask (perm);
+            std::vector<std::tuple<pdbval_t, T>> successors;
+            pdbval_t h = 0;
+            for (pdboff_t address = ipdb.rank (current) ; address != goal ; h++) {
+
+                // move to any child whose value is one unit less
+                const pdbval_t code = pdbval_t ((ipdb[address] + 2) % 3);
+                successors.clear ();
+                T (current).children (successors);
+                auto next = std::find_if (successors.begin (), successors.end (),
+                                          [&] (const std::tuple<pdbval_t, T>& successor) {
+                                              return ipdb[ipdb.rank (std::get<1> (successor).get_perm ())] == code;
+                                          });
+                if (next == successors.end () || h == std::numeric_limits<pdbval_t>::max ()) {
+                    throw std::runtime_error (" [inpdb::value] The value of the permutation can not be recovered");
+                }
+                current = std::get<1> (*next).get_perm ();
+                address = ipdb.rank (current);
+            }
+            return h;
+        }
+
+        // return true if the values of dual states are admissible
+        // heuristics in the domain (see pdb_dual)
+        static bool dual_admissible () {
+            if constexpr (pdb_dual<T>) {
+                return T::dual_admissible ();
+            } else {
+                return false;
+            }
+        }
+
+        // return the value of the dual state of the given full permutation
+        // (see pdb_t::dual). It is an admissible heuristic of the
+        // permutation only if the domain says so (see pdb_dual), e.g., the
+        // unit variant of the N-Pancake but not its heavy-cost variant, and
+        // an exception is thrown otherwise. With values encoded modulo 3,
+        // dual states of adjacent states are not adjacent, and thus the
+        // value is recovered descending to the abstract goal (see 'value')
+        pdbval_t dual_value (const std::vector<int>& perm) const {
+            if (!dual_admissible ()) {
+                throw std::invalid_argument (" [inpdb::dual_value] Dual lookups are not admissible in this domain");
+            }
+            if (get_encoding () == pdb_encoding::mod3) {
+                return value (pdb<node_t<T>>::dual (perm));
+            }
+            std::vector<int> inverse, dual;
+            pdb<node_t<T>>::invert (perm, inverse, dual);
+            return pdb<node_t<T>>::at_inverse (dual);
+        }
+
+        // return the maximum of the values of the given full permutation and
+        // its dual state, under the same conditions of 'dual_value'. The
+        // locations of the symbols in both are computed in the same pass
+        pdbval_t max_dual (const std::vector<int>& perm) const {
+            if (!dual_admissible ()) {
+                throw std::invalid_argument (" [inpdb::max_dual] Dual lookups are not admissible in this domain");
+            }
+            if (get_encoding () == pdb_encoding::mod3) {
+                return std::max (value (perm), value (pdb<node_t<T>>::dual (perm)));
+            }
+            std::vector<int> inverse, dual;
+            pdb<node_t<T>>::invert (perm, inverse, dual);
+            return std::max (pdb<node_t<T>>::at_inverse (inverse), pdb<node_t<T>>::at_inverse (dual));
+        }
+
         // return a string representing the current error
         std::string get_in_error_message () const {
-            std::string output;
-            switch (_in_error) {
-                case in_error_message::no_error:
-                    output = "No error";
-                    break;
-                case in_error_message::file_does_not_exist:
-                    output = "File does not exist";
-                    break;
-                case in_error_message::non_regular_file:
-                    output = "Non regular file";
-                    break;
-                case in_error_message::file_could_not_be_opened:
-                    output = "File could not be opened";
-                    break;
-                case in_error_message::size_could_not_be_determined:
-                    output = "Size could not be determined";
-                    break;
-                case in_error_message::pdb_mode_could_not_be_read:
-                    output = "PDB mode could not be read";
-                    break;
-                case in_error_message::pdb_length_could_not_be_read:
-                    output = "Length could not be read";
-                    break;
-                case in_error_message::pdb_goal_could_not_be_read:
-                    output = "The goal could not be read";
-                    break;
-                case in_error_message::pdb_ppattern_could_not_be_read:
-                    output = "The ppattern could not be read";
-                    break;
-                case in_error_message::pdb_cpattern_could_not_be_read:
-                    output = "The ppattern could not be read";
-                    break;
-                case in_error_message::pdb_incorrect_size:
-                    output = "Incorrect size";
-                    break;
-                case in_error_message::pdb_g_values_could_not_be_read:
-                    output = "g-values could not be read";
-                    break;
-            }
-            return output;
+            return to_string (_in_error);
         }
 
     }; // class inpdb<node_t<T>>
@@ -0,0 +1,217 @@
+// -*- coding: utf-8 -*-
+// PDBinpdbs.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 22:14:36.508913274 (1792361676)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Loading several PDBs concurrently
+//
+
+#ifndef _PDBINPDBS_H_
+#define _PDBINPDBS_H_
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<filesystem>
+#include<memory>
+#include<thread>
+#include<tuple>
+#include<vector>
+
+#include "PDBinpdb.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class inpdbs;
+
+    // Class definition
+    //
+    // inpdbs load a collection of PDBs, e.g., those used by a heuristic
+    // which combines several of them, simultaneously. Every PDB is loaded
+    // and verified by the same thread, so that the verification of one PDB
+    // overlaps with the I/O of the others, and the total time is close to
+    // the time of the largest one instead of the sum of all of them.
+    //
+    // Every PDB is accessible as an inpdb once loaded, and it records its
+    // own error, if any, and its own throughput.
+    template<typename T>
+    requires pdb_type<T>
+    class inpdbs<node_t<T>> {
+
+    private:
+
+        // INVARIANT: inpdbs keep one inpdb per file, in the same order given
+        // in the constructor
+        std::vector<std::unique_ptr<inpdb<node_t<T>>>> _pdbs;
+
+        // they also record the wall time spent loading all PDBs, and the
+        // total number of bytes read
+        std::chrono::duration<double, std::milli> _elapsed_time;
+        size_t _nbbytes;
+
+        // load all PDBs with the given function which takes an inpdb and
+        // returns its address space, or zero if it could not be loaded. PDBs
+        // are distributed among the given number of threads, or one per PDB
+        // if nbthreads is zero. If check is true, every PDB is verified right
+        // after being loaded. It returns true if all PDBs were successfully
+        // loaded (and verified) and false otherwise
+        template<typename LoadF>
+        bool _load (LoadF load, int nbthreads, const bool check) {
+
+            if (nbthreads <= 0 || nbthreads > int (_pdbs.size ())) {
+                nbthreads = int (_pdbs.size ());
+            }
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::atomic<size_t> next = 0;
+            std::atomic<bool> failed = false;
+            auto worker = [&] () {
+                size_t idx;
+                while ((idx = next.fetch_add (1)) < _pdbs.size ()) {
+                    if (!load (*_pdbs[idx]) || (check && !_pdbs[idx]->verify ())) {
+                        failed = true;
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (auto id = 1 ; id < nbthreads ; id++) {
+                threads.push_back (std::thread (worker));
+            }
+            if (nbthreads > 0) {
+                worker ();
+            }
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+
+            _nbbytes = 0;
+            for (const auto& ipdb : _pdbs) {
+                _nbbytes += ipdb->get_nbbytes ();
+            }
+            return !failed;
+        }
+
+    public:
+
+        // Default constructors are forbidden
+        inpdbs () = delete;
+
+        // Explicit constructor ---the paths to the files with the PDBs have to
+        // be provided. No PDB is loaded until either 'read' or 'map' is used
+        inpdbs (const std::vector<std::filesystem::path>& paths) :
+            _elapsed_time { 0 },
+            _nbbytes      { 0 }
+            {
+                for (const auto& path : paths) {
+                    _pdbs.push_back (std::make_unique<inpdb<node_t<T>>> (path));
+                }
+            }
+
+        // getters
+        size_t size () const {
+            return _pdbs.size ();
+        }
+        const std::chrono::duration<double, std::milli> get_elapsed_time () const {
+            return _elapsed_time;
+        }
+        const size_t get_nbbytes () const {
+            return _nbbytes;
+        }
+
+        // return the aggregated throughput of the last load, in MB/s, i.e.,
+        // the number of bytes read from all files over the wall time spent
+        // loading and verifying them. If no data has been read yet, zero is
+        // returned
+        double get_throughput () const {
+            return (_elapsed_time.count () > 0) ? (1e-3 * _nbbytes / _elapsed_time.count ()) : 0.0;
+        }
+
+        // operator overloading
+
+        // return the i-th PDB, in the same order given in the constructor
+        inpdb<node_t<T>>& operator[] (const size_t i) {
+            return *_pdbs[i];
+        }
+        const inpdb<node_t<T>>& operator[] (const size_t i) const {
+            return *_pdbs[i];
+        }
+
+        // methods
+
+        // read all PDBs simultaneously with the given number of threads, or
+        // one per PDB if nbthreads is zero, and return true if all of them
+        // were successfully read and false otherwise. If check is true,
+        // every PDB is also verified (see inpdb::verify). The error of every
+        // PDB is available in its own inpdb
+        bool read (const int nbthreads = 0, const bool check = true) {
+            return _load ([] (inpdb<node_t<T>>& ipdb) {
+                return ipdb.read ();
+            }, nbthreads, check);
+        }
+
+        // batched lookup of all successors of a state in all PDBs, as
+        // returned by the service 'children' of the domain: write in
+        // values[i] the codes stored in the i-th PDB for every successor (see
+        // inpdb::decode). The locations of all successors in all PDBs are
+        // prefetched before gathering any value, so that their cache misses
+        // overlap. They are written in indices[i], so that their memory can
+        // be reused between calls
+        void lookup (const std::vector<std::tuple<pdbval_t, T>>& successors,
+                     std::vector<std::vector<pdboff_t>>& indices,
+                     std::vector<std::vector<pdbval_t>>& values) const {
+            indices.resize (_pdbs.size ());
+            values.resize (_pdbs.size ());
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                _pdbs[i]->prefetch (successors, indices[i]);
+            }
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                _pdbs[i]->gather (indices[i], values[i]);
+            }
+        }
+
+        // batched version of inpdb::value for all successors of a state in
+        // all PDBs, where parent_h[i] is the value of the state in the i-th
+        // PDB: write in values[i] the value of every successor in the i-th
+        // PDB. See 'lookup'
+        void value (const std::vector<std::tuple<pdbval_t, T>>& successors,
+                    const std::vector<pdbval_t>& parent_h,
+                    std::vector<std::vector<pdboff_t>>& indices,
+                    std::vector<std::vector<pdbval_t>>& values) const {
+            lookup (successors, indices, values);
+            for (size_t i = 0 ; i < _pdbs.size () ; i++) {
+                for (auto& value : values[i]) {
+                    value = _pdbs[i]->decode (value, parent_h[i]);
+                }
+            }
+        }
+
+        // map all PDBs simultaneously with the given number of threads, or one
+        // per PDB if nbthreads is zero, and return true if all of them were
+        // successfully mapped and false otherwise. The advice, prefault and
+        // lock are given to every PDB (see inpdb::map). If check is true,
+        // every PDB is also verified, so that all its pages are read
+        bool map (const int nbthreads = 0, const bool check = true,
+                  const pdb_advice advice = pdb_advice::random,
+                  const bool prefault = false, const bool lock = false) {
+            return _load ([&] (inpdb<node_t<T>>& ipdb) {
+                return ipdb.map (advice, prefault, lock);
+            }, nbthreads, check);
+        }
+
+    }; // class inpdbs<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBINPDBS_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
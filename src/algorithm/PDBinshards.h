@@ -0,0 +1,421 @@
+// -*- coding: utf-8 -*-
+// PDBinshards.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 20:06:53.281947120 (1792354013)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Reading PDBs stored in shards
+//
+
+#ifndef _PDBINSHARDS_H_
+#define _PDBINSHARDS_H_
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<filesystem>
+#include<fstream>
+#include<memory>
+#include<mutex>
+#include<stdexcept>
+#include<thread>
+
+#include "PDBpdb.h"
+#include "../structs/PDBheader_t.h"
+#include "../structs/PDBindex_t.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class inshards;
+
+    // Class definition
+    //
+    // inshards read PDBs split into shards (see index_t) using nodes of any
+    // type provided that they satisfy the type constraint pdb_type, e.g.,
+    // npancakes. Shards can be either read all at once by several threads
+    // ('read'), or loaded on demand ('open') so that only those storing the
+    // locations being accessed are ever read from disk and kept in memory
+    template<typename T>
+    requires pdb_type<T>
+    class inshards<node_t<T>> : public pdb<node_t<T>> {
+
+    private:
+
+        // INVARIANT: inshards are described by the index found in a file
+        // whose path is recorded separately. Shards are stored in the same
+        // PDB at the locations given in the index. Because memory is
+        // committed only when first written, shards which are not loaded
+        // take no physical memory
+        std::filesystem::path _path;
+        index_t _index;
+
+        // and read as many values as the size of the abstract state
+        pdboff_t _address_space;
+
+        // type of error generated while reading the PDB from the filesystem
+        in_error_message _in_error;
+
+        // every shard is loaded only once, even if it is accessed
+        // simultaneously by several threads. The header of every shard is
+        // kept to verify its contents
+        std::unique_ptr<std::atomic<bool>[]> _loaded;
+        std::unique_ptr<std::mutex[]> _locks;
+        std::unique_ptr<header_t[]> _headers;
+        mutable std::atomic<pdboff_t> _nbloaded;
+
+        // inshards also record the time spent reading all shards, and the
+        // number of bytes read
+        std::chrono::duration<double, std::milli> _elapsed_time;
+        mutable std::atomic<size_t> _nbbytes;
+
+        // load the given shard, unless it was loaded before, and return true
+        // if it was successfully loaded and false otherwise. In case of
+        // error, it is written in in_error. It is thread-safe
+        bool _load (const pdboff_t shard, in_error_message& in_error) const {
+
+            if (_loaded[shard].load (std::memory_order_acquire)) {
+                return true;
+            }
+            std::lock_guard<std::mutex> lock (_locks[shard]);
+            if (_loaded[shard].load (std::memory_order_relaxed)) {
+                return true;
+            }
+
+            // open the shard at end to get its size
+            std::ifstream pdbfile (index_t::shard_path (_path, shard), std::ios::binary | std::ios::ate);
+            if (!pdbfile) {
+                in_error = in_error_message::file_could_not_be_opened;
+                return false;
+            }
+            std::streamsize pdbsize = pdbfile.tellg();
+            if (pdbsize < 0) {
+                in_error = in_error_message::size_could_not_be_determined;
+                return false;
+            }
+            pdbfile.seekg(0, std::ios::beg);
+
+            // read its header and verify it is consistent with the index.
+            // Shards always store one value per byte and they are never
+            // compressed
+            header_t& header = _headers[shard];
+            if (!header.deserialize (pdbfile, pdbsize, in_error)) {
+                return false;
+            }
+            if (header.get_encoding () != pdb_encoding::byte ||
+                header.get_compression () != pdb_compression::none) {
+                in_error = in_error_message::pdb_format_not_supported;
+                return false;
+            }
+            if (header.get_mode () != _index.get_mode () ||
+                header.get_goal () != _index.get_goal () ||
+                header.get_ppattern () != _index.get_ppattern () ||
+                header.get_cpattern () != _index.get_cpattern () ||
+                header.get_address_space () != _index.get_count (shard)) {
+                in_error = in_error_message::pdb_shard_mismatch;
+                return false;
+            }
+            pdbfile.seekg(header.get_offset (), std::ios::beg);
+
+            // and stream its g-values directly into their locations of the
+            // PDB in large chunks
+            auto storage = pdb<node_t<T>>::_pdb->get_storage ().subspan (_index.get_first (shard),
+                                                                        _index.get_count (shard));
+            char* address = reinterpret_cast<char*>(storage.data ());
+            size_t nbbytes = storage.size ();
+            for (size_t done = 0 ; done < nbbytes ; ) {
+                size_t chunk = std::min (read_chunk_bytes, nbbytes - done);
+                if (!pdbfile.read(address + done, std::streamsize (chunk))) {
+                    in_error = in_error_message::pdb_g_values_could_not_be_read;
+                    return false;
+                }
+                done += chunk;
+            }
+            _nbbytes += nbbytes;
+            _nbloaded++;
+            _loaded[shard].store (true, std::memory_order_release);
+
+            return true;
+        }
+
+        // load the shard storing the given location, unless it was loaded
+        // before. If it can not be loaded, an exception is raised
+        void _fetch (const pdboff_t location) const {
+
+            in_error_message in_error = in_error_message::no_error;
+            pdboff_t shard = _index.get_shard (location);
+            if (!_load (shard, in_error)) {
+                throw std::runtime_error (" [inshards] Shard " + std::to_string (shard) +
+                                          " could not be loaded: " + to_string (in_error));
+            }
+        }
+
+    public:
+
+        // Default constructors are forbidden
+        inshards () = delete;
+
+        // Explicit constructor ---the path to the index of the PDB has to be
+        // provided
+        inshards (const std::filesystem::path path) :
+            pdb<node_t<T>>(pdb_mode::max, std::vector<int>(), "", ""),
+            _path          {                      path },
+            _address_space {                         0 },
+            _in_error      { in_error_message::no_error},
+            _nbloaded      {                         0 },
+            _elapsed_time  {                         0 },
+            _nbbytes       {                         0 }
+            {}
+
+        // g-values are read from files in chunks of this size, which is a
+        // multiple of the page size
+        static constexpr size_t read_chunk_bytes = 8 * 1024 * 1024;
+
+        // getters
+        const std::filesystem::path& get_path () const {
+            return _path;
+        }
+        const index_t& get_index () const {
+            return _index;
+        }
+        pdboff_t get_address_space () const {
+            return _address_space;
+        }
+        const in_error_message get_in_error () const {
+            return _in_error;
+        }
+        const pdb_format get_format () const {
+            return pdb_format::v2;
+        }
+        const pdb_encoding get_encoding () const {
+            return pdb_encoding::byte;
+        }
+        const pdb_compression get_compression () const {
+            return pdb_compression::none;
+        }
+        pdboff_t get_nbshards () const {
+            return _index.get_nbshards ();
+        }
+        pdboff_t get_nbloaded () const {
+            return _nbloaded;
+        }
+        const std::chrono::duration<double, std::milli> get_elapsed_time () const {
+            return _elapsed_time;
+        }
+        const size_t get_nbbytes () const {
+            return _nbbytes;
+        }
+
+        // return the throughput of the last read, in MB/s. If no data has
+        // been read yet, zero is returned
+        double get_throughput () const {
+            return (_elapsed_time.count () > 0) ? (1e-3 * _nbbytes / _elapsed_time.count ()) : 0.0;
+        }
+
+        // return true if the given shard has been already loaded
+        bool is_loaded (const pdboff_t shard) const {
+            return _loaded[shard].load (std::memory_order_acquire);
+        }
+
+        // operator overloading
+
+        // Given a correct index to the address space in this PDB, return the
+        // value at its location, loading its shard if necessary. In case the
+        // index is out of bounds, the behaviour is undefined. In case the
+        // shard can not be loaded, an exception is raised
+        pdbval_t operator[] (const pdboff_t index) const {
+            _fetch (index);
+            return (*pdb<node_t<T>>::_pdb)[index];
+        }
+
+        // get the value corresponding to the given permutation as a vector
+        // of integers, loading its shard if necessary. Make sure to invoke
+        // this service only after using either 'open' or 'read'. In case the
+        // shard can not be loaded, an exception is raised
+        const pdbval_t operator[] (const std::vector<int>& perm) const {
+
+            pdboff_t index = pdb<node_t<T>>::_pdb->rank (perm);
+            _fetch (index);
+            return pdb<node_t<T>>::_pdb->at (index);
+        }
+
+        // methods
+
+        // return the value of the given permutation, loading its shard if
+        // necessary. Because shards always store one value per byte, the
+        // value of the parent, if given, is ignored (see inpdb::value)
+        pdbval_t value (const std::vector<int>& perm) const {
+            return (*this)[perm];
+        }
+        pdbval_t value (const std::vector<int>& perm, const pdbval_t parent_h) const {
+            return (*this)[perm];
+        }
+
+        // return the size of the abstract state of this PDB. Call this method
+        // only after using either 'open' or 'read'. Otherwise, the results
+        // are undefined.
+        pdboff_t address_space () const {
+            return _address_space;
+        }
+
+        // read the index found in the path used for constructing this
+        // instance and prepare the PDB to load its shards on demand. No shard
+        // is read. It returns the size of the abstract space or zero if any
+        // error happened
+        pdboff_t open () {
+
+            if (!std::filesystem::exists(_path)) {
+                _in_error = in_error_message::file_does_not_exist;
+                return pdboff_t (0);
+            }
+            std::ifstream pdbfile (_path, std::ios::binary);
+            if (!pdbfile) {
+                _in_error = in_error_message::file_could_not_be_opened;
+                return pdboff_t (0);
+            }
+            if (!_index.deserialize (pdbfile, _in_error)) {
+                return pdboff_t (0);
+            }
+
+            // copy the description of the PDB and verify the address space is
+            // consistent with the p-pattern
+            pdb<node_t<T>>::_mode = _index.get_mode ();
+            pdb<node_t<T>>::_goal = _index.get_goal ();
+            pdb<node_t<T>>::_p_pattern = _index.get_ppattern ();
+            pdb<node_t<T>>::_c_pattern = _index.get_cpattern ();
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            if (pspace != _index.get_address_space ()) {
+                _in_error = in_error_message::pdb_incorrect_size;
+                return pdboff_t (0);
+            }
+
+            // initialize the PDB with room for all shards
+            if (pdb<node_t<T>>::_pdb != nullptr) {
+                delete pdb<node_t<T>>::_pdb;
+            }
+            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>));
+            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pspace);
+            pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+            // and the status of all shards
+            const pdboff_t nbshards = _index.get_nbshards ();
+            _loaded = std::make_unique<std::atomic<bool>[]> (nbshards);
+            _locks = std::make_unique<std::mutex[]> (nbshards);
+            _headers = std::make_unique<header_t[]> (nbshards);
+            for (pdboff_t shard = 0 ; shard < nbshards ; shard++) {
+                _loaded[shard] = false;
+            }
+            _nbloaded = 0;
+            _nbbytes = 0;
+
+            // set the size of the abstract state of this PDB
+            _address_space = pspace;
+            return pspace;
+        }
+
+        // load the given shard, unless it was loaded before, and return true
+        // if it is available and false otherwise. It can be used to make a
+        // selection of shards resident before accessing them. If the shard
+        // does not exist, an exception is raised
+        bool load (const pdboff_t shard) {
+
+            if (shard >= _index.get_nbshards ()) {
+                throw std::out_of_range (" [inshards::load] Shard out of bounds");
+            }
+            return _load (shard, _in_error);
+        }
+
+        // read the index and all shards found in the path used for
+        // constructing this instance and return the size of its abstract space
+        // or zero if any error happened. Shards are distributed among the
+        // given number of threads, which read them simultaneously. At most
+        // one thread per shard is used, which is also the number of threads
+        // if nbthreads is not positive
+        pdboff_t read (int nbthreads = 1) {
+
+            pdboff_t pspace = open ();
+            if (!pspace) {
+                return pdboff_t (0);
+            }
+
+            // every thread records the first error it finds
+            auto start = std::chrono::high_resolution_clock::now();
+            const pdboff_t nbshards = _index.get_nbshards ();
+            if (nbthreads <= 0 || pdboff_t (nbthreads) > nbshards) {
+                nbthreads = int (std::max (nbshards, pdboff_t (1)));
+            }
+            std::vector<in_error_message> errors (nbthreads, in_error_message::no_error);
+            std::atomic<pdboff_t> next = 0;
+            std::atomic<bool> failed = false;
+            auto worker = [&] (const int id) {
+                pdboff_t shard;
+                while (!failed && (shard = next.fetch_add (1)) < nbshards) {
+                    if (!_load (shard, errors[id])) {
+                        failed = true;
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (auto id = 1 ; id < nbthreads ; id++) {
+                threads.push_back (std::thread (worker, id));
+            }
+            worker (0);
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+
+            if (failed) {
+                _in_error = *std::find_if (errors.begin (), errors.end (),
+                                           [] (const in_error_message error) {
+                                               return error != in_error_message::no_error;
+                                           });
+                return pdboff_t (0);
+            }
+            return pspace;
+        }
+
+        // verify the integrity of the values of all shards loaded so far,
+        // and return true if they are correct and false otherwise. The
+        // checksum of every block of data and the histogram of values are
+        // computed with the given number of threads and compared with those
+        // stored in the header of every shard
+        bool verify (const int nbthreads = 1) {
+
+            auto values = pdb<node_t<T>>::_pdb->get_address ();
+            for (pdboff_t shard = 0 ; shard < _index.get_nbshards () ; shard++) {
+                if (!is_loaded (shard)) {
+                    continue;
+                }
+                std::vector<pdboff_t> histogram;
+                std::vector<uint32_t> checksums;
+                _headers[shard].summarize (values.subspan (_index.get_first (shard), _index.get_count (shard)),
+                                           histogram, checksums, nbthreads);
+                if (checksums != _headers[shard].get_checksums () ||
+                    histogram != _headers[shard].get_histogram ()) {
+                    _in_error = in_error_message::pdb_checksum_mismatch;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // return a string representing the current error
+        std::string get_in_error_message () const {
+            return to_string (_in_error);
+        }
+
+    }; // class inshards<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBINSHARDS_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
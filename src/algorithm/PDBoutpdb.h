@@ -13,14 +13,31 @@
 #ifndef _PDBOUTPDB_H_
 #define _PDBOUTPDB_H_
 
+#include<atomic>
 #include<cstdint>
+#include<cstring>
+#include<exception>
 #include<filesystem>
 #include<fstream>
+#include<future>
 #include<iomanip>
 #include<limits>
+#include<span>
+#include<thread>
+
+#include<pthread.h>
+#include<signal.h>
+#include<sys/wait.h>
+#include<unistd.h>
 
 #include "PDBpdb.h"
 #include "../gui/PDBprogress_t.h"
+#include "../structs/PDBgraph_t.h"
+#include "../structs/PDBheader_t.h"
+#include "../structs/PDBindex_t.h"
+#include "../structs/PDBradix_t.h"
+#include "../structs/PDBring_t.h"
+#include "../utils/PDBcodec.h"
 
 namespace pdb {
 
@@ -57,18 +74,31 @@ namespace pdb {
         std::chrono::duration<double, std::milli> _elapsed_time;
         size_t _nbexpansions;
 
+        // PDBs can be generated directly in the file they are written to. If
+        // so, its path is recorded here, and whether the PDB has been already
+        // finished in place, so that its values are not valid anymore
+        std::filesystem::path _backing;
+        bool _finished;
+
+    public:
+
+        // PDBs are written in chunks of this size, which is a multiple of the
+        // size of the blocks of v2 files
+        static constexpr size_t write_chunk_bytes = 4 * header_t::default_block_size;
+
     private:
 
-        // write the binary data given as a vector of uint8_t at the end of the
-        // ofstream out and return true if the operation was feasible and false
-        // otherwise
-        bool _write (std::ofstream& out, std::vector<uint8_t> data) {
+        // write the binary data given as a sequence of uint8_t at the end of
+        // the ofstream out and return true if the operation was feasible and
+        // false otherwise
+        bool _write (std::ofstream& out, std::span<const uint8_t> data) {
 
             out.write(reinterpret_cast<const char*>(data.data ()),
                       static_cast<std::streamsize>(data.size()));
             if (!out) {
                 return false;
             }
+
             return true;
         }
 
@@ -97,6 +127,764 @@ namespace pdb {
             }
         }
 
+        // return the header of files with format v1, which consists of:
+        // 1. The pdb mode (_mode): MAX or ADD
+        std::vector<uint8_t> _header_v1 () {
+
+            std::vector<uint8_t> header;
+            if (pdb<node_t<T>>::_mode == pdb_mode::max) {
+                header = std::vector<uint8_t> {'M', 'A', 'X'};
+            } else {
+                header = std::vector<uint8_t> {'A', 'D', 'D'};
+            }
+
+            // 2. The length of the goal (_n): which has to be equal to the
+            //    length of both patterns
+            header.push_back (uint8_t (pdb<node_t<T>>::_pdb->get_n ()));
+
+            // 3. The goal (_goal): consists of a explicit definition of the
+            //    goal state in the true state space
+            std::vector<uint8_t> goal;
+            _int_to_binary (pdb<node_t<T>>::_goal, goal);
+            header.insert (header.end (), goal.begin (), goal.end ());
+
+            // 3. The ppattern (_p_pattern): used to generate this PDB
+            std::vector<uint8_t> ppattern;
+            _sv_to_binary (pdb<node_t<T>>::_p_pattern, ppattern);
+            header.insert (header.end (), ppattern.begin (), ppattern.end ());
+
+            // 4. The cpattern (_c_pattern): used to determine the abstract
+            //    space to traverse to generate the PDB
+            std::vector<uint8_t> cpattern;
+            _sv_to_binary (pdb<node_t<T>>::_c_pattern, cpattern);
+            header.insert (header.end (), cpattern.begin (), cpattern.end ());
+
+            return header;
+        }
+
+        // return the header of files with format v2, padded up to the offset
+        // of the values, which are stored with the same encoding of the PDB.
+        // The values must have been already decremented, and their histogram
+        // and checksums are computed with the given number of threads
+        std::vector<uint8_t> _header_v2 (const int nbthreads) {
+
+            header_t header (pdb<node_t<T>>::_mode, pdb<node_t<T>>::_goal,
+                             pdb<node_t<T>>::_p_pattern, pdb<node_t<T>>::_c_pattern,
+                             pdb<node_t<T>>::_pdb->capacity (), header_t::default_block_size,
+                             pdb<node_t<T>>::_pdb->get_encoding ());
+            header.summarize (pdb<node_t<T>>::_pdb->get_address (), nbthreads);
+            return header.serialize ();
+        }
+
+        // return the encoding used to store values up to the given bound
+        // while generating PDBs, i.e., bytes if it fits in them, and words
+        // otherwise. Values encoded in twelve bits are never used because
+        // they can not be updated concurrently
+        static pdb_encoding _width (const pdboff_t bound) {
+            return (bound <= encoding_max (pdb_encoding::byte)) ? pdb_encoding::byte : pdb_encoding::word;
+        }
+
+        // return the encoding used to store the values of the closed list and
+        // the PDB while generating it. If the domain bounds the cost of every
+        // state (see pdb_bounded), the bound is used. Otherwise, all values
+        // are assumed to fit in one byte. Note that values are incremented in
+        // one unit during the generation
+        pdb_encoding _width () const {
+            if constexpr (pdb_bounded<T>) {
+                return _width (pdboff_t (T::cost_bound (pdb<node_t<T>>::_goal)) + 1);
+            }
+            return pdb_encoding::byte;
+        }
+
+        // return the cost charged to the operator which generated the given
+        // child, whose cost as given by the domain is cost. In PDBs of type
+        // pdb_mode::add, only the operators owned by symbols preserved by the
+        // p-pattern of ppdb are charged (see pdb_additive), and all the others
+        // are free. Otherwise, the cost is fully charged
+        pdbval_t _charge (const pdb_t<node_t<T>>& ppdb, const T& child, const pdbval_t cost) const {
+            if constexpr (pdb_additive<T>) {
+                if (pdb<node_t<T>>::_mode == pdb_mode::add && !ppdb.preserves (child.get_owner ())) {
+                    return 0;
+                }
+            }
+            return cost;
+        }
+
+        // create the PDB used to store the minimum cost of every abstract
+        // state with pspace locations and the given encoding, and initialize
+        // it. The PDB previously generated, if any, is released first. If a
+        // backing file was given with 'map', the PDB is stored in a shared
+        // mapping of it, right after the space reserved for a header with
+        // format v2. Otherwise, it is stored in anonymous memory with the
+        // pages and placement given with 'place'. If the file can not be
+        // created, an exception is raised
+        void _allocate (const pdboff_t pspace, const pdb_encoding encoding) {
+
+            delete pdb<node_t<T>>::_pdb;
+            pdb<node_t<T>>::_pdb = nullptr;
+            _finished = false;
+
+            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>));
+            if (_backing.empty ()) {
+                pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pspace, encoding,
+                                                                        pdb<node_t<T>>::_pages,
+                                                                        pdb<node_t<T>>::_placement);
+            } else {
+                header_t header (pdb<node_t<T>>::_mode, pdb<node_t<T>>::_goal,
+                                 pdb<node_t<T>>::_p_pattern, pdb<node_t<T>>::_c_pattern,
+                                 pspace, header_t::default_block_size, encoding);
+                region_t region;
+                if (!region.create (_backing, header.get_offset (), encoding_bytes (encoding, pspace))) {
+                    ::operator delete (_pdb_raw);
+                    throw std::runtime_error (" [outpdb] The PDB could not be mapped to " + _backing.string ());
+                }
+                pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (std::move (region), encoding, pspace);
+            }
+            pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+        }
+
+        // copy the PDB just generated to every NUMA node if it was requested
+        // with 'place', unless it is stored in its backing file, because its
+        // values are later modified in place when writing it
+        void _place () {
+            if (_backing.empty ()) {
+                pdb<node_t<T>>::_replicate ();
+            }
+        }
+
+        // finish writing a PDB generated in its backing file: values are
+        // decremented in place, and the header is written at the beginning
+        // of the file. Finally, all changes are flushed to disk. It returns
+        // true if the operation was successful and false otherwise. In any
+        // case, the PDB is recorded as finished, as its values have been
+        // modified
+        bool _write_in_place (const int nbthreads) {
+
+            _finished = true;
+            auto storage = pdb<node_t<T>>::_pdb->get_storage ();
+            const pdb_encoding encoding = pdb<node_t<T>>::_pdb->get_encoding ();
+            if (encoding == pdb_encoding::byte) {
+                for (auto& value : storage) {
+                    value--;
+                }
+            } else {
+                for (pdboff_t i = 0 ; i < pdb<node_t<T>>::_pdb->capacity () ; i++) {
+                    encoding_set (storage.data (), i, pdbval_t (encoding_get (storage.data (), i, encoding) - 1), encoding);
+                }
+            }
+
+            // the space reserved for the header precedes the region mapped,
+            // so that it is written with a separate stream
+            std::fstream out (_backing, std::ios::binary | std::ios::in | std::ios::out);
+            if (!out.is_open()) {
+                return false;
+            }
+            auto header = _header_v2 (nbthreads);
+            out.write (reinterpret_cast<const char*>(header.data ()), std::streamsize (header.size ()));
+            out.close ();
+            if (!out) {
+                return false;
+            }
+            return pdb<node_t<T>>::_pdb->sync ();
+        }
+
+        // pack the given number of values into bytes with the given encoding
+        // and return the number of bytes they take. Unused bits of the last
+        // byte are zeroed
+        static size_t _pack (const pdbval_t* values, const size_t length, const pdb_encoding encoding,
+                             uint8_t* bytes) {
+
+            const size_t nbbytes = encoding_bytes (encoding, length);
+            std::fill (bytes, bytes + nbbytes, 0);
+            for (size_t i = 0 ; i < length ; i++) {
+                encoding_set (bytes, i, (encoding == pdb_encoding::mod3) ? pdbval_t (values[i] % 3) : values[i], encoding);
+            }
+            return nbbytes;
+        }
+
+        // compress every block of the given bytes with block_size bytes
+        // each using the given number of threads, and return all of them
+        // one after the other. The size of every compressed block is added
+        // to the last offset in index
+        static std::vector<uint8_t> _compress (std::span<const uint8_t> data, const size_t block_size,
+                                               const int nbthreads, std::vector<pdboff_t>& index) {
+
+            const size_t nbblocks = (data.size () + block_size - 1) / block_size;
+            std::vector<std::vector<uint8_t>> blocks (nbblocks);
+            auto worker = [&] (const size_t id, const size_t nbworkers) {
+                for (size_t block = id ; block < nbblocks ; block += nbworkers) {
+                    size_t start = block * block_size;
+                    blocks[block] = block_compress (data.data () + start, std::min (block_size, data.size () - start));
+                }
+            };
+            const size_t nbworkers = std::max (size_t (1), std::min (size_t (std::max (nbthreads, 1)), nbblocks));
+            std::vector<std::thread> threads;
+            for (size_t id = 1 ; id < nbworkers ; id++) {
+                threads.push_back (std::thread (worker, id, nbworkers));
+            }
+            worker (0, nbworkers);
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+
+            std::vector<uint8_t> compressed;
+            for (const auto& block : blocks) {
+                compressed.insert (compressed.end (), block.begin (), block.end ());
+                index.push_back (index.back () + block.size ());
+            }
+            return compressed;
+        }
+
+        // write count values of the PDB starting at location first,
+        // decremented in one unit and stored with the given encoding, at the
+        // end of the ofstream out, and return true if the operation was
+        // feasible and false otherwise. If a header is given, values are
+        // accounted for in it as they are written, relative to first. The PDB
+        // is not modified.
+        //
+        // If an index is given, every block of the header is compressed with
+        // the given number of threads before being written, and the end of
+        // every compressed block is added to the index, which must contain
+        // at least the offset of the first one
+        bool _write_values (std::ofstream& out, header_t* header,
+                            const pdboff_t first, const pdboff_t count,
+                            const pdb_encoding encoding = pdb_encoding::byte,
+                            std::vector<pdboff_t>* index = nullptr, const int nbthreads = 1) {
+
+            // values are decremented in chunks copied to one of two staging
+            // buffers, so that one can be prepared while the other is being
+            // written in the background. Chunks take an even number of
+            // values, so that every one starts at a byte boundary
+            const pdb_t<node_t<T>>& ppdb = *pdb<node_t<T>>::_pdb;
+            const bool bytes = ppdb.get_encoding () == pdb_encoding::byte && encoding == pdb_encoding::byte;
+            const uint8_t* address = ppdb.get_address ().data () + (bytes ? first : 0);
+            const size_t chunk = write_chunk_bytes;
+            std::vector<pdbval_t> values (bytes ? 0 : std::min (pdboff_t (chunk), count));
+            std::vector<uint8_t> staging[2] = {std::vector<uint8_t> (encoding_bytes (encoding, std::min (pdboff_t (chunk), count))),
+                                               std::vector<uint8_t> (encoding_bytes (encoding, std::min (pdboff_t (chunk), count)))};
+            std::vector<uint8_t> compressed[2];
+            std::future<bool> pending;
+
+            for (pdboff_t start = 0, k = 0 ; start < count ; start += chunk, k++) {
+
+                // decrement the values of this chunk, and pack them if
+                // requested. If the values are stored in bytes both in the PDB
+                // and the file, the first loop is simple enough to be
+                // vectorized by the compiler
+                size_t length = std::min (pdboff_t (chunk), count - start);
+                uint8_t* buffer = staging[k % 2].data ();
+                if (bytes) {
+                    for (size_t i = 0 ; i < length ; i++) {
+                        buffer[i] = uint8_t (address[start + i] - 1);
+                    }
+                } else {
+                    for (size_t i = 0 ; i < length ; i++) {
+                        values[i] = pdbval_t (ppdb[first + start + i] - 1);
+                    }
+                    length = _pack (values.data (), length, encoding, buffer);
+                }
+                if (header != nullptr) {
+                    header->add (std::span<const uint8_t> (buffer, length), start);
+                }
+
+                // wait for the previous chunk to be written, and write this
+                // one in the background, compressed if requested
+                if (pending.valid () && !pending.get ()) {
+                    return false;
+                }
+                std::span<const uint8_t> data (buffer, length);
+                if (index != nullptr) {
+                    compressed[k % 2] = _compress (data, header->get_block_size (), nbthreads, *index);
+                    data = std::span<const uint8_t> (compressed[k % 2]);
+                }
+                pending = std::async (std::launch::async, [this, &out, data] {
+                    return _write (out, data);
+                });
+            }
+
+            return !pending.valid () || pending.get ();
+        }
+
+        // Parallel version of 'generate'. Because all operators have a strictly
+        // positive cost, all nodes in the bucket with the minimum g-value have
+        // their optimal g-value, and they can be expanded simultaneously. The
+        // bucket is split among nbthreads threads which update both the closed
+        // list and the PDB with atomic min-updates, and then all children are
+        // inserted in the open list before proceeding with the next bucket.
+        // Operators with a null cost are supported as well, since their
+        // children are processed in the same bucket before moving forward.
+        //
+        // Because the domain is accessed concurrently, the services required
+        // by pdb_type must be thread-safe
+        template<template<typename> class OpenT>
+        void _generate_parallel (bool console, const int nbthreads) {
+
+            // start the chrono
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // create and initialize the PDBs used for searching (_c_pattern)
+            // and also to store the minimum cost (_p_pattern) exactly as in
+            // 'generate'
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            const pdb_encoding width = _width ();
+            _allocate (pspace, width);
+
+            pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
+            pdb_t<node_t<T>> cpdb (cspace, width);
+            cpdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_c_pattern);
+
+            // seed the open list with the abstract goal and g=1
+            std::vector<int> agoal = cpdb.mask (pdb<node_t<T>>::_goal);
+            OpenT<node_t<T>> open;
+            open.insert (node_t (T (agoal), 1));
+
+            progress_t progress_bar (cspace);
+            progress_bar.set_prefix (" Generating PDB ");
+
+            // children generated by each thread, and the first error found by
+            // any of them
+            std::vector<std::vector<node_t<T>>> children (nbthreads);
+            std::exception_ptr error = nullptr;
+            std::atomic<bool> failed = false;
+            std::atomic<size_t> nbexpansions = 0;
+
+            while (open.size () > 0) {
+
+                // extract all nodes with the minimum g-value
+                pdbval_t g = open.get_mini ();
+                std::vector<node_t<T>> bucket;
+                while (open.size () > 0 && open.get_mini () == g) {
+                    bucket.push_back (open.pop_front ());
+                }
+
+                // and expand them in parallel. Nodes are distributed in chunks
+                // among the threads
+                std::atomic<size_t> next = 0;
+                const size_t chunk = std::max (size_t (1), bucket.size () / (16*nbthreads));
+                auto worker = [&] (const int id) {
+                    try {
+                        size_t first;
+                        while (!failed && (first = next.fetch_add (chunk)) < bucket.size ()) {
+                            for (auto i = first ; i < std::min (first + chunk, bucket.size ()) ; i++) {
+                                const node_t<T>& node = bucket[i];
+
+                                // in case this node has been expanded before by
+                                // any thread, then skip it
+                                if (!cpdb.update (cpdb.rank (node.get_state ().get_perm ()), g)) {
+                                    continue;
+                                }
+
+                                // annotate the minimum g-value in the PDB
+                                std::vector<int> pperm = pdb<node_t<T>>::_pdb->mask (node.get_state ().get_perm ());
+                                pdb<node_t<T>>::_pdb->update (pdb<node_t<T>>::_pdb->rank (pperm), g);
+
+                                // expand it
+                                nbexpansions++;
+                                std::vector<std::tuple<pdbval_t, T>> successors;
+                                T state = node.get_state ();
+                                state.children (successors);
+                                for (auto const& isuccessor : successors) {
+                                    auto [cost, ichild] = isuccessor;
+
+                                    // skip children expanded before
+                                    if (cpdb.load (cpdb.rank (ichild.get_perm ())) != pdbzero) {
+                                        continue;
+                                    }
+                                    cost = _charge (*pdb<node_t<T>>::_pdb, ichild, cost);
+
+                                    // ensure the g-value of the child does not
+                                    // exceed the max value of the encoding
+                                    if (encoding_max (width) - g < cost) {
+                                        throw std::runtime_error (" [outpdb.generate] g(child) out of range");
+                                    }
+                                    children[id].push_back (node_t (ichild, pdbval_t (g + cost)));
+                                }
+                            }
+                        }
+                    } catch (...) {
+
+                        // register only the first error found
+                        if (!failed.exchange (true)) {
+                            error = std::current_exception ();
+                        }
+                    }
+                };
+
+                std::vector<std::thread> threads;
+                for (auto id = 1 ; id < nbthreads ; id++) {
+                    threads.push_back (std::thread (worker, id));
+                }
+                worker (0);
+                for (auto& thread : threads) {
+                    thread.join ();
+                }
+
+                // in case any error happened, rethrow it
+                if (failed) {
+                    std::rethrow_exception (error);
+                }
+
+                // insert all children in the open list
+                for (auto& ichildren : children) {
+                    for (const auto& child : ichildren) {
+                        open.insert (child);
+                    }
+                    ichildren.clear ();
+                }
+
+                if (console) {
+                    progress_bar.set_value (cpdb.size ());
+                    progress_bar.show ();
+                }
+            }
+            _nbexpansions += nbexpansions;
+
+            // copy the PDB to every NUMA node, if requested
+            _place ();
+
+            // stop the chrono and register the elapsed time
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+        }
+
+        // State shared by all worker processes of '_generate_processes'. It
+        // lives in anonymous memory shared with them, followed by two arrays
+        // with nbworkers entries each: the minimum g-value of the open list
+        // of every worker (see _minis) and the number of expansions of every
+        // worker (see _expansions)
+        struct _control_t {
+
+            // workers proceed in rounds synchronized with this barrier
+            pthread_barrier_t barrier;
+
+            // the first worker failing records here the reason
+            std::atomic<bool> failed;
+            char message[256];
+        };
+
+        // return the array with the minimum g-value of the open list of every
+        // worker in the given round. Rounds alternate between two arrays so
+        // that workers can publish their values for the next round while
+        // others are still reading the current one. Workers with an empty
+        // open list publish _no_mini
+        static uint32_t* _minis (_control_t* control, const int nbworkers, const pdboff_t round) {
+            return reinterpret_cast<uint32_t*> (reinterpret_cast<uint8_t*> (control) + sizeof (_control_t)) +
+                (round % 2) * nbworkers;
+        }
+        static constexpr uint32_t _no_mini = uint32_t (std::numeric_limits<pdbval_t>::max ()) + 1;
+
+        // return the array with the number of expansions of every worker
+        static std::atomic<pdboff_t>* _expansions (_control_t* control, const int nbworkers) {
+            size_t offset = sizeof (_control_t) + 2 * nbworkers * sizeof (uint32_t);
+            offset = (offset + alignof (std::atomic<pdboff_t>) - 1) / alignof (std::atomic<pdboff_t>) *
+                alignof (std::atomic<pdboff_t>);
+            return reinterpret_cast<std::atomic<pdboff_t>*> (reinterpret_cast<uint8_t*> (control) + offset);
+        }
+
+        // return the number of bytes of the state shared by nbworkers
+        static size_t _control_bytes (const int nbworkers) {
+            return sizeof (_control_t) + 2 * nbworkers * sizeof (uint32_t) +
+                alignof (std::atomic<pdboff_t>) + nbworkers * sizeof (std::atomic<pdboff_t>);
+        }
+
+        // return the path of the file used by worker from to send ranks to
+        // worker to, and the file where a worker stores its values
+        static std::filesystem::path _frontier_path (const std::filesystem::path& workdir, const int from, const int to) {
+            return workdir / ("frontier." + std::to_string (from) + "." + std::to_string (to));
+        }
+        static std::filesystem::path _values_path (const std::filesystem::path& workdir, const int id) {
+            return workdir / ("values." + std::to_string (id));
+        }
+
+        // body of the id-th out of nbworkers worker processes used in
+        // '_generate_processes'. Every worker owns a contiguous slice of the
+        // ranks of the abstract state space induced by the c-pattern, i.e.,
+        // it keeps the closed list of those abstract states only, and it is
+        // the only one expanding them. The search proceeds in rounds: in
+        // every round all workers agree on the minimum g-value of all their
+        // open lists, and they expand all their nodes with that g-value.
+        // Children owned by other workers are sent to them through files in
+        // workdir as their rank and g-value, and they are inserted in their
+        // open lists at the end of the round. The minimum cost of every
+        // abstract state induced by the p-pattern found by this worker is
+        // written to a file in workdir with the given encoding. In case of
+        // error, an exception is raised
+        template<template<typename> class OpenT>
+        void _worker (const int id, const int nbworkers, _control_t* control,
+                      const std::filesystem::path& workdir, const pdb_encoding width) {
+
+            // create the ranking function of the abstract state space
+            // induced by the c-pattern and compute the slice of this worker
+            pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
+            pdb_t<node_t<T>> cpdb (pdboff_t (0));
+            cpdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_c_pattern);
+            const pdboff_t slice = (cspace + nbworkers - 1) / nbworkers;
+            const pdboff_t first = id * slice;
+            pdb_t<node_t<T>> closed ((first < cspace) ? std::min (slice, cspace - first) : 0, width);
+
+            // the minimum cost of every abstract state induced by the
+            // p-pattern is written directly to a file
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            region_t region;
+            if (!region.create (_values_path (workdir, id), 0, encoding_bytes (width, pspace))) {
+                throw std::runtime_error (" [outpdb.generate] The values of a worker could not be created");
+            }
+            pdb_t<node_t<T>> ppdb (std::move (region), width, pspace);
+            ppdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+            // only the owner of the abstract goal seeds its open list
+            std::vector<int> agoal = cpdb.mask (pdb<node_t<T>>::_goal);
+            OpenT<node_t<T>> open;
+            if (cpdb.rank (agoal) / slice == pdboff_t (id)) {
+                open.insert (node_t (T (agoal), 1));
+            }
+
+            // ranks and g-values sent to every other worker are packed in
+            // the same integer
+            std::vector<std::vector<uint64_t>> outbox (nbworkers);
+            std::atomic<pdboff_t>& nbexpansions = _expansions (control, nbworkers)[id];
+
+            for (pdboff_t round = 0 ; ; round++) {
+
+                // agree on the minimum g-value of all open lists
+                _minis (control, nbworkers, round)[id] = (open.size () > 0) ? open.get_mini () : _no_mini;
+                pthread_barrier_wait (&control->barrier);
+                uint32_t mini = _no_mini;
+                for (auto i = 0 ; i < nbworkers ; i++) {
+                    mini = std::min (mini, _minis (control, nbworkers, round)[i]);
+                }
+                if (mini == _no_mini) {
+                    break;
+                }
+
+                // and expand all nodes with that g-value
+                pdbval_t g = pdbval_t (mini);
+                while (open.size () > 0 && open.get_mini () == g) {
+                    node_t<T> node = open.pop_front ();
+
+                    // skip nodes expanded before, and annotate their g-value
+                    // otherwise
+                    const pdboff_t entry = cpdb.rank (node.get_state ().get_perm ()) - first;
+                    if (closed[entry] != pdbzero) {
+                        continue;
+                    }
+                    closed.insert (entry, g);
+                    std::vector<int> pperm = ppdb.mask (node.get_state ().get_perm ());
+                    ppdb.update (ppdb.rank (pperm), g);
+
+                    // expand it
+                    nbexpansions++;
+                    std::vector<std::tuple<pdbval_t, T>> successors;
+                    T state = node.get_state ();
+                    state.children (successors);
+                    for (auto const& isuccessor : successors) {
+                        auto [cost, ichild] = isuccessor;
+                        cost = _charge (ppdb, ichild, cost);
+                        if (encoding_max (width) - g < cost) {
+                            throw std::runtime_error (" [outpdb.generate] g(child) out of range");
+                        }
+
+                        // children owned by this worker are inserted in open
+                        // unless they were expanded before, and the others
+                        // are sent to their owner
+                        pdboff_t rank = cpdb.rank (ichild.get_perm ());
+                        pdboff_t owner = rank / slice;
+                        if (owner == pdboff_t (id)) {
+                            if (closed[rank - first] == pdbzero) {
+                                open.insert (node_t (ichild, pdbval_t (g + cost)));
+                            }
+                        } else {
+                            outbox[owner].push_back ((rank << 16) | uint64_t (g + cost));
+                        }
+                    }
+                }
+
+                // send children to their owners
+                for (auto to = 0 ; to < nbworkers ; to++) {
+                    if (to == id) {
+                        continue;
+                    }
+                    std::ofstream out (_frontier_path (workdir, id, to), std::ios::binary | std::ios::trunc);
+                    out.write (reinterpret_cast<const char*> (outbox[to].data ()),
+                               std::streamsize (outbox[to].size () * sizeof (uint64_t)));
+                    if (!out) {
+                        throw std::runtime_error (" [outpdb.generate] The frontier could not be written");
+                    }
+                    outbox[to].clear ();
+                }
+                pthread_barrier_wait (&control->barrier);
+
+                // and receive the children sent by others
+                for (auto from = 0 ; from < nbworkers ; from++) {
+                    if (from == id) {
+                        continue;
+                    }
+                    std::ifstream in (_frontier_path (workdir, from, id), std::ios::binary | std::ios::ate);
+                    std::vector<uint64_t> inbox (size_t (in.tellg ()) / sizeof (uint64_t));
+                    in.seekg (0, std::ios::beg);
+                    if (!in.read (reinterpret_cast<char*> (inbox.data ()),
+                                  std::streamsize (inbox.size () * sizeof (uint64_t)))) {
+                        throw std::runtime_error (" [outpdb.generate] The frontier could not be read");
+                    }
+                    for (auto item : inbox) {
+                        pdboff_t rank = item >> 16;
+                        if (closed[rank - first] == pdbzero) {
+                            open.insert (node_t (T (cpdb.unrank (rank)), pdbval_t (item & 0xffff)));
+                        }
+                    }
+                }
+            }
+
+            // make sure all values are written to the file
+            if (!ppdb.sync ()) {
+                throw std::runtime_error (" [outpdb.generate] The values of a worker could not be written");
+            }
+        }
+
+        // Multi-process version of 'generate'. The abstract state space
+        // induced by the c-pattern is partitioned among nbworkers processes
+        // created with fork, each one owning a contiguous slice of its ranks
+        // (see '_worker'). Workers only share a small control block used to
+        // synchronize them, and they exchange their frontiers through files
+        // in a private directory created in workdir. Once all of them have
+        // finished, their values are merged into the PDB, which is then
+        // exactly the same computed by 'generate'.
+        //
+        // Because workers are processes, the failure of any of them does not
+        // affect the others, which are immediately killed, and an exception
+        // is raised. Also, every worker can be limited separately, e.g.,
+        // with cgroups
+        template<template<typename> class OpenT>
+        void _generate_processes (bool console, int nbworkers, const std::filesystem::path& workdir) {
+
+            // start the chrono
+            auto start = std::chrono::high_resolution_clock::now();
+
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            const pdb_encoding width = _width ();
+            _allocate (pspace, width);
+            pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
+            nbworkers = int (std::min (pdboff_t (nbworkers), cspace));
+
+            // create a private directory for the files of the workers
+            std::filesystem::path tmpdir = workdir / ("pdb-workers." + std::to_string (getpid ()) + "." +
+                                                      std::to_string (std::chrono::steady_clock::now ().time_since_epoch ().count ()));
+            std::filesystem::create_directories (tmpdir);
+
+            // and the control block shared with them
+            region_t shared;
+            shared.allocate (_control_bytes (nbworkers), true);
+            _control_t* control = new (shared.data ()) _control_t;
+            pthread_barrierattr_t attr;
+            pthread_barrierattr_init (&attr);
+            pthread_barrierattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+            pthread_barrier_init (&control->barrier, &attr, nbworkers);
+            pthread_barrierattr_destroy (&attr);
+            control->failed = false;
+            std::atomic<pdboff_t>* expansions = _expansions (control, nbworkers);
+            for (auto id = 0 ; id < nbworkers ; id++) {
+                new (&expansions[id]) std::atomic<pdboff_t> (0);
+            }
+
+            // kill all workers still alive
+            std::vector<pid_t> pids;
+            auto kill_all = [&] () {
+                for (auto pid : pids) {
+                    if (pid > 0) {
+                        kill (pid, SIGKILL);
+                        waitpid (pid, nullptr, 0);
+                    }
+                }
+            };
+
+            // create the workers. They never return from this block
+            for (auto id = 0 ; id < nbworkers ; id++) {
+                pid_t pid = fork ();
+                if (pid < 0) {
+                    kill_all ();
+                    std::filesystem::remove_all (tmpdir);
+                    throw std::runtime_error (" [outpdb.generate] The workers could not be created");
+                }
+                if (pid == 0) {
+                    int status = EXIT_SUCCESS;
+                    try {
+                        _worker<OpenT> (id, nbworkers, control, tmpdir, width);
+                    } catch (const std::exception& e) {
+                        if (!control->failed.exchange (true)) {
+                            std::strncpy (control->message, e.what (), sizeof (control->message) - 1);
+                        }
+                        status = EXIT_FAILURE;
+                    }
+                    _exit (status);
+                }
+                pids.push_back (pid);
+            }
+
+            // wait for all workers to finish, showing the progress of the
+            // search if requested. If any fails, the rest are killed
+            progress_t progress_bar (cspace);
+            progress_bar.set_prefix (" Generating PDB ");
+            bool failed = false;
+            for (auto alive = nbworkers ; alive > 0 && !failed ; ) {
+                int status;
+                pid_t pid = waitpid (-1, &status, console ? WNOHANG : 0);
+                if (pid == 0) {
+                    pdboff_t nbexpansions = 0;
+                    for (auto id = 0 ; id < nbworkers ; id++) {
+                        nbexpansions += expansions[id];
+                    }
+                    progress_bar.set_value (nbexpansions);
+                    progress_bar.show ();
+                    std::this_thread::sleep_for (std::chrono::milliseconds (100));
+                    continue;
+                }
+                if (pid < 0) {
+                    failed = true;
+                    break;
+                }
+                alive--;
+                *std::find (pids.begin (), pids.end (), pid) = 0;
+                failed = !WIFEXITED (status) || WEXITSTATUS (status) != EXIT_SUCCESS;
+            }
+            // the barrier is destroyed only if all workers finished
+            // normally: workers killed while waiting at the barrier never
+            // leave it, and destroying it would block forever
+            if (failed) {
+                kill_all ();
+            } else {
+                pthread_barrier_destroy (&control->barrier);
+            }
+            if (failed) {
+                std::string message = control->failed ? control->message : "A worker was terminated";
+                std::filesystem::remove_all (tmpdir);
+                throw std::runtime_error (" [outpdb.generate] " + message);
+            }
+
+            // merge the values found by all workers, keeping the minimum one
+            for (auto id = 0 ; id < nbworkers ; id++) {
+                region_t region;
+                if (!region.map (_values_path (tmpdir, id), 0, encoding_bytes (width, pspace), pdb_advice::sequential)) {
+                    std::filesystem::remove_all (tmpdir);
+                    throw std::runtime_error (" [outpdb.generate] The values of a worker could not be read");
+                }
+                const pdb_t<node_t<T>> values (std::move (region), width, pspace);
+                for (pdboff_t address = 0 ; address < pspace ; address++) {
+                    if (values[address] != pdbzero) {
+                        pdb<node_t<T>>::_pdb->update (address, values[address]);
+                    }
+                }
+                _nbexpansions += expansions[id];
+            }
+            std::filesystem::remove_all (tmpdir);
+
+            // copy the PDB to every NUMA node, if requested
+            _place ();
+
+            // stop the chrono and register the elapsed time
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+        }
+
     public:
 
         // Default constructors are forbidden
@@ -104,14 +892,21 @@ namespace pdb {
 
         // Explicit constructor ---it is mandatory to provide the pdb mode, the
         // goal and both patterns, those used for generating the pattern
-        // (p_pattern) and also the one used to search (c_pattern)
+        // (p_pattern) and also the one used to search (c_pattern). PDBs of
+        // type pdb_mode::add can only be generated for domains which support
+        // them (see pdb_additive), and an exception is raised otherwise
         outpdb (pdb_mode mode,
                 const std::vector<int>& goal,
                 const std::string cpattern,
                 const std::string ppattern) :
             pdb<node_t<T>>(mode, goal, cpattern, ppattern),
-            _nbexpansions              {                       0 }
-            { }
+            _nbexpansions              {                       0 },
+            _finished                  {                   false }
+            {
+                if (mode == pdb_mode::add && !pdb_additive<T>) {
+                    throw std::invalid_argument (" [outpdb] The domain does not support additive PDBs");
+                }
+            }
 
         // getters
         const std::chrono::duration<double, std::milli> get_elapsed_time () const {
@@ -120,9 +915,35 @@ namespace pdb {
         const size_t get_nbexpansions () const {
             return _nbexpansions;
         }
+        const std::filesystem::path& get_backing () const {
+            return _backing;
+        }
+        const bool get_finished () const {
+            return _finished;
+        }
+
+        // return the encoding of the values of the PDB while it is being
+        // generated, which is also used to finish it in place
+        const pdb_encoding get_encoding () const {
+            return (pdb<node_t<T>>::_pdb == nullptr) ? pdb_encoding::byte : pdb<node_t<T>>::_pdb->get_encoding ();
+        }
 
         // methods
 
+        // request subsequent generations to store the PDB directly in a
+        // shared mapping of the file found at the given path, which is
+        // created (or truncated) when the generation starts. Once the PDB has
+        // been generated, writing it to the same path with format v2 just
+        // decrements its values in place, writes the header and flushes all
+        // changes, so that no copy of the PDB is ever made.
+        //
+        // Finishing the PDB in place consumes it: its values are not valid
+        // anymore, and thus it can not be verified or written again until it
+        // is generated again (see 'write')
+        void map (const std::filesystem::path& path) {
+            _backing = path;
+        }
+
         // generate a PDB with the minimum cost to reach the goal defined in
         // this instance from every abstract state as given in the ppatern used
         // to create this instance. The resulting PDB is internallly stored. To
@@ -133,12 +954,41 @@ namespace pdb {
         // entries in the state space induced by cpattern that are mapped to the
         // same abstract state in the state space induced by ppatern.
         //
-        // If the cost of an abstract state exceeds the range of pdbval_t, then
-        // a runtime_error is immediately raised
+        // PDBs of type pdb_mode::add charge only the operators owned by
+        // symbols preserved by the ppattern, and all other operators are
+        // free. Because every operator is owned by one symbol at most (see
+        // pdb_additive), the values of PDBs whose ppatterns preserve disjoint
+        // sets of symbols can be added. Free moves are inserted in the bucket
+        // being expanded, which all open lists support, so that the search
+        // becomes a 0-1 BFS with unit costs.
+        //
+        // Values are stored in bytes unless the domain bounds the cost of its
+        // states beyond their range (see pdb_bounded), in which case they are
+        // stored in words. If the cost of an abstract state exceeds the range
+        // of the values, then a runtime_error is immediately raised
         //
         // In case console takes the value true, a progress bar is shown on the
         // standard output
-        void generate (bool console=false) {
+        //
+        // If more than one thread is requested, all nodes with the same
+        // g-value are expanded in parallel, see '_generate_parallel'
+        //
+        // The open list used is given by OpenT, which has to provide the
+        // services insert, pop_front, size and get_mini of open_t. Because
+        // all operators have a non-negative cost, monotone open lists such as
+        // ring_t or radix_t can be used as well
+        template<template<typename> class OpenT = open_t>
+        void generate (bool console=false, const int nbthreads=1) {
+
+            // every generation starts from scratch
+            _nbexpansions = 0;
+
+            // in case more than one thread was requested, use the parallel
+            // engine
+            if (nbthreads > 1) {
+                _generate_parallel<OpenT> (console, nbthreads);
+                return;
+            }
 
             // start the chrono
             auto start = std::chrono::high_resolution_clock::now();
@@ -148,13 +998,15 @@ namespace pdb {
             // initialization of both PDBs is done wrt the same goal
             // description. Note that the goal description should be explicit,
             // i.e., no state should be abstracted
+            //
+            // Both are stored with the same encoding, which is selected from
+            // the bound given by the domain, if any (see _width)
             pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
-            auto _pdb_raw = ::operator new (sizeof (pdb_t<node_t<T>>(pspace)));
-            pdb<node_t<T>>::_pdb = new (_pdb_raw) pdb_t<node_t<T>> (pspace);
-            pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+            const pdb_encoding width = _width ();
+            _allocate (pspace, width);
 
             pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
-            pdb_t<node_t<T>> cpdb (cspace);
+            pdb_t<node_t<T>> cpdb (cspace, width);
             cpdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_c_pattern);
 
             // next, abstract the goal state. The _c_pattern is used here, since
@@ -164,7 +1016,7 @@ namespace pdb {
             // and seed the open list with this abstract state and g=1. The
             // g-value of all annotations in a PDB are incremented in one unit
             // to be distinguished with pdbzero (which is zero)
-            open_t<node_t<T>> open;
+            OpenT<node_t<T>> open;
             open.insert (node_t (T (agoal), 1));
 
             // Also, create a progress bar to be displayed in case console
@@ -247,8 +1099,9 @@ namespace pdb {
                     }
 
                     // before continuing ensure that the g-value of the child
-                    // does not exceed the max value of pdbval_t
-                    if (std::numeric_limits<pdbval_t>::max() - node.get_g () < g) {
+                    // does not exceed the max value of the encoding
+                    g = _charge (*pdb<node_t<T>>::_pdb, ichild, g);
+                    if (encoding_max (width) - node.get_g () < g) {
                         throw std::runtime_error (" [outpdb.generate] g(child) out of range");
                     }
 
@@ -257,6 +1110,234 @@ namespace pdb {
                 }
             }
 
+            // copy the PDB to every NUMA node, if requested
+            _place ();
+
+            // stop the chrono and register the elapsed time
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+        }
+
+        // generate the PDB exactly as 'generate' does but with nbworkers
+        // cooperating processes, each one owning a contiguous slice of the
+        // abstract state space induced by the c-pattern. Workers exchange
+        // their frontiers through files created in a private directory in
+        // workdir, which is removed at the end. The failure of any worker
+        // does not affect the calling process: all workers are killed and an
+        // exception is raised instead. See '_generate_processes'.
+        //
+        // In case console takes the value true, a progress bar is shown on the
+        // standard output
+        template<template<typename> class OpenT = open_t>
+        void generate_workers (const int nbworkers, bool console=false,
+                               const std::filesystem::path& workdir = std::filesystem::temp_directory_path ()) {
+
+            if (nbworkers < 1) {
+                throw std::invalid_argument (" [outpdb.generate_workers] The number of workers must be strictly positive");
+            }
+            _nbexpansions = 0;
+            _generate_processes<OpenT> (console, nbworkers, workdir);
+        }
+
+        // compute the abstract state graph induced by the c-pattern and store
+        // it in graph. The graph consists of all abstract states reachable
+        // from the abstract goal, and the cost class of every edge is the cost
+        // returned by the domain. If the domain supports additive PDBs (see
+        // pdb_additive), every edge also records whether it is charged in
+        // them. Once the graph is available, the PDB can be
+        // regenerated for different cost models with 'generate (graph)'
+        // without invoking the services of the domain again.
+        //
+        // In case console takes the value true, a progress bar is shown on the
+        // standard output
+        void generate_graph (graph_t& graph, bool console=false) {
+
+            // start the chrono
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // create the PDBs used to rank abstract states in the state spaces
+            // induced by both the c-pattern and the p-pattern. The former is
+            // used also as a closed list, and thus it is the only one which is
+            // allocated
+            pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
+            if (cspace > std::numeric_limits<uint32_t>::max ()) {
+                throw std::invalid_argument (" [outpdb.generate_graph] Graphs can not have more than 2^32 nodes");
+            }
+            pdb_t<node_t<T>> cpdb (cspace);
+            cpdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_c_pattern);
+            pdb_t<node_t<T>> ppdb (0);
+            ppdb.init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+            // abstract the goal state and use it as the source of the graph
+            std::vector<int> agoal = cpdb.mask (pdb<node_t<T>>::_goal);
+            graph.init (pdb<node_t<T>>::_goal,
+                        pdb<node_t<T>>::_c_pattern, pdb<node_t<T>>::_p_pattern,
+                        cspace, cpdb.rank (agoal));
+
+            // the graph is traversed in breadth-first order. Abstract states
+            // are inserted in the closed list (with an arbitrary g-value) as
+            // soon as they are generated
+            std::vector<T> queue {T (agoal)};
+            cpdb.insert (node_t<T> (queue.back (), 1));
+
+            progress_t progress_bar (cspace);
+            progress_bar.set_prefix (" Generating graph ");
+
+            std::vector<std::tuple<uint32_t, uint32_t, pdbval_t>> edges;
+            std::vector<uint8_t> charged;
+            std::vector<uint32_t> pranks (cspace, 0);
+            for (size_t i = 0 ; i < queue.size () ; i++) {
+
+                if (console) {
+                    progress_bar.set_value (i);
+                    progress_bar.show ();
+                }
+
+                // rank this state in both abstract state spaces
+                auto from = cpdb.rank (queue[i].get_perm ());
+                pranks[from] = ppdb.rank (ppdb.mask (queue[i].get_perm ()));
+
+                // and expand it
+                std::vector<std::tuple<pdbval_t, T>> successors;
+                queue[i].children (successors);
+                for (auto const& isuccessor : successors) {
+                    auto [g, ichild] = isuccessor;
+
+                    // add an edge to this child labeled with its cost, and
+                    // record whether it is charged in additive PDBs
+                    auto to = cpdb.rank (ichild.get_perm ());
+                    edges.push_back ({uint32_t (from), uint32_t (to), g});
+                    if constexpr (pdb_additive<T>) {
+                        charged.push_back (ppdb.preserves (ichild.get_owner ()));
+                    }
+
+                    // and in case it has not been generated before, add it to
+                    // the queue
+                    if (cpdb[to] == pdbzero) {
+                        cpdb.insert (node_t<T> (ichild, 1));
+                        queue.push_back (ichild);
+                    }
+                }
+            }
+
+            // and compile all edges in the graph
+            graph.compile (edges, pranks, charged);
+
+            // stop the chrono and register the elapsed time
+            auto stop = std::chrono::high_resolution_clock::now();
+            _elapsed_time = stop - start;
+        }
+
+        // generate a PDB exactly as 'generate' does, but traversing the given
+        // graph instead of invoking the services of the domain. The cost of
+        // every edge is given by the cost model of the graph. The graph must
+        // have been generated with the same goal and patterns of this
+        // instance, otherwise an exception is raised. Additive PDBs also
+        // require the graph to record which edges are charged in them (see
+        // 'generate_graph'). The same instance can be regenerated for any
+        // number of cost models, and every generation replaces the PDB
+        // previously generated.
+        //
+        // Because the cost of all abstract states is known before creating
+        // the PDB, its values are stored in bytes if all of them fit in them,
+        // and in words otherwise. If the cost of an abstract state exceeds the
+        // range of pdbval_t, then a runtime_error is immediately raised
+        //
+        // In case console takes the value true, a progress bar is shown on the
+        // standard output
+        void generate (const graph_t& graph, bool console=false) {
+
+            // start the chrono
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // verify the graph is compatible with this PDB
+            if (graph.get_goal () != pdb<node_t<T>>::_goal ||
+                graph.get_cpattern () != pdb<node_t<T>>::_c_pattern ||
+                graph.get_ppattern () != pdb<node_t<T>>::_p_pattern) {
+                throw std::invalid_argument (" [outpdb.generate] The graph is not compatible with this PDB");
+            }
+            if (pdb<node_t<T>>::_mode == pdb_mode::add && graph.get_charged ().size () != graph.nbedges ()) {
+                throw std::invalid_argument (" [outpdb.generate] The graph can not be used to generate additive PDBs");
+            }
+            _nbexpansions = 0;
+
+            // the closed list stores the g-value of every node expanded,
+            // incremented in one unit as in 'generate'
+            const auto& offsets = graph.get_offsets ();
+            const auto& targets = graph.get_targets ();
+            const auto& classes = graph.get_classes ();
+            const auto& pranks = graph.get_pranks ();
+            const auto& charged = graph.get_charged ();
+            std::vector<pdbval_t> closed (graph.nbnodes (), pdbzero);
+
+            // the open list is a bucket of node identifiers indexed by their
+            // g-value, and it is seeded with the source and g=1
+            std::vector<std::vector<uint32_t>> open (2);
+            open[1].push_back (uint32_t (graph.get_source ()));
+            size_t nbitems = 1;
+
+            progress_t progress_bar (graph.nbnodes ());
+            progress_bar.set_prefix (" Generating PDB ");
+
+            size_t gmax = 1;
+            for (size_t g = 1 ; nbitems > 0 ; g++) {
+                while (open[g].size ()) {
+
+                    // take the next node with the minimum g-value
+                    auto node = open[g].back ();
+                    open[g].pop_back ();
+                    nbitems--;
+
+                    // skip it in case it has been expanded before
+                    if (closed[node] != pdbzero) {
+                        continue;
+                    }
+                    closed[node] = pdbval_t (g);
+                    gmax = g;
+                    if (console) {
+                        progress_bar.set_value (_nbexpansions);
+                        progress_bar.show ();
+                    }
+
+                    // and relax all its edges
+                    _nbexpansions++;
+                    for (auto i = offsets[node] ; i < offsets[1+node] ; i++) {
+                        if (closed[targets[i]] != pdbzero) {
+                            continue;
+                        }
+
+                        // ensure the g-value of the child does not exceed the
+                        // max value of pdbval_t
+                        auto cost = graph.get_cost (classes[i]);
+                        if (pdb<node_t<T>>::_mode == pdb_mode::add && !charged[i]) {
+                            cost = 0;
+                        }
+                        if (std::numeric_limits<pdbval_t>::max() - g < cost) {
+                            throw std::runtime_error (" [outpdb.generate] g(child) out of range");
+                        }
+                        if (open.size () <= g + cost) {
+                            open.resize (1 + g + cost);
+                        }
+                        open[g + cost].push_back (targets[i]);
+                        nbitems++;
+                    }
+                }
+            }
+
+            // create the PDB to store the minimum cost (_p_pattern) with the
+            // narrowest encoding for the largest g-value, and annotate the
+            // minimum g-value of all abstract states mapped to every location
+            pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
+            _allocate (pspace, _width (gmax));
+            for (pdboff_t node = 0 ; node < graph.nbnodes () ; node++) {
+                if (closed[node] != pdbzero) {
+                    pdb<node_t<T>>::_pdb->update (pranks[node], closed[node]);
+                }
+            }
+
+            // copy the PDB to every NUMA node, if requested
+            _place ();
+
             // stop the chrono and register the elapsed time
             auto stop = std::chrono::high_resolution_clock::now();
             _elapsed_time = stop - start;
@@ -268,50 +1349,61 @@ namespace pdb {
         //
         // 1. It checks there is only one entry with the value 1 (which because
         //    they are incremented, should correspond to the abstract goal
-        //    state, and there should be only one) (error nb_ones)
+        //    state, and there should be only one) (error nb_ones). In PDBs of
+        //    type pdb_mode::add, all abstract states reachable from the goal
+        //    with free moves have the value 1, and thus it is only checked
+        //    there is at least one
         //
         // 2. Verify there is no entry with the value pdbzero (error zero)
         //
         // 3. It also verifies that the number of nodes being expanded is equal
-        //    to the size of the abstract state space (error address_space)
+        //    to the size of the abstract state space traversed, i.e., the one
+        //    induced by the cpattern (error address_space)
         //
         // In case an error is diagnosed, _error is updated and
         // get_error_message can be used to get a string explaining the error
         // found. It reports only one error, if any, even if the PDB is
         // inconsistent in more than one regard.
         //
-        // IMPORTANT: Use 'doctor' before 'write'
+        // IMPORTANT: Use 'doctor' before 'write'. PDBs finished in place can
+        // not be verified, and an exception is raised
         bool doctor () {
 
+            if (_finished) {
+                throw std::invalid_argument (" [outpdb::doctor] This PDB has been already finished in place");
+            }
+
             // count the number of locations with a value equal to 1
-            int nbones = 0;
+            pdboff_t nbones = 0;
 
             // verify the number of expansions is equal to the size of the
-            // abstract state space
+            // abstract state space traversed
             pdboff_t pspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_p_pattern);
-            if (_nbexpansions != pspace) {
+            pdboff_t cspace = pdb_t<node_t<T>>::address_space (pdb<node_t<T>>::_c_pattern);
+            if (_nbexpansions != cspace) {
                 pdb<node_t<T>>::_error = error_message::address_space;
                 return false;
             }
 
-            // traverse the whole state space of the PDB generated
-            for (auto address = 0 ; address < pspace ; address++) {
+            // traverse the whole state space of the PDB generated. Values are
+            // accessed directly, as the address space has been verified to be
+            // the capacity of the PDB
+            const pdb_t<node_t<T>>& values = *pdb<node_t<T>>::_pdb;
+            for (pdboff_t address = 0 ; address < pspace ; address++) {
 
                 // check this position has a value other than pdbzero
-                if (pdb<node_t<T>>::_pdb->at (address) == pdbzero) {
+                if (values[address] == pdbzero) {
                     pdb<node_t<T>>::_error = error_message::zero;
                     return false;
                 }
 
                 // check whether this entry  has a value equal to 1
-                if (pdb<node_t<T>>::_pdb->at(address) == pdbval_t (1)) {
-                    nbones++;
-                }
+                nbones += (values[address] == pdbval_t (1));
             }
 
             // Before leaving, ensure there is only one location with a value
-            // equal to 1
-            if (nbones != 1) {
+            // equal to 1, or at least one with PDBs of type pdb_mode::add
+            if (nbones != 1 && (pdb<node_t<T>>::_mode != pdb_mode::add || nbones == 0)) {
                 pdb<node_t<T>>::_error = error_message::nb_ones;
                 return false;
             }
@@ -323,12 +1415,82 @@ namespace pdb {
 
         // return true if it was possiblle to write the contents of the
         // generated pdb into the specified file and false otherwise. The binary
-        // file is started with a header that contains the following info:
+        // file is started with a header whose contents depend on the format:
+        //
+        // v1: the header contains the following info:
+        //
+        //    1. pdb mode: either MAX or ADD
+        //    2. The goal given in explicit form
+        //    3. The pattern used to generate the abstract state space
+        //
+        // v2: the header is described in header_t. It additionally contains
+        //     the histogram of values and the checksum of every block of
+        //     values. Values start at an offset aligned to the page size
+        //
+        // Because the generation increments the g-value of the start state in
+        // one unit to distinguish empty locations from those with a g-value
+        // equal to zero (e.g., the abstract goal state), all values are
+        // decremented before being written. This is done in chunks copied to
+        // a staging buffer, so that the PDB is not modified and it can be
+        // used after being written. While a chunk is being written by a
+        // background thread, the next one is prepared.
+        //
+        // If the PDB was generated in a file with 'map' and it is written to
+        // the same file with format v2, it is finished in place instead, i.e.,
+        // its values are decremented in the PDB itself. In this case, the
+        // summary of the values is computed with the given number of threads.
+        // Writing it to the same file with any other format raises an
+        // exception, as the file would be truncated while being mapped.
+        // Finished PDBs are consumed, and writing them again to any file
+        // raises an exception as well
+        //
+        // Files with format v2 can store values with any encoding provided
+        // that all of them fit in it (see 'fits'), and otherwise an exception
+        // is raised. The narrowest encoding all values fit in is given by
+        // 'best_encoding'. Additive PDBs can not be encoded modulo 3. Files
+        // with format v1 can only store one value per byte, and PDBs finished
+        // in place can only be written with the
+        // encoding used to generate them (see 'get_encoding').
         //
-        // 1. pdb mode: either MAX or ADD
-        // 2. The goal given in explicit form
-        // 3. The pattern used to generate the abstract state space
-        bool write (const std::filesystem::path& path) {
+        // Files with format v2 can also store their values compressed in
+        // blocks of header_t::compressed_block_size bytes, which are
+        // compressed with the given number of threads. Files with format
+        // v1, and PDBs finished in place, can not be compressed, and an
+        // exception is raised otherwise
+        bool write (const std::filesystem::path& path,
+                    const pdb_format format = pdb_format::v2, const int nbthreads = 1,
+                    const pdb_encoding encoding = pdb_encoding::byte,
+                    const pdb_compression compression = pdb_compression::none) {
+
+            // PDBs generated in the same file are finished in place. Note that
+            // the file must not be opened for writing, as it would be truncated
+            if (_finished) {
+                throw std::invalid_argument (" [outpdb::write] This PDB has been already finished in place");
+            }
+            std::error_code ec;
+            const bool in_place = pdb<node_t<T>>::_pdb != nullptr && !_backing.empty () &&
+                std::filesystem::equivalent (path, _backing, ec);
+            if (in_place && format != pdb_format::v2) {
+                throw std::invalid_argument (" [outpdb::write] PDBs generated in their file can only be written to it with format v2");
+            }
+            if (compression != pdb_compression::none && (format == pdb_format::v1 || in_place)) {
+                throw std::invalid_argument (" [outpdb::write] This PDB can not be compressed");
+            }
+            if (in_place && encoding != get_encoding ()) {
+                throw std::invalid_argument (" [outpdb::write] This PDB can only be written with the encoding used to generate it");
+            }
+            if (format == pdb_format::v1 && encoding != pdb_encoding::byte) {
+                throw std::invalid_argument (" [outpdb::write] This PDB can only be written with byte encoding");
+            }
+            if (encoding == pdb_encoding::mod3 && pdb<node_t<T>>::_mode == pdb_mode::add) {
+                throw std::invalid_argument (" [outpdb::write] Additive PDBs can not be encoded modulo 3");
+            }
+            if (!in_place && !fits (encoding)) {
+                throw std::out_of_range (" [outpdb::write] The values of the PDB can not be written with the encoding");
+            }
+            if (in_place) {
+                return _write_in_place (nbthreads);
+            }
 
             // Try to open the file and if it is not possible, then return false
             std::ofstream out(path, std::ios::binary | std::ios::trunc);
@@ -337,60 +1499,218 @@ namespace pdb {
             }
 
             // Now write the binary data stored in the pdb in case there is any
-            if (pdb<node_t<T>>::_pdb != nullptr) {
+            if (pdb<node_t<T>>::_pdb == nullptr) {
+                return true;
+            }
 
-                // first, write the header which consists of:
-                // 1. The pdb mode (_mode): MAX or ADD
-                std::vector<uint8_t> header;
-                if (pdb<node_t<T>>::_mode == pdb_mode::max) {
-                    header = std::vector<uint8_t> {'M', 'A', 'X'};
-                } else {
-                    header = std::vector<uint8_t> {'A', 'D', 'D'};
+            // files with format v1 start with their header. The header of v2
+            // files is summarized as values are written, so that room is
+            // reserved for it and it is written at the end
+            if (format == pdb_format::v1) {
+                return _write (out, _header_v1 ()) &&
+                    _write_values (out, nullptr, 0, pdb<node_t<T>>::_pdb->capacity ());
+            }
+            header_t header (pdb<node_t<T>>::_mode, pdb<node_t<T>>::_goal,
+                             pdb<node_t<T>>::_p_pattern, pdb<node_t<T>>::_c_pattern,
+                             pdb<node_t<T>>::_pdb->capacity (),
+                             (compression == pdb_compression::none) ? header_t::default_block_size : header_t::compressed_block_size,
+                             encoding, compression);
+            if (compression == pdb_compression::none) {
+                if (!_write (out, std::vector<uint8_t> (header.get_offset (), 0)) ||
+                    !_write_values (out, &header, 0, pdb<node_t<T>>::_pdb->capacity (), encoding)) {
+                    return false;
                 }
+                out.seekp (0, std::ios::beg);
+                return _write (out, header.serialize ());
+            }
 
-                // 2. The length of the goal (_n): which has to be equal to the
-                //    length of both patterns
-                header.push_back (uint8_t (pdb<node_t<T>>::_pdb->get_n ()));
-
-                // 3. The goal (_goal): consists of a explicit definition of
-                //    the goal state in the true state space
-                std::vector<uint8_t> goal;
-                _int_to_binary (pdb<node_t<T>>::_goal, goal);
-                header.insert (header.end (), goal.begin (), goal.end ());
-
-                // 3. The ppattern (_p_pattern): used to generate this PDB
-                std::vector<uint8_t> ppattern;
-                _sv_to_binary (pdb<node_t<T>>::_p_pattern, ppattern);
-                header.insert (header.end (), ppattern.begin (), ppattern.end ());
+            // compressed values are preceded by the block index, which is
+            // known only once all blocks have been compressed
+            std::vector<pdboff_t> index {0};
+            if (!_write (out, std::vector<uint8_t> (header.get_offset () + header.get_index_bytes (), 0)) ||
+                !_write_values (out, &header, 0, pdb<node_t<T>>::_pdb->capacity (), encoding, &index, nbthreads)) {
+                return false;
+            }
+            out.seekp (0, std::ios::beg);
+            if (!_write (out, header.serialize ())) {
+                return false;
+            }
+            return _write (out, header_t::serialize_index (index));
+        }
 
-                // 4. The cpattern (_c_pattern): used to determine the abstract
-                //    space to traverse to generate the PDB
-                std::vector<uint8_t> cpattern;
-                _sv_to_binary (pdb<node_t<T>>::_c_pattern, cpattern);
-                header.insert (header.end (), cpattern.begin (), cpattern.end ());
+        // return true if all values of the generated PDB can be written with
+        // the given encoding and false otherwise. Values can be always
+        // encoded modulo 3, but they can be recovered only if the values of
+        // adjacent abstract states differ at most in one unit, which is
+        // verified expanding all abstract states of the p-pattern. Additive
+        // PDBs can never be encoded modulo 3, as their free moves leave
+        // abstract states without any neighbour one unit closer to the goal
+        bool fits (const pdb_encoding encoding) const {
 
-                // and write the header
-                if (!_write (out, header)) {
+            if (encoding == pdb_encoding::mod3 && pdb<node_t<T>>::_mode == pdb_mode::add) {
+                return false;
+            }
+            if (pdb<node_t<T>>::_pdb == nullptr) {
+                return true;
+            }
+            if (encoding == pdb_encoding::mod3) {
+                const pdb_t<node_t<T>>& ppdb = *pdb<node_t<T>>::_pdb;
+                std::vector<std::tuple<pdbval_t, T>> successors;
+                for (pdboff_t address = 0 ; address < ppdb.capacity () ; address++) {
+                    successors.clear ();
+                    T (ppdb.unrank (address)).children (successors);
+                    for (auto const& [cost, child] : successors) {
+                        pdbval_t value = ppdb[ppdb.rank (child.get_perm ())];
+                        if (value > ppdb[address] + 1 || ppdb[address] > value + 1) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+            if (encoding_bits (encoding) >= encoding_bits (get_encoding ())) {
+                return true;
+            }
+            const pdb_t<node_t<T>>& ppdb = *pdb<node_t<T>>::_pdb;
+            for (pdboff_t address = 0 ; address < ppdb.capacity () ; address++) {
+                if (pdbval_t (ppdb[address] - 1) > encoding_max (encoding)) {
                     return false;
                 }
+            }
+            return true;
+        }
 
-                // Before writting the values in the PDB to the file, decrement
-                // every value in one unit. The reason is that the PDB
-                // generation increments the g-value of the start state in one
-                // unit to distinguish empty locations from those with a g-value
-                // equal to zero (e.g., the abstract goal state), so that they
-                // have to be decremented now
-                for (auto i = 0 ; i < pdb<node_t<T>>::_pdb->size () ; i++) {
-                    (*pdb<node_t<T>>::_pdb) [i] = (*pdb<node_t<T>>::_pdb) [i]-1;
-                }
+        // return the encoding with the least number of bits, other than
+        // nibbles and mod3, which can store all values of the generated PDB
+        // (see encoding_for), so that PDBs with small values are stored in
+        // bytes even if they were generated with wider values
+        pdb_encoding best_encoding () const {
 
-                // Finally, write the PDB binary data into this file
-                if (!_write (out, pdb<node_t<T>>::_pdb->get_address ())) {
-                    return false;
+            if (pdb<node_t<T>>::_pdb == nullptr) {
+                return pdb_encoding::byte;
+            }
+            const pdb_t<node_t<T>>& ppdb = *pdb<node_t<T>>::_pdb;
+            pdbval_t largest = 0;
+            for (pdboff_t address = 0 ; address < ppdb.capacity () ; address++) {
+                largest = std::max (largest, pdbval_t (ppdb[address] - 1));
+            }
+            return encoding_for (largest);
+        }
+
+        // return the index used to split the generated PDB into shards with
+        // shard_length locations each
+        index_t get_index (const pdboff_t shard_length = index_t::default_shard_length) const {
+            return index_t (pdb<node_t<T>>::_mode, pdb<node_t<T>>::_goal,
+                            pdb<node_t<T>>::_p_pattern, pdb<node_t<T>>::_c_pattern,
+                            pdb<node_t<T>>::_pdb->capacity (), shard_length);
+        }
+
+        // write the index of the generated PDB split into shards with
+        // shard_length locations each to the given path, and return true if
+        // the operation was successful and false otherwise. PDBs finished in
+        // place can not be split, and an exception is raised
+        bool write_index (const std::filesystem::path& path,
+                          const pdboff_t shard_length = index_t::default_shard_length) {
+
+            if (_finished) {
+                throw std::invalid_argument (" [outpdb::write_index] This PDB has been already finished in place");
+            }
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+            return _write (out, get_index (shard_length).serialize ());
+        }
+
+        // write the given shard of the generated PDB split into shards with
+        // shard_length locations each, whose index is found at the given
+        // path. Shards are files with format v2 storing only the range of
+        // locations of the shard, and they are written like any other PDB
+        // (see 'write'). Because shards are independent, they can be written
+        // by different threads, or even different processes. It returns true
+        // if the operation was successful and false otherwise. Shards always
+        // store one value per byte. If the shard does not exist, or any of
+        // its values does not fit in one byte, an exception is raised
+        bool write_shard (const std::filesystem::path& path, const pdboff_t shard,
+                          const pdboff_t shard_length = index_t::default_shard_length) {
+
+            if (_finished) {
+                throw std::invalid_argument (" [outpdb::write_shard] This PDB has been already finished in place");
+            }
+            index_t index = get_index (shard_length);
+            if (shard >= index.get_nbshards ()) {
+                throw std::out_of_range (" [outpdb::write_shard] Shard out of bounds");
+            }
+            if (get_encoding () != pdb_encoding::byte) {
+                const pdb_t<node_t<T>>& ppdb = *pdb<node_t<T>>::_pdb;
+                for (pdboff_t address = index.get_first (shard) ;
+                     address < index.get_first (shard) + index.get_count (shard) ; address++) {
+                    if (pdbval_t (ppdb[address] - 1) > encoding_max (pdb_encoding::byte)) {
+                        throw std::out_of_range (" [outpdb::write_shard] The values of the shard can not be written in bytes");
+                    }
                 }
             }
 
-            return true;
+            std::ofstream out(index_t::shard_path (path, shard), std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+            header_t header (pdb<node_t<T>>::_mode, pdb<node_t<T>>::_goal,
+                             pdb<node_t<T>>::_p_pattern, pdb<node_t<T>>::_c_pattern,
+                             index.get_count (shard));
+            if (!_write (out, std::vector<uint8_t> (header.get_offset (), 0)) ||
+                !_write_values (out, &header, index.get_first (shard), index.get_count (shard))) {
+                return false;
+            }
+            out.seekp (0, std::ios::beg);
+            return _write (out, header.serialize ());
+        }
+
+        // write the generated PDB split into shards with shard_length
+        // locations each: the index is written to the given path and all
+        // shards are written next to it (see index_t) by the given number of
+        // threads. It returns true if the operation was successful and false
+        // otherwise, e.g., if any value does not fit in a byte, in which case
+        // nothing is written
+        bool write_shards (const std::filesystem::path& path,
+                           const pdboff_t shard_length = index_t::default_shard_length,
+                           const int nbthreads = 1) {
+
+            if (!_finished && !fits (pdb_encoding::byte)) {
+                return false;
+            }
+            if (!write_index (path, shard_length)) {
+                return false;
+            }
+
+            // shards are distributed among the threads one at a time. Errors
+            // writing any shard are reported in the result, as exceptions can
+            // not leave the threads
+            const pdboff_t nbshards = get_index (shard_length).get_nbshards ();
+            std::atomic<pdboff_t> next = 0;
+            std::atomic<bool> ok = true;
+            auto worker = [&] () {
+                pdboff_t shard;
+                while (ok && (shard = next.fetch_add (1)) < nbshards) {
+                    try {
+                        if (!write_shard (path, shard, shard_length)) {
+                            ok = false;
+                        }
+                    } catch (const std::exception&) {
+                        ok = false;
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            for (auto id = 1 ; id < nbthreads ; id++) {
+                threads.push_back (std::thread (worker));
+            }
+            worker ();
+            for (auto& thread : threads) {
+                thread.join ();
+            }
+            return ok;
         }
 
     }; // class outpdb<node_t<T>>
@@ -0,0 +1,205 @@
+// -*- coding: utf-8 -*-
+// PDBpartial.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 00:41:27.503817264 (1792370487)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Partial PDBs which store only the locations with large values
+//
+
+#ifndef _PDBPARTIAL_H_
+#define _PDBPARTIAL_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<vector>
+
+#include "PDBpdb.h"
+#include "PDBoutpdb.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename PDBNodeT>
+    class partial;
+
+    // Class definition
+    //
+    // partial PDBs store only the locations of a PDB whose values are
+    // strictly larger than a given threshold, because in large PDBs most
+    // locations store small values which add little to any cheap heuristic.
+    // The values of all other locations are known to be less or equal than
+    // the threshold, and they are looked up as zero so that partial PDBs are
+    // still admissible. Thus, they are meant to be used along with another
+    // heuristic, e.g., taking the maximum of both.
+    //
+    // Locations are ranked as in the original PDB, and they are grouped in
+    // buckets of 2^16 consecutive locations. Every bucket records where its
+    // locations start in a sorted vector with the 16 least significant bits
+    // of every location stored, so that every location takes four bytes
+    // (two for its rank and two for its value) and it is found with a
+    // binary search within its bucket
+    template<typename T>
+    requires pdb_type<T>
+    class partial<node_t<T>> : public pdb<node_t<T>> {
+
+    private:
+
+        // INVARIANT: partial PDBs store the locations of the original PDB,
+        // whose address space is recorded separately, with values strictly
+        // larger than _threshold
+        pdbval_t _threshold;
+        pdboff_t _address_space;
+
+        // locations are stored in buckets: _first[b] is the position in _low
+        // and _values of the first location of the b-th bucket, and the last
+        // one marks the end of the last bucket
+        std::vector<pdboff_t> _first;
+        std::vector<uint16_t> _low;
+        std::vector<pdbval_t> _values;
+
+        // they also record the sum of the values of all locations of the
+        // original PDB, and those of the locations discarded
+        pdboff_t _nbtotal;
+        pdboff_t _nblost;
+
+        // return the position in _values of the given location, or _values.size
+        // if it is not stored
+        size_t _find (const pdboff_t location) const {
+            const pdboff_t bucket = location >> bucket_bits;
+            const uint16_t low = uint16_t (location);
+            auto first = _low.begin () + _first[bucket];
+            auto last = _low.begin () + _first[bucket+1];
+            auto it = std::lower_bound (first, last, low);
+            return (it != last && *it == low) ? size_t (it - _low.begin ()) : _values.size ();
+        }
+
+    public:
+
+        // every bucket contains 2^bucket_bits locations
+        static constexpr int bucket_bits = 16;
+
+        // Default constructors are forbidden
+        partial () = delete;
+
+        // Explicit constructor ---partial PDBs are built from a PDB which has
+        // been already generated, storing only those locations whose value
+        // is strictly larger than the given threshold
+        partial (const outpdb<node_t<T>>& source, const pdbval_t threshold) :
+            pdb<node_t<T>>(source.get_pdb_mode (), source.get_goal (),
+                           source.get_cpattern (), source.get_ppattern ()),
+            _threshold     {         threshold },
+            _address_space { source.capacity () },
+            _nbtotal       {                 0 },
+            _nblost        {                 0 }
+            {
+
+                // the PDB is used only to rank permutations, and thus it takes
+                // no room at all
+                pdb<node_t<T>>::_pdb = new pdb_t<node_t<T>> (pdboff_t (0));
+                pdb<node_t<T>>::_pdb->init (pdb<node_t<T>>::_goal, pdb<node_t<T>>::_p_pattern);
+
+                // store all locations with values larger than the threshold.
+                // Note that the values of outpdbs are incremented in one unit
+                const pdboff_t nbbuckets = (_address_space + (pdboff_t (1) << bucket_bits) - 1) >> bucket_bits;
+                _first = std::vector<pdboff_t> (nbbuckets + 1, 0);
+                for (pdboff_t location = 0 ; location < _address_space ; location++) {
+                    const pdbval_t value = pdbval_t (source[location] - 1);
+                    _nbtotal += value;
+                    if (value > _threshold) {
+                        _low.push_back (uint16_t (location));
+                        _values.push_back (value);
+                        _first[1 + (location >> bucket_bits)]++;
+                    } else {
+                        _nblost += value;
+                    }
+                }
+                for (pdboff_t bucket = 0 ; bucket < nbbuckets ; bucket++) {
+                    _first[bucket+1] += _first[bucket];
+                }
+                _low.shrink_to_fit ();
+                _values.shrink_to_fit ();
+            }
+
+        // getters
+
+        // return the threshold. The values of all locations not stored are
+        // less or equal than it
+        const pdbval_t get_threshold () const {
+            return _threshold;
+        }
+
+        // return the address space of the original PDB
+        pdboff_t get_address_space () const {
+            return _address_space;
+        }
+
+        // return the number of locations stored
+        pdboff_t get_nbentries () const {
+            return _values.size ();
+        }
+
+        // return the number of bytes taken by all locations stored and the
+        // buckets
+        pdboff_t get_nbbytes () const {
+            return _values.size () * (sizeof (uint16_t) + sizeof (pdbval_t)) + _first.size () * sizeof (pdboff_t);
+        }
+
+        // return the fraction of the sum of the values of the original PDB
+        // which is stored in this one
+        double get_retained () const {
+            return _nbtotal ? 1.0 - double (_nblost) / _nbtotal : 1.0;
+        }
+
+        // return the average value lost over all locations of the original
+        // PDB, i.e., the average value of the locations not stored
+        double get_loss () const {
+            return _address_space ? double (_nblost) / _address_space : 0.0;
+        }
+
+        // return true if the given location of the original PDB is stored in
+        // this one. In case the location exceeds its address space, the
+        // behaviour is undefined
+        bool contains (const pdboff_t location) const {
+            return _find (location) != _values.size ();
+        }
+
+        // operator overloading
+
+        // Given a correct index to the address space of the original PDB,
+        // return its value if it is stored, and zero otherwise. In case the
+        // index is out of bounds, the behaviour is undefined
+        pdbval_t operator[] (const pdboff_t index) const {
+            const size_t position = _find (index);
+            return (position != _values.size ()) ? _values[position] : pdbval_t (0);
+        }
+
+        // get the value corresponding to the given permutation as a vector of
+        // integers if it is stored, and zero otherwise
+        const pdbval_t operator[] (const std::vector<int>& perm) const {
+            return (*this)[pdb<node_t<T>>::_pdb->rank (perm)];
+        }
+
+        // methods
+
+        // return the value of the given permutation. It is provided to look
+        // up partial PDBs with the same interface of inpdb
+        pdbval_t value (const std::vector<int>& perm) const {
+            return (*this)[perm];
+        }
+        pdbval_t value (const std::vector<int>& perm, const pdbval_t parent_h) const {
+            return (*this)[perm];
+        }
+
+    }; // class partial<node_t<T>>
+} // namespace pdb
+
+#endif // _PDBPARTIAL_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -15,6 +15,7 @@
 
 #include<chrono>
 #include<tuple>
+#include<utility>
 #include<vector>
 
 #include "../PDBdefs.h"
@@ -63,10 +64,23 @@ namespace pdb {
         // As a result the PDB is stored internally
         pdb_t<node_t<T>> *_pdb;
 
+        // in memory backed with the pages given in _pages, and placed among
+        // the NUMA nodes as given in _placement (see 'place')
+        pdb_pages _pages;
+        pdb_placement _placement;
+
         // Which, when being either generated (outPDBs) or read (inPDBs) could
         // have some errors
         error_message _error;
 
+        // copy the PDB to every NUMA node if it was requested with 'place'.
+        // It must be used only once the PDB is complete
+        void _replicate () {
+            if (_placement == pdb_placement::replicate) {
+                _pdb->replicate ();
+            }
+        }
+
     public:
 
         // Default constructors are forbidden
@@ -83,6 +97,8 @@ namespace pdb {
             _p_pattern    {               ppattern },
             _mode         {                   mode },
             _pdb          {                nullptr },
+            _pages        {      pdb_pages::normal },
+            _placement    { pdb_placement::local   },
             _error        { error_message::no_error}
             {}
 
@@ -110,13 +126,25 @@ namespace pdb {
         const error_message get_error () const {
             return _error;
         }
+        const pdb_pages get_pages () const {
+            return _pages;
+        }
+        const pdb_placement get_placement () const {
+            return _placement;
+        }
+
+        // return the pages actually backing the PDB, which might differ from
+        // those requested with 'place' if huge pages were not available
+        const pdb_pages get_pages_used () const {
+            return (_pdb == nullptr) ? pdb_pages::normal : _pdb->get_region ().pages ();
+        }
 
         // operator overloading
 
         // Given a correct index to the address space in this PDB, return the
         // value at its location. In case the index is out of bounds, the
         // behaviour is undefined
-        const pdbval_t& operator[] (const pdboff_t index) const {
+        pdbval_t operator[] (const pdboff_t index) const {
             return (*_pdb)[index];
         }
 
@@ -132,14 +160,108 @@ namespace pdb {
         }
 
 
+        // methods
+
         // Given a correct index to the address space in this PDB, return a
         // reference to its location so it can be overwritten. In case the index
-        // is out of bounds, an exception is raised.
-        pdbval_t& operator[] (const pdboff_t index) {
-            return (*_pdb)[index];
+        // is out of bounds, an exception is raised (see pdb_t::ref)
+        uint8_t& ref (const pdboff_t index) {
+            return _pdb->ref (index);
         }
 
-        // methods
+        // write in inverse the location of every symbol in the given
+        // permutation. It can be shared among all PDBs with the same goal to
+        // look up the permutation with 'at_inverse' (see pdb_t::invert)
+        void invert (const std::vector<int>& perm, std::vector<int>& inverse) const {
+            _pdb->invert (perm, inverse);
+        }
+
+        // write in inverse and dual the location of every symbol in the given
+        // full permutation and in its dual state, both computed in the same
+        // pass, so that both can be looked up with 'at_inverse' (see
+        // pdb_t::invert)
+        void invert (const std::vector<int>& perm, std::vector<int>& inverse, std::vector<int>& dual) const {
+            _pdb->invert (perm, inverse, dual);
+        }
+
+        // return the dual state of the given full permutation (see
+        // pdb_t::dual)
+        std::vector<int> dual (const std::vector<int>& perm) const {
+            return _pdb->dual (perm);
+        }
+
+        // get the value corresponding to the permutation whose inverse is
+        // given, as computed by 'invert'. It is the same returned by
+        // operator[] with the permutation
+        const pdbval_t at_inverse (const std::vector<int>& inverse) const {
+            return _pdb->at (_pdb->rank_inverse (inverse));
+        }
+
+        // batched lookups are performed in two stages so that the memory
+        // accesses of all permutations overlap instead of paying one cache
+        // miss after the other: first, 'prefetch' ranks all permutations and
+        // issues a prefetch of every location; next, 'gather' returns their
+        // values. Using both stages separately allows prefetching the
+        // locations of several PDBs before gathering any of them (see
+        // inpdbs::lookup)
+
+        // rank every permutation in perms, write its location in indices
+        // and prefetch it
+        void prefetch (const std::vector<std::vector<int>>& perms, std::vector<pdboff_t>& indices) const {
+            indices.resize (perms.size ());
+            for (size_t i = 0 ; i < perms.size () ; i++) {
+                indices[i] = _pdb->rank (perms[i]);
+                _pdb->prefetch (indices[i]);
+            }
+        }
+
+        // rank the permutation of every successor as returned by the service
+        // 'children' of the domain, e.g., all children of a node in a
+        // search, write its location in indices and prefetch it
+        void prefetch (const std::vector<std::tuple<pdbval_t, T>>& successors, std::vector<pdboff_t>& indices) const {
+            indices.resize (successors.size ());
+            for (size_t i = 0 ; i < successors.size () ; i++) {
+                indices[i] = _pdb->rank (std::get<1> (successors[i]).get_perm ());
+                _pdb->prefetch (indices[i]);
+            }
+        }
+
+        // write in values the value stored at every location given in
+        // indices, which must have been computed with 'prefetch'
+        void gather (const std::vector<pdboff_t>& indices, std::vector<pdbval_t>& values) const {
+            values.resize (indices.size ());
+            for (size_t i = 0 ; i < indices.size () ; i++) {
+                values[i] = (*_pdb)[indices[i]];
+            }
+        }
+
+        // batched version of operator[]: write in values the value of every
+        // permutation in perms, prefetching all their locations before
+        // gathering any value. The locations are written in indices, so
+        // that its memory can be reused between calls
+        void lookup (const std::vector<std::vector<int>>& perms,
+                     std::vector<pdboff_t>& indices, std::vector<pdbval_t>& values) const {
+            prefetch (perms, indices);
+            gather (indices, values);
+        }
+
+        // batched lookup of the permutations of all successors as returned
+        // by the service 'children' of the domain
+        void lookup (const std::vector<std::tuple<pdbval_t, T>>& successors,
+                     std::vector<pdboff_t>& indices, std::vector<pdbval_t>& values) const {
+            prefetch (successors, indices);
+            gather (indices, values);
+        }
+
+        // request the PDBs subsequently generated or read to be stored in
+        // memory backed with the given pages and placed among the NUMA nodes
+        // as given. Replicated PDBs are copied to every node once they are
+        // complete. PDBs stored in files mapped in memory are backed by the
+        // page cache, so that they can only be replicated
+        void place (const pdb_pages pages, const pdb_placement placement) {
+            _pages = pages;
+            _placement = placement;
+        }
 
         // return a string representing the current error
         std::string get_error_message () const {
@@ -168,7 +290,7 @@ namespace pdb {
 
         // return the number of positions written in this PDB. Note that the
         // value returned refers to the number of times that _pdb->insert was
-        // used because _pdb could also be written using operator[] but it does
+        // used because _pdb could also be written using ref but it does
         // not update its _size
         pdboff_t size () const {
 
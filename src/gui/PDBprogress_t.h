@@ -13,12 +13,15 @@
 #ifndef _PDBPROGRESS_T_H_
 #define _PDBPROGRESS_T_H_
 
+#include<algorithm>
 #include<iostream>
 #include<sstream>
 #include<string>
 #include<sys/ioctl.h>
 #include <unistd.h>
 
+#include "../PDBdefs.h"
+
 namespace pdb {
 
     class progress_t {
@@ -27,9 +30,15 @@ namespace pdb {
 
         // INVARIANT: a progress bar is defined using two values: the current
         // value and an upper bound. The ratio between them is used to compute
-        // the chunk of the progress bar to show
-        int _value;
-        int _upper_bound;
+        // the chunk of the progress bar to show. Both are as large as the
+        // indices of PDBs, so that they can count all their entries
+        pdboff_t _value;
+        pdboff_t _upper_bound;
+
+        // Because progress bars can be updated billions of times, they are
+        // redrawn only when the value reaches _next, i.e., every thousandth of
+        // the upper bound
+        mutable pdboff_t _next;
 
         // In addition, the progress bar might have a prefix, and also a
         // suffix
@@ -53,16 +62,17 @@ namespace pdb {
         progress_t () = delete;
 
         // Explicit constructors - it is mandatory to provide an upper bound
-        explicit progress_t (int upper_bound) :
+        explicit progress_t (pdboff_t upper_bound) :
             _value       {           0 },
-            _upper_bound { upper_bound }
+            _upper_bound { upper_bound },
+            _next        {           0 }
             {}
 
         // getters
-        int get_value () const {
+        pdboff_t get_value () const {
             return _value;
         }
-        int get_upper_bound () const {
+        pdboff_t get_upper_bound () const {
             return _upper_bound;
         }
         const std::string get_prefix () const {
@@ -73,7 +83,7 @@ namespace pdb {
         }
 
         // setters
-        void set_value (int value) {
+        void set_value (pdboff_t value) {
             _value = value;
         }
         void set_prefix (std::string value) {
@@ -86,8 +96,14 @@ namespace pdb {
         // When showing a progress bar it is always assumed that the cursor is
         // already placed at the first column of the line where the progress bar
         // has to be displayed. The progress bar is shown on the standard output
+        // only if it has changed noticeably since it was last shown
         void show () const {
 
+            if (_value < _next && _value < _upper_bound) {
+                return;
+            }
+            _next = _value + std::max (pdboff_t (1), _upper_bound / 1000);
+
             // the width of the terminal is re-computed with every redrawing
             // because the user might have scale it. In case it is not possible
             // to determine the width of the console taek 100
@@ -109,7 +125,7 @@ namespace pdb {
 
             // and then show the progress bar taking a length which is
             // proportional to the ratio _value/_upper_bound
-            int length = width*_value/_upper_bound;
+            int length = _upper_bound ? int (width * (double (std::min (_value, _upper_bound)) / _upper_bound)) : width;
             stream << _repeat_utf8 ("▒", length) << " ";
 
             // and display the suffix at the end
@@ -23,16 +23,33 @@
 
 // *** data structures
 
+#include "structs/PDBarena_t.h"
+#include "structs/PDBgraph_t.h"
+#include "structs/PDBheader_t.h"
+#include "structs/PDBindex_t.h"
 #include "structs/PDBnode_t.h"
 #include "structs/PDBopen_t.h"
 #include "structs/PDBpdb_t.h"
+#include "structs/PDBradix_t.h"
+#include "structs/PDBregion_t.h"
+#include "structs/PDBring_t.h"
 
 // *** algorithms
+#include "algorithm/PDBevaluator.h"
+#include "algorithm/PDBfolded.h"
+#include "algorithm/PDBheuristic_set.h"
+#include "algorithm/PDBinblocks.h"
+#include "algorithm/PDBpartial.h"
 #include "algorithm/PDBinpdb.h"
+#include "algorithm/PDBinpdbs.h"
+#include "algorithm/PDBinshards.h"
 #include "algorithm/PDBoutpdb.h"
 
 // *** utils
 #include "gui/PDBprogress_t.h"
+#include "utils/PDBcodec.h"
+#include "utils/PDBcrc32c.h"
+#include "utils/PDBnuma.h"
 
 #endif // _PDB_H_
 
@@ -0,0 +1,259 @@
+// -*- coding: utf-8 -*-
+// PDBarena_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 15:02:44.116893207 (1792335764)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of a recycling arena of fixed-size chunks, and of buckets backed
+// by them
+//
+
+#ifndef _PDBARENA_T_H_
+#define _PDBARENA_T_H_
+
+#include<algorithm>
+#include<memory>
+#include<new>
+#include<stddef.h>
+#include<stdexcept>
+#include<utility>
+#include<vector>
+
+namespace pdb {
+
+    // Class definition
+    //
+    // Arenas serve chunks of raw memory with room for a fixed number of items
+    // of type U. Chunks released are not returned to the system but kept in a
+    // free list, so that they are reused by subsequent requests. Items are
+    // never constructed nor destroyed by the arena
+    template<typename U>
+    class arena_t {
+
+    private:
+
+        // INVARIANT: an arena keeps track of all chunks ever allocated in
+        // _chunks, and those available for reuse in _free. Thus, the number
+        // of chunks in use is the difference between both
+        size_t _chunk_size;                      // number of items per chunk
+        std::vector<U*> _chunks;                       // all chunks allocated
+        std::vector<U*> _free;                     // chunks available for reuse
+
+    public:
+
+        // by default, every chunk takes roughly 64 KiB
+        static constexpr size_t default_chunk_bytes = 64 * 1024;
+
+        // Default constructor
+        arena_t () :
+            arena_t (std::max (size_t (1), default_chunk_bytes / sizeof (U)))
+            { }
+
+        // Explicit constructor ---chunks are created with room for chunk_size
+        // items. If the size is null an exception is raised
+        explicit arena_t (const size_t chunk_size) :
+            _chunk_size { chunk_size }
+            {
+                if (!_chunk_size) {
+                    throw std::invalid_argument ("[arena_t::arena_t] Chunks can not be empty!");
+                }
+            }
+
+        // Copy and assignment constructors are explicitly forbidden
+        arena_t (const arena_t&) = delete;
+        arena_t (arena_t&&) = delete;
+
+        // Assignment and move operators are disallowed as well
+        arena_t& operator=(const arena_t&) = delete;
+        arena_t& operator=(arena_t&&) = delete;
+
+        // the destructor returns all chunks to the system. Note that it is up
+        // to the user to destroy the items stored in them
+        ~arena_t () {
+            for (auto chunk : _chunks) {
+                ::operator delete (chunk, std::align_val_t (alignof (U)));
+            }
+        }
+
+        // get accessors
+        const size_t get_chunk_size () const
+            { return _chunk_size; }
+        const size_t get_nbchunks () const
+            { return _chunks.size (); }
+
+        // return the number of bytes in the chunks currently in use
+        const size_t get_live_bytes () const
+            { return (_chunks.size () - _free.size ()) * _chunk_size * sizeof (U); }
+
+        // return the number of bytes in all chunks allocated, either in use or
+        // available for reuse
+        const size_t get_reserved_bytes () const
+            { return _chunks.size () * _chunk_size * sizeof (U); }
+
+        // methods
+
+        // return a chunk with room for chunk_size items. A chunk available for
+        // reuse is preferred, if any
+        U* allocate () {
+
+            if (_free.size ()) {
+                U* chunk = _free.back ();
+                _free.pop_back ();
+                return chunk;
+            }
+
+            // otherwise, request a new one to the system
+            U* chunk = static_cast<U*> (::operator new (_chunk_size * sizeof (U),
+                                                        std::align_val_t (alignof (U))));
+            _chunks.push_back (chunk);
+            return chunk;
+        }
+
+        // make the given chunk available for reuse. It must have been served
+        // by this arena, and all its items must have been destroyed
+        void release (U* chunk) {
+            _free.push_back (chunk);
+        }
+
+        // return all chunks available for reuse to the system
+        void shrink () {
+            for (auto chunk : _free) {
+                _chunks.erase (std::find (_chunks.begin (), _chunks.end (), chunk));
+                ::operator delete (chunk, std::align_val_t (alignof (U)));
+            }
+            _free.clear ();
+        }
+
+    }; // class arena_t<U>
+
+    // Class definition
+    //
+    // Buckets are stacks of items stored in chunks served by an arena. Unlike
+    // vectors, they never copy their contents when growing, and every chunk
+    // is returned to the arena as soon as it becomes empty, so that it can be
+    // reused by other buckets sharing the same arena
+    template<typename U>
+    class bucket_t {
+
+    private:
+
+        // INVARIANT: the i-th item is stored in the (i % chunk_size)-th
+        // position of the (i / chunk_size)-th chunk. Only chunks containing
+        // items are kept
+        arena_t<U>* _arena;
+        std::vector<U*> _chunks;
+        size_t _size;
+
+        // return the address of the i-th item
+        U* _address (const size_t i) const {
+            return _chunks[i / _arena->get_chunk_size ()] + i % _arena->get_chunk_size ();
+        }
+
+    public:
+
+        // Explicit constructor ---buckets are created empty on the given
+        // arena
+        explicit bucket_t (arena_t<U>& arena) :
+            _arena  { &arena },
+            _size   {      0 }
+            { }
+
+        // Copy constructors and assignments are explicitly forbidden
+        bucket_t (const bucket_t&) = delete;
+        bucket_t& operator=(const bucket_t&) = delete;
+
+        // buckets can be moved so that they can be stored in vectors
+        bucket_t (bucket_t&& other) noexcept :
+            _arena  { other._arena },
+            _chunks { std::move (other._chunks) },
+            _size   { other._size }
+            {
+                other._chunks.clear ();
+                other._size = 0;
+            }
+        bucket_t& operator=(bucket_t&& other) noexcept {
+            if (this != &other) {
+                clear ();
+                _arena = other._arena;
+                _chunks = std::move (other._chunks);
+                _size = other._size;
+                other._chunks.clear ();
+                other._size = 0;
+            }
+            return *this;
+        }
+
+        // the destructor destroys all items and returns the chunks to the
+        // arena
+        ~bucket_t () {
+            clear ();
+        }
+
+        // get accessors
+        const size_t size () const
+            { return _size; }
+        const bool empty () const
+            { return !_size; }
+
+        // operator overloading
+
+        // return the i-th item of the bucket. If i is out of bounds, the
+        // behaviour is undefined
+        U& operator[] (const size_t i) {
+            return *_address (i);
+        }
+        const U& operator[] (const size_t i) const {
+            return *_address (i);
+        }
+
+        // methods
+
+        // add the given item at the end of the bucket, requesting a new chunk
+        // to the arena if necessary
+        void push_back (const U& item) {
+            if (_size == _chunks.size () * _arena->get_chunk_size ()) {
+                _chunks.push_back (_arena->allocate ());
+            }
+            new (_address (_size)) U (item);
+            _size++;
+        }
+
+        // return the last item of the bucket. If the bucket is empty, the
+        // behaviour is undefined
+        U& back () {
+            return *_address (_size-1);
+        }
+
+        // remove the last item of the bucket, returning its chunk to the arena
+        // in case it becomes empty. If the bucket is empty, the behaviour is
+        // undefined
+        void pop_back () {
+            _size--;
+            std::destroy_at (_address (_size));
+            if (_size == (_chunks.size () - 1) * _arena->get_chunk_size ()) {
+                _arena->release (_chunks.back ());
+                _chunks.pop_back ();
+            }
+        }
+
+        // remove all items in the bucket and return all its chunks to the
+        // arena
+        void clear () {
+            while (_size) {
+                pop_back ();
+            }
+        }
+
+    }; // class bucket_t<U>
+
+} // namespace pdb
+
+#endif // _PDBARENA_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
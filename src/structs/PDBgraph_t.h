@@ -0,0 +1,328 @@
+// -*- coding: utf-8 -*-
+// PDBgraph_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 10:14:07.402716533 (1792318447)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of the abstract state graph of a pattern in compressed sparse row
+// (CSR) format
+//
+
+#ifndef _PDBGRAPH_T_H_
+#define _PDBGRAPH_T_H_
+
+#include<cstdint>
+#include<filesystem>
+#include<fstream>
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<tuple>
+#include<vector>
+
+#include "../PDBdefs.h"
+
+namespace pdb {
+
+    // Class definition
+    //
+    // The abstract state graph induced by a c-pattern is independent of the
+    // cost of the operators. Once it has been computed, the PDB can be
+    // regenerated for any cost model without invoking the services of the
+    // domain again. Because nodes are identified by their rank, graphs do not
+    // depend on the type of the states
+    class graph_t {
+
+    private:
+
+        // INVARIANT: a graph stores the explicit definition of the goal and
+        // both patterns used to generate it, so that it can be verified that
+        // it is used to generate compatible PDBs
+        std::vector<int> _goal;
+        std::string _c_pattern;
+        std::string _p_pattern;
+
+        // nodes are identified by their rank in the abstract state space
+        // induced by the c-pattern. The successors of the i-th node are stored
+        // in the range [_offsets[i], _offsets[i+1]) of _targets. Each edge is
+        // labeled with a cost class, which is the cost returned by the domain
+        // when the graph was generated. In addition, the rank of every node in
+        // the abstract state space induced by the p-pattern is stored in
+        // _pranks
+        pdboff_t _source;
+        std::vector<pdboff_t> _offsets;
+        std::vector<uint32_t> _targets;
+        std::vector<pdbval_t> _classes;
+        std::vector<uint32_t> _pranks;
+
+        // graphs of domains which support additive PDBs (see pdb_additive)
+        // also record, for every edge, whether it is charged in additive PDBs
+        // with the p-pattern, i.e., whether its owner is preserved by it.
+        // Otherwise, it is empty
+        std::vector<uint8_t> _charged;
+
+        // the cost model maps every cost class to its actual cost. By default,
+        // every class is mapped to itself
+        std::vector<pdbval_t> _costs;
+
+        // write the binary data given in a vector at the end of the ofstream
+        // out and return true if the operation was feasible and false
+        // otherwise
+        template<typename U>
+        bool _write (std::ofstream& out, const std::vector<U>& data) const {
+            out.write(reinterpret_cast<const char*>(data.data ()),
+                      static_cast<std::streamsize>(data.size()*sizeof (U)));
+            return bool (out);
+        }
+
+        // read as many items as the size of data from the ifstream in and
+        // return true if the operation was feasible and false otherwise
+        template<typename U>
+        bool _read (std::ifstream& in, std::vector<U>& data) {
+            in.read(reinterpret_cast<char*>(data.data ()),
+                    static_cast<std::streamsize>(data.size()*sizeof (U)));
+            return bool (in);
+        }
+
+    public:
+
+        // Default constructor ---graphs are populated either by an outpdb or
+        // by reading them from a file
+        graph_t () :
+            _source { 0 },
+            _offsets { std::vector<pdboff_t> (1, 0) },
+            _costs { std::vector<pdbval_t> (1 + std::numeric_limits<pdbval_t>::max ()) }
+            {
+                for (auto i = 0 ; i < int (_costs.size ()) ; i++) {
+                    _costs[i] = pdbval_t (i);
+                }
+            }
+
+        // Copy and assignment constructors are explicitly forbidden
+        graph_t (const graph_t&) = delete;
+        graph_t (graph_t&&) = delete;
+
+        // Assignment and move operators are disallowed as well
+        graph_t& operator=(const graph_t&) = delete;
+        graph_t& operator=(graph_t&&) = delete;
+
+        // getters
+        const std::vector<int>& get_goal () const {
+            return _goal;
+        }
+        const std::string& get_cpattern () const {
+            return _c_pattern;
+        }
+        const std::string& get_ppattern () const {
+            return _p_pattern;
+        }
+        pdboff_t get_source () const {
+            return _source;
+        }
+        const std::vector<pdboff_t>& get_offsets () const {
+            return _offsets;
+        }
+        const std::vector<uint32_t>& get_targets () const {
+            return _targets;
+        }
+        const std::vector<pdbval_t>& get_classes () const {
+            return _classes;
+        }
+        const std::vector<uint32_t>& get_pranks () const {
+            return _pranks;
+        }
+        const std::vector<uint8_t>& get_charged () const {
+            return _charged;
+        }
+        pdbval_t get_cost (const pdbval_t cclass) const {
+            return _costs[cclass];
+        }
+
+        // setters
+
+        // set the cost of all edges labeled with the given class
+        void set_cost (const pdbval_t cclass, const pdbval_t cost) {
+            _costs[cclass] = cost;
+        }
+
+        // methods
+
+        // return the number of nodes in the graph
+        pdboff_t nbnodes () const {
+            return _offsets.size () - 1;
+        }
+
+        // return the number of edges in the graph
+        pdboff_t nbedges () const {
+            return _targets.size ();
+        }
+
+        // Prepare the graph to receive the nodes of the abstract state space
+        // induced by cpattern with the given goal. The number of nodes is
+        // given in cspace, and the edges can be given with 'compile' only
+        // after invoking this method. In case the number of nodes exceeds the
+        // range of node identifiers, an exception is raised
+        void init (const std::vector<int>& goal,
+                   const std::string& cpattern, const std::string& ppattern,
+                   const pdboff_t cspace, const pdboff_t source) {
+
+            if (cspace > std::numeric_limits<uint32_t>::max ()) {
+                throw std::range_error (" [graph_t::init] The address space exceeds the range of node identifiers");
+            }
+
+            _goal = goal;
+            _c_pattern = cpattern;
+            _p_pattern = ppattern;
+            _source = source;
+
+            // all offsets are initially null, and they are computed once all
+            // edges have been added with 'compile'
+            _offsets = std::vector<pdboff_t> (1 + cspace, 0);
+            _pranks = std::vector<uint32_t> (cspace, 0);
+            _targets.clear ();
+            _classes.clear ();
+            _charged.clear ();
+        }
+
+        // Compile the edges given in the vector edges, each one as a tuple
+        // (source, target, class), into the CSR representation. The rank in
+        // the abstract state space induced by the p-pattern of every node has
+        // to be given in pranks. If given, charged[i] tells whether the i-th
+        // edge is charged in additive PDBs
+        void compile (const std::vector<std::tuple<uint32_t, uint32_t, pdbval_t>>& edges,
+                      const std::vector<uint32_t>& pranks,
+                      const std::vector<uint8_t>& charged = std::vector<uint8_t> ()) {
+
+            // first, count the number of edges leaving every node
+            for (const auto& [from, to, cclass] : edges) {
+                _offsets[1+from]++;
+            }
+
+            // and accumulate them to compute the offsets
+            for (pdboff_t i = 1 ; i < _offsets.size () ; i++) {
+                _offsets[i] += _offsets[i-1];
+            }
+
+            // now, place every edge in its slot
+            std::vector<pdboff_t> next (_offsets.begin (), _offsets.end ()-1);
+            _targets = std::vector<uint32_t> (edges.size ());
+            _classes = std::vector<pdbval_t> (edges.size ());
+            _charged = std::vector<uint8_t> (charged.empty () ? 0 : edges.size ());
+            for (size_t i = 0 ; i < edges.size () ; i++) {
+                const auto& [from, to, cclass] = edges[i];
+                _targets[next[from]] = to;
+                _classes[next[from]] = cclass;
+                if (!charged.empty ()) {
+                    _charged[next[from]] = charged[i];
+                }
+                next[from]++;
+            }
+
+            // and copy the ranks of all nodes in the p-space
+            _pranks = pranks;
+        }
+
+        // return true if it was possible to write the contents of the graph
+        // into the specified file and false otherwise. The binary file is
+        // started with a header that contains the following info:
+        //
+        // 1. A tag: CSR
+        // 2. The length of the goal
+        // 3. The goal given in explicit form
+        // 4. The p-pattern and the c-pattern
+        // 5. The source, number of nodes and edges as 64-bit integers
+        //
+        // followed by the offsets, targets, classes and p-ranks and, if they
+        // are available, the flags of the edges charged in additive PDBs
+        bool write (const std::filesystem::path& path) const {
+
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+
+            // write the header
+            std::vector<uint8_t> header {'C', 'S', 'R'};
+            header.push_back (uint8_t (_goal.size ()));
+            for (const auto item: _goal) {
+                header.push_back (uint8_t (item));
+            }
+            header.insert (header.end (), _p_pattern.begin (), _p_pattern.end ());
+            header.insert (header.end (), _c_pattern.begin (), _c_pattern.end ());
+            std::vector<uint64_t> sizes {_source, nbnodes (), nbedges ()};
+            if (!_write (out, header) || !_write (out, sizes)) {
+                return false;
+            }
+
+            // and next the data
+            return _write (out, _offsets) && _write (out, _targets) &&
+                _write (out, _classes) && _write (out, _pranks) && _write (out, _charged);
+        }
+
+        // retrieve the contents of a graph from the given file and return
+        // true if the operation was successful and false otherwise. The cost
+        // model is not modified
+        bool read (const std::filesystem::path& path) {
+
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                return false;
+            }
+
+            // read the tag and the length of the permutations
+            std::vector<uint8_t> tag (4, 0);
+            if (!_read (in, tag) || tag[0] != 'C' || tag[1] != 'S' || tag[2] != 'R') {
+                return false;
+            }
+            int length = int (tag[3]);
+
+            // the goal, and both patterns
+            std::vector<uint8_t> vgoal (length);
+            _p_pattern = std::string (length, '\0');
+            _c_pattern = std::string (length, '\0');
+            if (!_read (in, vgoal) ||
+                !in.read (_p_pattern.data (), length) ||
+                !in.read (_c_pattern.data (), length)) {
+                return false;
+            }
+            _goal = std::vector<int> (vgoal.begin (), vgoal.end ());
+
+            // the sizes
+            std::vector<uint64_t> sizes (3, 0);
+            if (!_read (in, sizes)) {
+                return false;
+            }
+            _source = sizes[0];
+
+            // and the data
+            _offsets = std::vector<pdboff_t> (1 + sizes[1]);
+            _targets = std::vector<uint32_t> (sizes[2]);
+            _classes = std::vector<pdbval_t> (sizes[2]);
+            _pranks = std::vector<uint32_t> (sizes[1]);
+            if (!_read (in, _offsets) || !_read (in, _targets) ||
+                !_read (in, _classes) || !_read (in, _pranks)) {
+                return false;
+            }
+
+            // the flags of the edges charged in additive PDBs are optional
+            _charged.clear ();
+            if (in.peek () == std::ifstream::traits_type::eof ()) {
+                return true;
+            }
+            _charged = std::vector<uint8_t> (sizes[2]);
+            return _read (in, _charged);
+        }
+
+    }; // class graph_t
+
+} // namespace pdb
+
+#endif // _PDBGRAPH_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
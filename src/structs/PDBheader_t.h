@@ -0,0 +1,486 @@
+// -*- coding: utf-8 -*-
+// PDBheader_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 17:41:52.507113096 (1792345312)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of the header of PDB files with format v2
+//
+
+#ifndef _PDBHEADER_T_H_
+#define _PDBHEADER_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<istream>
+#include<span>
+#include<stddef.h>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include "../PDBdefs.h"
+#include "../utils/PDBcrc32c.h"
+
+namespace pdb {
+
+    // Class definition
+    //
+    // Headers of v2 files describe the contents of a PDB and provide the means
+    // to verify its integrity. They are stored in little-endian with the
+    // following layout:
+    //
+    //    offset  size  contents
+    //         0     3  magic number "PDB"
+    //         3     1  version of the format (2)
+    //         4     1  mode: 0 (MAX) or 1 (ADD)
+    //         5     1  encoding of the values: 0 (byte), 1 (nibble), 2 (mod3),
+    //                  3 (tribble) or 4 (word)
+    //         6     1  ranking function
+    //         7     1  length of the permutations, n
+    //         8     8  address space, i.e., number of values
+    //        16     8  offset of the values, a multiple of the page size
+    //        24     8  size of every block of values (in bytes, once encoded)
+    //        32     8  number of blocks
+    //        40     4  CRC32C of the header, computed with this field zeroed
+    //        44     1  compression of the values: 0 (none) or 1 (rle)
+    //        45     3  reserved
+    //        48     n  goal
+    //      48+n     n  p-pattern
+    //     48+2n     n  c-pattern
+    //     48+3n  2048  histogram: number of occurrences of every value (8 bytes each)
+    //   2096+3n   4*b  CRC32C of every block of values
+    //
+    // followed by zeroes up to the offset of the values. The histogram counts
+    // the values once decoded, whereas checksums are computed over the bytes
+    // storing them with the given encoding (and before being compressed).
+    // Values equal to or larger than 255 are all counted in the last entry
+    // of the histogram.
+    //
+    // If the values are compressed, every block is compressed independently
+    // and the offset is followed by the block index, with the offsets of the
+    // b blocks and the end of the last one (8 bytes each) relative to the end
+    // of the index. Then the compressed blocks follow
+    class header_t {
+
+    private:
+
+        // INVARIANT: headers record the description of the PDB and the
+        // information used to verify its contents
+        pdb_mode _mode;
+        pdb_encoding _encoding;
+        pdb_ranking _ranking;
+        pdb_compression _compression;
+        std::vector<int> _goal;
+        std::string _p_pattern;
+        std::string _c_pattern;
+        pdboff_t _address_space;
+        pdboff_t _offset;
+        pdboff_t _block_size;
+        std::vector<pdboff_t> _histogram;
+        std::vector<uint32_t> _checksums;
+
+        // append the given number of bytes of value in little-endian
+        static void _put (std::vector<uint8_t>& out, const uint64_t value, const int nbbytes) {
+            for (auto i = 0 ; i < nbbytes ; i++) {
+                out.push_back (uint8_t (value >> (8*i)));
+            }
+        }
+
+        // return the given number of bytes starting at in in little-endian
+        static uint64_t _get (const uint8_t* in, const int nbbytes) {
+            uint64_t value = 0;
+            for (auto i = 0 ; i < nbbytes ; i++) {
+                value |= uint64_t (in[i]) << (8*i);
+            }
+            return value;
+        }
+
+        // return the number of bytes of the header, up to the last checksum
+        size_t _length () const {
+            return fixed_bytes + 3 * _goal.size () +
+                8 * _histogram.size () + 4 * get_nbblocks ();
+        }
+
+        // account in histogram for the values in the range [first, last)
+        // stored in the given bytes with the encoding of this header
+        void _count (const uint8_t* bytes, const pdboff_t first, const pdboff_t last,
+                     std::vector<pdboff_t>& histogram) const {
+
+            if (_encoding == pdb_encoding::byte) {
+                for (pdboff_t i = first ; i < last ; i++) {
+                    histogram[bytes[i]]++;
+                }
+                return;
+            }
+            for (pdboff_t i = first ; i < last ; i++) {
+                histogram[std::min (encoding_get (bytes, i, _encoding), pdbval_t (255))]++;
+            }
+        }
+
+    public:
+
+        // magic number and version of the format
+        static constexpr uint8_t magic[3] = {'P', 'D', 'B'};
+        static constexpr uint8_t version = 2;
+
+        // number of bytes of the fixed part of the header
+        static constexpr size_t fixed_bytes = 48;
+
+        // the values start at a multiple of the page size so that they can be
+        // directly mapped in memory
+        static constexpr size_t page_size = 4096;
+
+        // by default, a checksum is computed for every MiB of values
+        static constexpr size_t default_block_size = 1024 * 1024;
+
+        // compressed blocks are smaller, so that decoding any of them is
+        // cheap enough to be done on demand
+        static constexpr size_t compressed_block_size = 64 * 1024;
+
+        // Default constructor
+        header_t () :
+            _mode          { pdb_mode::max },
+            _encoding      { pdb_encoding::byte },
+            _ranking       { pdb_ranking::myrvold_ruskey },
+            _compression   { pdb_compression::none },
+            _address_space { 0 },
+            _offset        { 0 },
+            _block_size    { default_block_size },
+            _histogram     { std::vector<pdboff_t> (256, 0) }
+            { }
+
+        // Explicit constructor ---headers are created with the description of
+        // a PDB, the encoding of its values and their compression
+        header_t (const pdb_mode mode, const std::vector<int>& goal,
+                  const std::string_view p_pattern, const std::string_view c_pattern,
+                  const pdboff_t address_space, const pdboff_t block_size = default_block_size,
+                  const pdb_encoding encoding = pdb_encoding::byte,
+                  const pdb_compression compression = pdb_compression::none) :
+            _mode          { mode },
+            _encoding      { encoding },
+            _ranking       { pdb_ranking::myrvold_ruskey },
+            _compression   { compression },
+            _goal          { goal },
+            _p_pattern     { p_pattern },
+            _c_pattern     { c_pattern },
+            _address_space { address_space },
+            _offset        { 0 },
+            _block_size    { block_size },
+            _histogram     { std::vector<pdboff_t> (256, 0) }
+            {
+                if (!_block_size) {
+                    throw std::invalid_argument (" [header_t] Blocks can not be empty");
+                }
+
+                // the header is padded up to the next multiple of the page
+                // size. Because its length does not depend on the values,
+                // the offset is known before they are computed
+                _offset = ((_length () + page_size - 1) / page_size) * page_size;
+                _checksums = std::vector<uint32_t> (get_nbblocks (), 0);
+            }
+
+        // getters
+        const pdb_mode get_mode () const { return _mode; }
+        const pdb_encoding get_encoding () const { return _encoding; }
+        const pdb_ranking get_ranking () const { return _ranking; }
+        const pdb_compression get_compression () const { return _compression; }
+        const std::vector<int>& get_goal () const { return _goal; }
+        const std::string& get_ppattern () const { return _p_pattern; }
+        const std::string& get_cpattern () const { return _c_pattern; }
+        const pdboff_t get_address_space () const { return _address_space; }
+        const pdboff_t get_offset () const { return _offset; }
+        const pdboff_t get_block_size () const { return _block_size; }
+        const std::vector<pdboff_t>& get_histogram () const { return _histogram; }
+        const std::vector<uint32_t>& get_checksums () const { return _checksums; }
+
+        // return the number of blocks of values
+        pdboff_t get_nbblocks () const {
+            return (encoding_bytes (_encoding, _address_space) + _block_size - 1) / _block_size;
+        }
+
+        // return the number of bytes of the given block of values, once
+        // decompressed
+        pdboff_t get_block_length (const pdboff_t block) const {
+            return std::min (_block_size, encoding_bytes (_encoding, _address_space) - block * _block_size);
+        }
+
+        // return the number of bytes of the block index, which is empty if
+        // the values are not compressed
+        pdboff_t get_index_bytes () const {
+            return (_compression == pdb_compression::none) ? 0 : 8 * (get_nbblocks () + 1);
+        }
+
+        // methods
+
+        // account for the given bytes, which store the values found from the
+        // given location of the PDB on with the encoding of this header, in
+        // the histogram and the checksums. The bytes preceding the location
+        // must be a multiple of the block size, and the number of bytes as
+        // well unless they are the last ones. This is used to summarize
+        // values in chunks as they are written
+        void add (std::span<const uint8_t> data, const pdboff_t location) {
+
+            const uint8_t* bytes = data.data ();
+            const size_t nbbytes = data.size ();
+            const pdboff_t first = encoding_bytes (_encoding, location) / _block_size;
+            for (size_t start = 0, block = first ; start < nbbytes ; start += _block_size, block++) {
+                size_t length = std::min (size_t (_block_size), nbbytes - start);
+                _checksums[block] = crc32c (bytes + start, length);
+            }
+            _count (bytes, 0,
+                    std::min (pdboff_t (nbbytes) * 8 / encoding_bits (_encoding), _address_space - location),
+                    _histogram);
+        }
+
+        // compute the histogram and the checksum of every block of the given
+        // values. Blocks are distributed among the given number of threads
+        void summarize (std::span<const uint8_t> data, const int nbthreads = 1) {
+            summarize (data, _histogram, _checksums, nbthreads);
+        }
+
+        // compute the histogram and the checksum of every block of the given
+        // bytes, which store all values with the encoding of this header, and
+        // return them in the last parameters. Blocks are distributed among
+        // the given number of threads, and each one computes a partial
+        // histogram which is added up at the end. Every block counts the
+        // values starting in it, even if they end in the next one
+        void summarize (std::span<const uint8_t> data,
+                        std::vector<pdboff_t>& histogram, std::vector<uint32_t>& checksums,
+                        const int nbthreads = 1) const {
+
+            const uint8_t* bytes = data.data ();
+            const size_t nbbytes = data.size ();
+            const pdboff_t bits = encoding_bits (_encoding);
+            const size_t nbblocks = (nbbytes + _block_size - 1) / _block_size;
+            checksums = std::vector<uint32_t> (nbblocks, 0);
+
+            // every thread processes the blocks i, i+nbthreads, ...
+            int nbworkers = int (std::max (size_t (1), std::min (size_t (std::max (nbthreads, 1)), nbblocks)));
+            std::vector<std::vector<pdboff_t>> partial (nbworkers, std::vector<pdboff_t> (256, 0));
+            auto worker = [&] (const int id) {
+                for (size_t block = id ; block < nbblocks ; block += nbworkers) {
+                    size_t start = block * _block_size;
+                    size_t length = std::min (size_t (_block_size), nbbytes - start);
+                    checksums[block] = crc32c (bytes + start, length);
+                    _count (bytes,
+                            std::min ((pdboff_t (start) * 8 + bits - 1) / bits, _address_space),
+                            std::min ((pdboff_t (start + length) * 8 + bits - 1) / bits, _address_space),
+                            partial[id]);
+                }
+            };
+            if (nbworkers == 1) {
+                worker (0);
+            } else {
+                std::vector<std::thread> threads;
+                for (auto id = 0 ; id < nbworkers ; id++) {
+                    threads.push_back (std::thread (worker, id));
+                }
+                for (auto& thread : threads) {
+                    thread.join ();
+                }
+            }
+
+            // and add up all histograms
+            histogram = std::vector<pdboff_t> (256, 0);
+            for (const auto& ihistogram : partial) {
+                for (auto i = 0 ; i < 256 ; i++) {
+                    histogram[i] += ihistogram[i];
+                }
+            }
+        }
+
+        // return a binary representation of the header, padded with zeroes up
+        // to the offset of the values. It must be invoked after the values
+        // have been summarized with either 'summarize' or 'add'
+        std::vector<uint8_t> serialize () const {
+
+            std::vector<uint8_t> out;
+            out.reserve (_offset);
+            for (auto i = 0 ; i < 3 ; i++) {
+                out.push_back (magic[i]);
+            }
+            out.push_back (version);
+            out.push_back (uint8_t (_mode == pdb_mode::max ? 0 : 1));
+            out.push_back (uint8_t (_encoding));
+            out.push_back (uint8_t (_ranking));
+            out.push_back (uint8_t (_goal.size ()));
+            _put (out, _address_space, 8);
+            _put (out, _offset, 8);
+            _put (out, _block_size, 8);
+            _put (out, get_nbblocks (), 8);
+            _put (out, 0, 4);                               // CRC32C of the header
+            out.push_back (uint8_t (_compression));
+            _put (out, 0, 3);                                           // reserved
+            for (auto symbol : _goal) {
+                out.push_back (uint8_t (symbol));
+            }
+            out.insert (out.end (), _p_pattern.begin (), _p_pattern.end ());
+            out.insert (out.end (), _c_pattern.begin (), _c_pattern.end ());
+            for (auto count : _histogram) {
+                _put (out, count, 8);
+            }
+            for (auto checksum : _checksums) {
+                _put (out, checksum, 4);
+            }
+
+            // compute the checksum of the header and write it down in its
+            // location
+            uint32_t crc = crc32c (out.data (), out.size ());
+            for (auto i = 0 ; i < 4 ; i++) {
+                out[40+i] = uint8_t (crc >> (8*i));
+            }
+
+            // and pad it with zeroes
+            out.resize (_offset, 0);
+            return out;
+        }
+
+        // read a header from the given stream, which must be positioned right
+        // at its beginning, and return true if it was successfully read. The
+        // size of the file is used to verify it contains all values. In case
+        // of error, false is returned and the error is written in in_error
+        bool deserialize (std::istream& in, const pdboff_t size, in_error_message& in_error) {
+
+            // read the fixed part of the header
+            std::vector<uint8_t> out (fixed_bytes, 0);
+            if (!in.read (reinterpret_cast<char*> (out.data ()), fixed_bytes)) {
+                in_error = in_error_message::pdb_header_could_not_be_read;
+                return false;
+            }
+            if (!std::equal (magic, magic + 3, out.begin ()) || out[3] != version ||
+                out[4] > 1 || out[5] > uint8_t (pdb_encoding::word) ||
+                (out[4] == 1 && out[5] == uint8_t (pdb_encoding::mod3)) ||
+                out[6] != uint8_t (pdb_ranking::myrvold_ruskey) ||
+                out[44] > uint8_t (pdb_compression::rle)) {
+                in_error = in_error_message::pdb_format_not_supported;
+                return false;
+            }
+            _mode = (out[4] == 0) ? pdb_mode::max : pdb_mode::add;
+            _encoding = pdb_encoding (out[5]);
+            _ranking = pdb_ranking (out[6]);
+            _compression = pdb_compression (out[44]);
+            int n = out[7];
+            _address_space = _get (&out[8], 8);
+            _offset = _get (&out[16], 8);
+            _block_size = _get (&out[24], 8);
+            pdboff_t nbblocks = _get (&out[32], 8);
+            uint32_t crc = uint32_t (_get (&out[40], 4));
+
+            // check the size of the file and the number of blocks are
+            // consistent with the rest of the header before reading the
+            // variable part. The size of compressed values is verified with
+            // the block index
+            _histogram = std::vector<pdboff_t> (256, 0);
+            _goal = std::vector<int> (n, 0);
+            _checksums.clear ();
+            if (!_block_size || nbblocks != get_nbblocks ()) {
+                in_error = in_error_message::pdb_header_corrupted;
+                return false;
+            }
+            if (_offset > size ||
+                (_compression == pdb_compression::none && size - _offset != encoding_bytes (_encoding, _address_space)) ||
+                (_compression != pdb_compression::none && size - _offset < get_index_bytes ())) {
+                in_error = in_error_message::pdb_incorrect_size;
+                return false;
+            }
+            if (_offset % page_size || fixed_bytes + 3*n + 8*256 + 4*nbblocks > _offset) {
+                in_error = in_error_message::pdb_header_corrupted;
+                return false;
+            }
+            _checksums = std::vector<uint32_t> (nbblocks, 0);
+
+            // read the variable part of the header
+            size_t length = _length ();
+            out.resize (length);
+            if (!in.read (reinterpret_cast<char*> (out.data () + fixed_bytes), length - fixed_bytes)) {
+                in_error = in_error_message::pdb_header_could_not_be_read;
+                return false;
+            }
+
+            // verify its checksum
+            std::fill (out.begin () + 40, out.begin () + 44, 0);
+            if (crc32c (out.data (), out.size ()) != crc) {
+                in_error = in_error_message::pdb_header_corrupted;
+                return false;
+            }
+
+            // and decode it
+            size_t idx = fixed_bytes;
+            for (auto i = 0 ; i < n ; i++) {
+                _goal[i] = int (out[idx++]);
+            }
+            _p_pattern = std::string (out.begin () + idx, out.begin () + idx + n);
+            idx += n;
+            _c_pattern = std::string (out.begin () + idx, out.begin () + idx + n);
+            idx += n;
+            for (auto i = 0 ; i < 256 ; i++, idx += 8) {
+                _histogram[i] = _get (&out[idx], 8);
+            }
+            for (pdboff_t i = 0 ; i < nbblocks ; i++, idx += 4) {
+                _checksums[i] = uint32_t (_get (&out[idx], 4));
+            }
+
+            return true;
+        }
+
+        // return a binary representation of the block index with the given
+        // offsets of all compressed blocks
+        static std::vector<uint8_t> serialize_index (const std::vector<pdboff_t>& index) {
+
+            std::vector<uint8_t> out;
+            out.reserve (8 * index.size ());
+            for (auto offset : index) {
+                _put (out, offset, 8);
+            }
+            return out;
+        }
+
+        // read the block index from the given stream, which must be
+        // positioned right at the offset of the values of a file of the given
+        // size with compressed values, and return true if it was successfully
+        // read. The offsets of every block relative to the end of the index
+        // are written in index. In case of error, false is returned and the
+        // error is written in in_error
+        bool deserialize_index (std::istream& in, const pdboff_t size,
+                                std::vector<pdboff_t>& index, in_error_message& in_error) const {
+
+            std::vector<uint8_t> out (get_index_bytes (), 0);
+            if (!in.read (reinterpret_cast<char*> (out.data ()), std::streamsize (out.size ()))) {
+                in_error = in_error_message::pdb_header_could_not_be_read;
+                return false;
+            }
+            index = std::vector<pdboff_t> (get_nbblocks () + 1, 0);
+            for (size_t i = 0 ; i < index.size () ; i++) {
+                index[i] = _get (&out[8*i], 8);
+            }
+
+            // blocks are never empty, and the last one ends right at the end
+            // of the file
+            for (size_t i = 1 ; i < index.size () ; i++) {
+                if (index[i] <= index[i-1]) {
+                    in_error = in_error_message::pdb_block_corrupted;
+                    return false;
+                }
+            }
+            if (index[0] || index.back () != size - _offset - get_index_bytes ()) {
+                in_error = in_error_message::pdb_block_corrupted;
+                return false;
+            }
+            return true;
+        }
+
+    }; // class header_t
+
+} // namespace pdb
+
+#endif // _PDBHEADER_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,256 @@
+// -*- coding: utf-8 -*-
+// PDBindex_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 19:41:27.604118273 (1792352487)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Index of PDBs stored in shards
+//
+
+#ifndef _PDBINDEX_T_H_
+#define _PDBINDEX_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<filesystem>
+#include<fstream>
+#include<istream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "../PDBdefs.h"
+#include "../utils/PDBcrc32c.h"
+
+namespace pdb {
+
+    // Class definition
+    //
+    // PDBs can be split into shards, each one storing a fixed range of
+    // consecutive locations in a separate file, so that they can be written
+    // and read independently. Every shard is a file with format v2 whose
+    // address space is the number of locations in the shard. The index
+    // describes the whole PDB and how it is split. The k-th shard stores
+    // the locations in the range [k*length, min ((k+1)*length, address
+    // space)), and it is found in the same path of the index followed by a
+    // dot and k.
+    //
+    // Indices are stored in little-endian with the following layout:
+    //
+    //    offset  size  contents
+    //         0     3  magic number "PDS"
+    //         3     1  version of the index (1)
+    //         4     1  mode: 0 (MAX) or 1 (ADD)
+    //         5     2  reserved
+    //         7     1  length of the permutations, n
+    //         8     8  address space, i.e., number of values of the PDB
+    //        16     8  number of locations in every shard
+    //        24     8  number of shards
+    //        32     4  CRC32C of the index, computed with this field zeroed
+    //        36     4  reserved
+    //        40     n  goal
+    //      40+n     n  p-pattern
+    //     40+2n     n  c-pattern
+    class index_t {
+
+    private:
+
+        // INVARIANT: indices record the description of the PDB and the
+        // number of locations stored in every shard
+        pdb_mode _mode;
+        std::vector<int> _goal;
+        std::string _p_pattern;
+        std::string _c_pattern;
+        pdboff_t _address_space;
+        pdboff_t _shard_length;
+
+        // append the given number of bytes of value in little-endian
+        static void _put (std::vector<uint8_t>& out, const uint64_t value, const int nbbytes) {
+            for (auto i = 0 ; i < nbbytes ; i++) {
+                out.push_back (uint8_t (value >> (8*i)));
+            }
+        }
+
+        // return the given number of bytes starting at in in little-endian
+        static uint64_t _get (const uint8_t* in, const int nbbytes) {
+            uint64_t value = 0;
+            for (auto i = 0 ; i < nbbytes ; i++) {
+                value |= uint64_t (in[i]) << (8*i);
+            }
+            return value;
+        }
+
+    public:
+
+        // magic number and version of the index
+        static constexpr uint8_t magic[3] = {'P', 'D', 'S'};
+        static constexpr uint8_t version = 1;
+
+        // number of bytes of the fixed part of the index
+        static constexpr size_t fixed_bytes = 40;
+
+        // by default, every shard stores 64 Mi locations
+        static constexpr pdboff_t default_shard_length = 64 * 1024 * 1024;
+
+        // Default constructor
+        index_t () :
+            _mode          { pdb_mode::max },
+            _address_space { 0 },
+            _shard_length  { default_shard_length }
+            { }
+
+        // Explicit constructor ---indices are created with the description of
+        // a PDB and the number of locations of every shard, which must be
+        // strictly positive
+        index_t (const pdb_mode mode, const std::vector<int>& goal,
+                 const std::string_view p_pattern, const std::string_view c_pattern,
+                 const pdboff_t address_space, const pdboff_t shard_length = default_shard_length) :
+            _mode          { mode },
+            _goal          { goal },
+            _p_pattern     { p_pattern },
+            _c_pattern     { c_pattern },
+            _address_space { address_space },
+            _shard_length  { shard_length }
+            {
+                if (!_shard_length) {
+                    throw std::invalid_argument (" [index_t] Shards can not be empty");
+                }
+            }
+
+        // getters
+        const pdb_mode get_mode () const { return _mode; }
+        const std::vector<int>& get_goal () const { return _goal; }
+        const std::string& get_ppattern () const { return _p_pattern; }
+        const std::string& get_cpattern () const { return _c_pattern; }
+        const pdboff_t get_address_space () const { return _address_space; }
+        const pdboff_t get_shard_length () const { return _shard_length; }
+
+        // return the number of shards
+        pdboff_t get_nbshards () const {
+            return (_address_space + _shard_length - 1) / _shard_length;
+        }
+
+        // return the first location stored in the given shard
+        pdboff_t get_first (const pdboff_t shard) const {
+            return shard * _shard_length;
+        }
+
+        // return the number of locations stored in the given shard
+        pdboff_t get_count (const pdboff_t shard) const {
+            return std::min (_shard_length, _address_space - get_first (shard));
+        }
+
+        // return the shard storing the given location
+        pdboff_t get_shard (const pdboff_t location) const {
+            return location / _shard_length;
+        }
+
+        // methods
+
+        // return the path of the given shard of the PDB whose index is found
+        // at the given path
+        static std::filesystem::path shard_path (const std::filesystem::path& path, const pdboff_t shard) {
+            return std::filesystem::path (path.string () + "." + std::to_string (shard));
+        }
+
+        // return true if the file found at the given path starts with the
+        // magic number of indices and false otherwise
+        static bool probe (const std::filesystem::path& path) {
+
+            std::ifstream in (path, std::ios::binary);
+            uint8_t hmagic[3];
+            return in.read (reinterpret_cast<char*> (hmagic), 3) && std::equal (magic, magic + 3, hmagic);
+        }
+
+        // return a binary representation of the index
+        std::vector<uint8_t> serialize () const {
+
+            std::vector<uint8_t> out;
+            out.reserve (fixed_bytes + 3 * _goal.size ());
+            for (auto i = 0 ; i < 3 ; i++) {
+                out.push_back (magic[i]);
+            }
+            out.push_back (version);
+            out.push_back (uint8_t (_mode == pdb_mode::max ? 0 : 1));
+            _put (out, 0, 2);                                           // reserved
+            out.push_back (uint8_t (_goal.size ()));
+            _put (out, _address_space, 8);
+            _put (out, _shard_length, 8);
+            _put (out, get_nbshards (), 8);
+            _put (out, 0, 4);                                // CRC32C of the index
+            _put (out, 0, 4);                                           // reserved
+            for (auto symbol : _goal) {
+                out.push_back (uint8_t (symbol));
+            }
+            out.insert (out.end (), _p_pattern.begin (), _p_pattern.end ());
+            out.insert (out.end (), _c_pattern.begin (), _c_pattern.end ());
+
+            // compute the checksum of the index and write it down in its
+            // location
+            uint32_t crc = crc32c (out.data (), out.size ());
+            for (auto i = 0 ; i < 4 ; i++) {
+                out[32+i] = uint8_t (crc >> (8*i));
+            }
+            return out;
+        }
+
+        // read an index from the given stream, which must be positioned right
+        // at its beginning, and return true if it was successfully read. In
+        // case of error, false is returned and the error is written in
+        // in_error
+        bool deserialize (std::istream& in, in_error_message& in_error) {
+
+            // read the fixed part of the index
+            std::vector<uint8_t> out (fixed_bytes, 0);
+            if (!in.read (reinterpret_cast<char*> (out.data ()), fixed_bytes)) {
+                in_error = in_error_message::pdb_header_could_not_be_read;
+                return false;
+            }
+            if (!std::equal (magic, magic + 3, out.begin ()) || out[3] != version || out[4] > 1) {
+                in_error = in_error_message::pdb_format_not_supported;
+                return false;
+            }
+            _mode = (out[4] == 0) ? pdb_mode::max : pdb_mode::add;
+            int n = out[7];
+            _address_space = _get (&out[8], 8);
+            _shard_length = _get (&out[16], 8);
+            pdboff_t nbshards = _get (&out[24], 8);
+            uint32_t crc = uint32_t (_get (&out[32], 4));
+
+            // read the variable part of the index
+            std::vector<uint8_t> body (3*n, 0);
+            if (!in.read (reinterpret_cast<char*> (body.data ()), 3*n)) {
+                in_error = in_error_message::pdb_header_could_not_be_read;
+                return false;
+            }
+
+            // verify its checksum and that the number of shards is
+            // consistent with the rest of the index
+            std::fill (out.begin () + 32, out.begin () + 36, 0);
+            if (crc32c (body.data (), body.size (), crc32c (out.data (), fixed_bytes)) != crc ||
+                !_shard_length || nbshards != get_nbshards ()) {
+                in_error = in_error_message::pdb_index_corrupted;
+                return false;
+            }
+
+            // and decode it
+            _goal = std::vector<int> (body.begin (), body.begin () + n);
+            _p_pattern = std::string (body.begin () + n, body.begin () + 2*n);
+            _c_pattern = std::string (body.begin () + 2*n, body.end ());
+
+            return true;
+        }
+
+    }; // class index_t
+
+} // namespace pdb
+
+#endif // _PDBINDEX_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
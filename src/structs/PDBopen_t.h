@@ -20,6 +20,7 @@
 #include<vector>
 
 #include "../PDBdefs.h"
+#include "PDBarena_t.h"
 #include "PDBnode_t.h"
 
 namespace pdb {
@@ -38,11 +39,16 @@ namespace pdb {
 
     private:
 
-        // INVARIANT: an open list consists of a vector of vectors of nodes of
+        // INVARIANT: an open list consists of a vector of buckets of nodes of
         // any underlying type satisfying the requirement pdb_type. All
         // operations preserve the range [mini,maxi] of values containing items
         // unless size=0 in which case mini=maxi=1
-        std::vector<std::vector<node_t<T>>> _queue; // f-indexes to the buckets
+        //
+        // Buckets store their nodes in chunks served by an arena shared among
+        // all of them, so that the chunks released by buckets being drained
+        // are reused by those being filled
+        arena_t<node_t<T>> _arena;            // chunks shared by all buckets
+        std::vector<bucket_t<node_t<T>>> _queue;  // f-indexes to the buckets
         size_t _size;                        // number of elements in the queue
         int _mini;                                             // minimum index
         int _maxi;                                             // maximum index
@@ -51,20 +57,23 @@ namespace pdb {
 
         // Default constructor
         open_t ():
-            _queue  { std::vector<std::vector<node_t<T>>> (1, std::vector<node_t<T>>() ) },
-            _size   { 0 },                              // there is only one bucket!
-            _mini   { 1 },        // INVARIANT: _mini and _maxi have to be above the
-            _maxi   { 1 }           // current number of items if the queue is empty
+            open_t (1)                                  // there is only one bucket!
             { }
 
         // Explicit constructor - it is also possible to create a bucket giving
-        // the initial number of buckets
-        explicit open_t (size_t capacity):
-            _queue  { std::vector<std::vector<node_t<T>>> (capacity, std::vector<node_t<T>>() ) },
+        // the initial number of buckets, and also the number of nodes stored
+        // in every chunk of the arena
+        explicit open_t (size_t capacity,
+                         size_t chunk_size = std::max (size_t (1), arena_t<node_t<T>>::default_chunk_bytes / sizeof (node_t<T>))):
+            _arena  { chunk_size },
             _size   { 0 },
             _mini   { 1 },       // INVARIANT: _mini and _maxi have to be above the
             _maxi   { 1 }          // current number of items if the queue is empty
-            { }
+            {
+                while (_queue.size () < capacity) {
+                    _queue.emplace_back (_arena);
+                }
+            }
 
         // Copy and assignment constructors are explicitly forbidden
         open_t (const open_t&) = delete;
@@ -86,6 +95,15 @@ namespace pdb {
         const int get_maxi () const
             { return _maxi; }
 
+        // return the number of bytes in the chunks currently storing nodes
+        const size_t get_live_bytes () const
+            { return _arena.get_live_bytes (); }
+
+        // return the number of bytes in all chunks allocated, either storing
+        // nodes or available for reuse
+        const size_t get_reserved_bytes () const
+            { return _arena.get_reserved_bytes (); }
+
         // set accessors
 
         // set the number of buckets to the value specified. In case the number of
@@ -136,7 +154,9 @@ namespace pdb {
         while (sz < nbbuckets) {
             sz *= 2;
         }
-        _queue.resize (sz);
+        while (_queue.size () < sz) {
+            _queue.emplace_back (_arena);
+        }
 
         // and return the current number of buckets
         return _queue.size ();
@@ -14,15 +14,20 @@
 #define _PDBPDB_T_H_
 
 #include<algorithm>
+#include<atomic>
 #include<iostream>
 #include<iterator>
 #include<memory>
+#include<span>
+#include<stdexcept>
 #include<string>
 #include<utility>
 #include<vector>
 
 #include "../PDBdefs.h"
 #include "PDBnode_t.h"
+#include "PDBregion_t.h"
+#include "../utils/PDBnuma.h"
 
 namespace pdb {
 
@@ -41,14 +46,39 @@ namespace pdb {
     private:
 
         // INVARIANT: Because the number of items to store is known in advance
-        // and a perfect hashing function is used, PDBs are implemented as a
-        // vector of pdbval_t so that:
+        // and a perfect hashing function is used, PDBs are implemented as an
+        // array of _length values so that:
         //
         //    1. Non-empty positions contain their g*-value
         //    2. Empty entries are represented with pdbzero
         //    3. Non-existing positions are associated with the index
         //       string::npos
-        std::vector<pdbval_t> _address;
+        //
+        // The array is stored in a region which is either anonymous memory
+        // or a writable view of the output file (when generating PDBs), or a
+        // read-only view of a file (when mapping PDBs)
+        region_t _region;
+        uint8_t* _address;
+        pdboff_t _length;
+
+        // Once the PDB is complete, it can be copied to every NUMA node (see
+        // 'replicate'), so that lookups are served from the copy of the node
+        // of the calling thread
+        std::vector<region_t> _replicas;
+
+        // Values are stored in the array with an encoding (see pdb_encoding)
+        // so that, if they take no more than one byte, the i-th value is
+        // found in the byte i >> _eshift, at the bit (i & _emask) << _bshift,
+        // and it takes the bits in _vmask. With byte encoding, these are
+        // simply the i-th byte and all its bits. This way, values are
+        // accessed without branching on the encoding. Wider values (_wide)
+        // take two consecutive bytes instead (see encoding_get)
+        pdb_encoding _encoding;
+        int _eshift;
+        pdboff_t _emask;
+        int _bshift;
+        pdbval_t _vmask;
+        bool _wide;
 
         // The container also counts the number of items stored and the length
         // of the permutations considered
@@ -79,8 +109,110 @@ namespace pdb {
         //    2. Operator masking (_omask): stores for every symbol preserved
         //       its location in the partial permutation that is used to
         //       automatically compute a rank
+        //
+        //    3. Preserved symbols (_symbols): those symbols whose entry in
+        //       _omask is not negative, so that permutations can be ranked
+        //       from their inverse without traversing all symbols
+        //
+        //    4. Goal locations (_location): stores for every symbol its
+        //       location in the goal, so that dual states can be computed
         int _nbsymbols;
         std::vector<int> _omask;
+        std::vector<int> _symbols;
+        std::vector<int> _location;
+
+        // return the rank of the partial permutation p, where p[i] is the
+        // location of the symbol pushed to the i-th position, and q is its
+        // inverse. Both are modified
+        pdboff_t _rank (std::vector<int>& p, std::vector<int>& q) const {
+
+            // initialize the rank of the permutation to 0 and also the series of
+            // factors to use
+            pdboff_t r = 0L;
+            pdboff_t f = 1L;
+
+            int n = _n;
+            int s, w;
+            while (n > _n - _nbsymbols) {
+
+                // take the last element from the permutation and swap n-1 and
+                // q[n-1] in p
+                s = p[n-1];
+                w = p[n-1]; p[n-1] = p[q[n-1]]; p[q[n-1]] = w;
+
+                // next, swap s and n-1 in q
+                w = q[s]; q[s] = q[n-1]; q[n-1]=w;
+
+                // update the ranking
+                r += s*f; f *= n;
+
+                // and decrement the count of symbols to compute
+                n--;
+            }
+            return r;
+        }
+
+        // return the address of the values looked up by the calling thread,
+        // i.e., those of its NUMA node if the PDB has been replicated. Nodes
+        // without a copy use the first one
+        const uint8_t* _local () const {
+            if (_replicas.empty ()) {
+                return _address;
+            }
+            const size_t node = size_t (numa_node ());
+            return _replicas[(node < _replicas.size ()) ? node : 0].data ();
+        }
+
+        // set the encoding of the values and the information derived from it
+        void _encode (const pdb_encoding encoding) {
+            _encoding = encoding;
+            _wide = encoding_bits (encoding) > 8;
+            _bshift = (encoding == pdb_encoding::mod3) ? 1 : (encoding == pdb_encoding::nibble) ? 2 : 3;
+            _eshift = 3 - _bshift;
+            _emask = (pdboff_t (1) << _eshift) - 1;
+            _vmask = encoding_max (encoding);
+        }
+
+        // write the given value at the given location without any
+        // synchronization. In case the value can not be stored with the
+        // encoding of this PDB, an exception is raised. In case the index is
+        // incorrect, the behaviour is undefined
+        void _set (const pdboff_t index, const pdbval_t value) {
+
+            if (value > _vmask) {
+                throw std::out_of_range (" [pdb_t] Value out of the range of the encoding");
+            }
+            if (_wide) {
+                encoding_set (_address, index, value, _encoding);
+                return;
+            }
+            uint8_t& byte = _address[index >> _eshift];
+            const int shift = int ((index & _emask) << _bshift);
+            byte = uint8_t ((byte & ~(_vmask << shift)) | (value << shift));
+        }
+
+        // write the given value in the entry given with an atomic reference
+        // at the given shift only if it is empty or it stores a larger value,
+        // with a compare-and-swap of the whole entry. It returns true if the
+        // value was written and false otherwise
+        template<typename U>
+        bool _update (std::atomic_ref<U> entry, const int shift, const pdbval_t value) {
+
+            U current = entry.load (std::memory_order_relaxed);
+            pdbval_t previous;
+            while ((previous = pdbval_t ((current >> shift) & _vmask)) == pdbzero || value < previous) {
+                U desired = U ((current & ~(_vmask << shift)) | (value << shift));
+                if (entry.compare_exchange_weak (current, desired, std::memory_order_relaxed)) {
+
+                    // count this item only if the location was empty
+                    if (previous == pdbzero) {
+                        std::atomic_ref<size_t> (_size).fetch_add (1, std::memory_order_relaxed);
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
 
     public:
 
@@ -88,11 +220,39 @@ namespace pdb {
         pdb_t () = delete;
 
         // Explicit constructor ---it is mandatory to provide the number of
-        // items that will be stored in the PDB
-        explicit pdb_t (const pdboff_t size) :
-            _address { std::vector<pdbval_t>(size, pdbzero) },
+        // items that will be stored in the PDB. All of them are initialized
+        // with pdbzero. By default, every value takes one byte. Values are
+        // stored in anonymous memory backed with the given pages, and
+        // interleaved among all NUMA nodes if requested. Otherwise, pages are
+        // allocated in the node of the thread which first writes them
+        explicit pdb_t (const pdboff_t size, const pdb_encoding encoding = pdb_encoding::byte,
+                        const pdb_pages pages = pdb_pages::normal,
+                        const pdb_placement placement = pdb_placement::local) :
+            _length { size },
+            _size { 0 }
+            {
+                _encode (encoding);
+                _region.allocate (encoding_bytes (encoding, size), false, pages);
+                if (placement == pdb_placement::interleave) {
+                    _region.interleave ();
+                }
+                _address = reinterpret_cast<uint8_t*> (_region.data ());
+            }
+
+        // Explicit constructor ---PDBs can be also created over an existing
+        // region, e.g., a file mapped in memory, storing values with the given
+        // encoding. If the number of values is not given, the region is
+        // assumed to be full. If the region is read-only, then the PDB can not
+        // be modified
+        explicit pdb_t (region_t&& region, const pdb_encoding encoding = pdb_encoding::byte,
+                        const pdboff_t length = 0) :
+            _region { std::move (region) },
             _size { 0 }
-            {}
+            {
+                _encode (encoding);
+                _address = reinterpret_cast<uint8_t*> (_region.data ());
+                _length = length ? length : (_region.size () * 8 / encoding_bits (encoding));
+            }
 
         // Copy and assignment constructors are explicitly forbidden
         pdb_t (const pdb_t&) = delete;
@@ -106,27 +266,70 @@ namespace pdb {
         int get_n () const {
             return _n;
         }
-        const std::vector<pdbval_t>& get_address () const {
-            return _address;
+        const pdb_encoding get_encoding () const {
+            return _encoding;
         }
 
-        // operator overloading
+        // return a view of the bytes storing all values, packed according to
+        // the encoding of this PDB
+        const std::span<const uint8_t> get_address () const {
+            return std::span<const uint8_t> (_address, encoding_bytes (_encoding, _length));
+        }
+        const region_t& get_region () const {
+            return _region;
+        }
 
-        // given a stable index, return the value stored at that location. In
-        // case the index is incorrect, the behaviour is undefined
-        const pdbval_t& operator[] (const pdboff_t index) const {
-            return _address[index];
+        // return the number of copies made with 'replicate', or zero if the
+        // PDB has not been replicated
+        size_t get_nbreplicas () const {
+            return _replicas.size ();
         }
 
-        // given a stable index, return a reference to its location, so that it
-        // can be re-written. In case the index is incorrect, an exception is
+        // return a writable view of the bytes storing all values of the PDB,
+        // e.g., to populate it in bulk. Values are packed according to the
+        // encoding of this PDB. In case the PDB is read-only, an exception is
         // raised
-        pdbval_t& operator[] (const pdboff_t index) {
-            return _address.at (index);
+        std::span<uint8_t> get_storage () {
+            if (_region.readonly ()) {
+                throw std::runtime_error (" [pdb_t] Write access to a read-only PDB");
+            }
+            return std::span<uint8_t> (_address, encoding_bytes (_encoding, _length));
+        }
+
+        // operator overloading
+
+        // given a stable index, return the value stored at that location. It
+        // takes only a shift and a mask regardless of the encoding, unless
+        // values are wider than one byte. If the PDB has been replicated, the
+        // copy of the NUMA node of the calling thread is used. In case the
+        // index is incorrect, the behaviour is undefined
+        pdbval_t operator[] (const pdboff_t index) const {
+            const uint8_t* address = _local ();
+            if (_wide) {
+                return encoding_get (address, index, _encoding);
+            }
+            return pdbval_t ((address[index >> _eshift] >> ((index & _emask) << _bshift)) & _vmask);
         }
 
         // methods
 
+        // given a stable index, return a reference to its location, so that it
+        // can be re-written. In case the index is incorrect, the PDB is
+        // read-only, or its values are not stored in bytes, an exception is
+        // raised. Values are read with operator[] instead
+        uint8_t& ref (const pdboff_t index) {
+            if (_region.readonly ()) {
+                throw std::runtime_error (" [pdb_t] Write access to a read-only PDB");
+            }
+            if (_encoding != pdb_encoding::byte) {
+                throw std::runtime_error (" [pdb_t] Only values stored in bytes can be referenced");
+            }
+            if (index >= _length) {
+                throw std::out_of_range (" [pdb_t] Access out of bounds");
+            }
+            return _address[index];
+        }
+
         // return the size of the address space required to store all
         // permutations that result from abstracting n symbols with the given
         // pattern, where n is the length of the pattern, and the number of
@@ -230,7 +433,14 @@ namespace pdb {
             // they point nowhere
             _omask = std::vector<int> (1 + *max_symb, -1);
 
+            // and the location of every symbol in the goal
+            _location = std::vector<int> (1 + *max_symb, -1);
+            for (auto i = 0 ; i < int (goal.size ()) ; i++) {
+                _location[goal[i]] = i;
+            }
+
             // Finally, compute the map from symbols to locations
+            _symbols.clear ();
             int j = 0;
             for (auto i = 0 ; i < int (pattern.size ()) ; i++) {
                 if (pattern[i] == '-') {
@@ -241,6 +451,7 @@ namespace pdb {
                     // pushed to the end and it is used to compute the location
                     // of the next symbol in the permutations to rank.
                     _omask[goal[i]] = int (pattern.size ()) - _nbsymbols + j;
+                    _symbols.push_back (goal[i]);
                     j++;
                 } else if (pattern[i] == '*') {
 
@@ -265,22 +476,115 @@ namespace pdb {
             // Insert this item at the right location (just simply by storing
             // its g-value, which is a service provided by node_t) and
             // increment the count of the number of alive items in the PDB
-            _address[index] = item.get_g ();
+            _set (index, item.get_g ());
             _size++;
 
             // and return the location of this item into the vector
             return index;
         }
 
+        // insert the given value at the location given by a stable index, and
+        // return it. In case the value can not be stored with the encoding of
+        // this PDB, an exception is raised. In case the index is incorrect,
+        // the behaviour is undefined
+        pdboff_t insert (const pdboff_t index, const pdbval_t value) {
+            _set (index, value);
+            _size++;
+            return index;
+        }
+
+        // Thread-safe version of 'insert': the value is written at the given
+        // location only if it is empty or it stores a larger value. It returns
+        // true if the value was written and false otherwise. The number of
+        // items is incremented only when an empty location is written. Values
+        // packed in the same byte are updated with a compare-and-swap of the
+        // whole byte, so that concurrent updates of neighbour locations are
+        // never lost. Values stored in words are updated with a
+        // compare-and-swap of the word, which assumes a little-endian host,
+        // whereas values encoded in twelve bits can not be updated this way,
+        // since they do not start at a byte boundary. In case the value can
+        // not be stored with the encoding of this PDB, or it is encoded in
+        // twelve bits, an exception is raised. In case the index is
+        // incorrect, the behaviour is undefined
+        bool update (const pdboff_t index, const pdbval_t value) {
+
+            if (value > _vmask) {
+                throw std::out_of_range (" [pdb_t] Value out of the range of the encoding");
+            }
+            if (_encoding == pdb_encoding::word) {
+                return _update (std::atomic_ref<uint16_t> (reinterpret_cast<uint16_t*> (_address)[index]), 0, value);
+            }
+            if (_wide) {
+                throw std::runtime_error (" [pdb_t] Values encoded in twelve bits can not be updated concurrently");
+            }
+            return _update (std::atomic_ref<uint8_t> (_address[index >> _eshift]),
+                            int ((index & _emask) << _bshift), value);
+        }
+
+        // Thread-safe version of operator[]: return the value stored at the
+        // given location. Values encoded in twelve bits are not read
+        // atomically. In case the index is incorrect, the behaviour is
+        // undefined
+        pdbval_t load (const pdboff_t index) const {
+            if (_encoding == pdb_encoding::word) {
+                return std::atomic_ref<uint16_t> (reinterpret_cast<uint16_t*> (_address)[index]).load (std::memory_order_relaxed);
+            }
+            if (_wide) {
+                return (*this)[index];
+            }
+            uint8_t byte = std::atomic_ref<uint8_t> (_address[index >> _eshift]).load (std::memory_order_relaxed);
+            return pdbval_t ((byte >> ((index & _emask) << _bshift)) & _vmask);
+        }
+
+        // write all changes to the file backing this PDB, if any, and return
+        // true if the operation was successful and false otherwise
+        bool sync () {
+            return _region.sync ();
+        }
+
+        // copy the values of this PDB to every one of the given NUMA nodes,
+        // so that subsequent lookups with operator[] and 'at' are served from
+        // the copy of the node of the calling thread instead of crossing the
+        // interconnect. Copies are backed with the same pages of the PDB, and
+        // they are made only once it is complete, because later changes are
+        // not propagated to them. It returns true if all copies were
+        // allocated in their node and false otherwise, e.g., if the kernel
+        // has no NUMA support, though lookups are correct anyway
+        bool replicate (const int nbnodes = numa_nodes ()) {
+
+            _replicas.clear ();
+            const pdb_pages pages = (_region.readonly ()) ? pdb_pages::normal : _region.pages ();
+            const auto values = get_address ();
+            bool placed = true;
+            for (auto node = 0 ; node < nbnodes ; node++) {
+
+                // pages are bound to the node before they are first written
+                region_t replica;
+                replica.allocate (values.size (), false, pages);
+                placed = replica.bind (node) && placed;
+                std::copy (values.begin (), values.end (), replica.data ());
+                _replicas.push_back (std::move (replica));
+            }
+            return placed;
+        }
+
+        // issue a prefetch of the byte storing the value at the given
+        // location, so that it is likely found in the cache when it is later
+        // looked up. It never faults, even if the index is incorrect
+        void prefetch (const pdboff_t index) const {
+            const pdboff_t byte = _wide ? (index * encoding_bits (_encoding)) >> 3 : index >> _eshift;
+            __builtin_prefetch (_local () + byte, 0, 0);
+        }
+
         // given a stable index, return the value stored at that location. In
         // case the index is incorrect, an exception is raised
-        pdbval_t at (const pdboff_t index) {
+        pdbval_t at (const pdboff_t index) const {
 
             // Bound check
-            if (index >= _address.size ()) {
+            if (index >= _length) {
                 throw std::runtime_error (" [pdb_t] Access out of bounds");
             }
-            return _address[index];
+            return (*this)[index];
         }
 
         // return a stable index to the item given (as a node_t) in case it is
@@ -292,7 +596,7 @@ namespace pdb {
 
             // in case this location has not been written yet, return
             // string::npos
-            if (_address[index] == pdbzero) {
+            if ((*this)[index] == pdbzero) {
                 return std::string::npos;
             }
 
@@ -306,7 +610,7 @@ namespace pdb {
         // permutations, i.e., it accepts NONPAT in perm. In case any symbol in
         // perm is NONPAT it is copied to the output as NONPAT as well in spite
         // of the pattern
-        std::vector<int> mask (const std::vector<int>& perm) {
+        std::vector<int> mask (const std::vector<int>& perm) const {
 
             // first of all, verify the given permutation has the same size used
             // to initialize this pdb
@@ -350,11 +654,6 @@ namespace pdb {
                 throw std::invalid_argument (" [rank] The permutation has not the length used in the initialization of this PDB");
             }
 
-            // initialize the rank of the permutation to 0 and also the series of
-            // factors to use
-            pdboff_t r = 0L;
-            pdboff_t f = 1L;
-
             // create the (partial) permutation to rank, and compute also its
             // inverse. Because the pattern is given in a partial permutation, all
             // non-abstracted symbols are pushed to the end of the permutation
@@ -390,35 +689,136 @@ namespace pdb {
                 throw std::runtime_error (" [rank] nbsymbols != _nbsymbols");
             }
 
-            // compute the rank
-            int n = _n;
-            int s, w;
-            while (n > _n - _nbsymbols) {
+            // and compute the rank
+            return _rank (p, q);
+        }
 
-                // take the last element from the permutation and swap n-1 and
-                // q[n-1] in p
-                s = p[n-1];
-                w = p[n-1]; p[n-1] = p[q[n-1]]; p[q[n-1]] = w;
+        // write in inverse the location of every symbol in the given
+        // permutation, i.e., inverse[perm[i]] = i. Symbols which do not
+        // appear in it, and those abstracted away (NONPAT) are located at
+        // -1. The inverse can be ranked with 'rank_inverse' by any PDB
+        // initialized with the same goal, so that several PDBs can share it
+        void invert (const std::vector<int>& perm, std::vector<int>& inverse) const {
 
-                // next, swap s and n-1 in q
-                w = q[s]; q[s] = q[n-1]; q[n-1]=w;
+            // verify the given permutation has the same size used to
+            // initialize this pdb
+            if (_n != perm.size ()) {
+                throw std::invalid_argument (" [invert] The permutation has not the length used in the initialization of this PDB");
+            }
+            inverse.assign (_omask.size (), -1);
+            for (auto i = 0 ; i < _n ; i++) {
+                if (perm[i] != pdb::NONPAT) {
+                    inverse[perm[i]] = i;
+                }
+            }
+        }
 
-                // update the ranking
-                r += s*f; f *= n;
+        // write in inverse the location of every symbol in the given
+        // permutation, and in dual the location of every symbol in its dual
+        // state (see 'dual'). Both are computed in the same pass, and they
+        // can be ranked with 'rank_inverse' by any PDB initialized with the
+        // same goal. Only full permutations have a dual state, and thus an
+        // exception is raised if the permutation contains NONPAT
+        void invert (const std::vector<int>& perm, std::vector<int>& inverse, std::vector<int>& dual) const {
 
-                // and decrement the count of symbols to compute
-                n--;
+            if (_n != perm.size ()) {
+                throw std::invalid_argument (" [invert] The permutation has not the length used in the initialization of this PDB");
             }
-            return r;
+            inverse.assign (_omask.size (), -1);
+            dual.assign (_omask.size (), -1);
+            for (auto i = 0 ; i < _n ; i++) {
+                if (perm[i] == pdb::NONPAT) {
+                    throw std::invalid_argument (" [invert] Only full permutations have a dual state");
+                }
+
+                // the symbol at the i-th location of the goal is found in the
+                // dual state where the symbol at the i-th location of the
+                // permutation is found in the goal
+                inverse[perm[i]] = i;
+                dual[_goal[i]] = _location[perm[i]];
+            }
+        }
+
+        // return the dual state of the given full permutation: if perm has
+        // the symbol x at location i, then its dual has the i-th symbol of
+        // the goal at the location of x in the goal. If the goal is the
+        // identity, the dual is the inverse of perm. When operators move
+        // symbols between locations regardless of them, the sequence of
+        // operators which solves perm, reversed and inverted, solves its
+        // dual, so that both are equally distant from the goal if the
+        // inverse of every operator is also an operator with the same cost
+        std::vector<int> dual (const std::vector<int>& perm) const {
+
+            std::vector<int> inverse, dual;
+            invert (perm, inverse, dual);
+            std::vector<int> result (_n);
+            for (auto i = 0 ; i < _n ; i++) {
+                result[dual[_goal[i]]] = _goal[i];
+            }
+            return result;
+        }
+
+        // return true if the given symbol is preserved by the pattern of this
+        // PDB, and false otherwise, e.g., if it is NONPAT or it does not
+        // appear in the goal
+        bool preserves (const int symbol) const {
+            return symbol >= 0 && symbol < int (_omask.size ()) && _omask[symbol] >= 0;
+        }
+
+        // return the same rank than 'rank' for the permutation whose inverse
+        // is given, as computed by 'invert'. Only the preserved symbols are
+        // visited. In case the inverse was not computed with the same goal
+        // used to initialize this PDB, the behaviour is undefined
+        pdboff_t rank_inverse (const std::vector<int>& inverse) const {
+
+            // create the (partial) permutation to rank and its inverse
+            // straight from the locations of the preserved symbols
+            std::vector<int> p (_n);
+            std::vector<int> q (_n);
+            for (auto symbol : _symbols) {
+                p[_omask[symbol]] = inverse[symbol];
+                q[inverse[symbol]] = _omask[symbol];
+            }
+            return _rank (p, q);
+        }
+
+        // return the (partial) permutation whose rank is the given one, i.e.,
+        // the inverse of 'rank'. Symbols abstracted away are represented with
+        // the constant NONPAT. In case the rank exceeds the address space
+        // induced by the pattern, the behaviour is undefined
+        std::vector<int> unrank (pdboff_t r) const {
+
+            // unrank the locations of the preserved symbols with the
+            // iterative implementation of Myrvold&Ruskey unranking function.
+            // It is the reverse of the loop in 'rank', so that the symbol
+            // stored at the i-th position of the partial permutation (i>=
+            // _n-_nbsymbols) is found at location p[i]
+            std::vector<int> p (_n);
+            for (auto i = 0 ; i < _n ; i++) {
+                p[i] = i;
+            }
+            for (auto n = _n ; n > _n - _nbsymbols ; n--) {
+                std::swap (p[n-1], p[r % n]);
+                r /= n;
+            }
+
+            // and write every preserved symbol at its location
+            std::vector<int> perm (_n, int (NONPAT));
+            for (auto symbol = 0 ; symbol < int (_omask.size ()) ; symbol++) {
+                if (_omask[symbol] >= 0) {
+                    perm[p[_omask[symbol]]] = symbol;
+                }
+            }
+            return perm;
         }
 
         // return the number of available positions in the PDB
         size_t capacity () const {
-            return _address.capacity ();
+            return _length;
         }
 
         // return the number of elements written into the PDB. Note this value
-        // refers to the number of times insert was used because the operator[]
+        // refers to the number of times insert was used because ref
         // can also be used to write data but it does not update the data member
         // _size
         size_t size () const
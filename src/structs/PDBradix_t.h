@@ -0,0 +1,191 @@
+// -*- coding: utf-8 -*-
+// PDBradix_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 13:48:52.190447613 (1792331332)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of a radix heap for storing nodes
+//
+
+#ifndef _PDBRADIX_T_H_
+#define _PDBRADIX_T_H_
+
+#include<bit>
+#include<limits>
+#include<stddef.h>
+#include<stdexcept>
+#include<vector>
+
+#include "../PDBdefs.h"
+#include "PDBnode_t.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename NodeT>
+    class radix_t;
+
+    // Class definition
+    //
+    // Radix heaps are monotone open lists: once a node has been extracted, no
+    // node with a lower g-value can be inserted. Unlike open_t and ring_t,
+    // the number of buckets does not depend on the range of g-values but on
+    // the number of bits used to represent them, so that they are better
+    // suited for domains with a wide range of operator costs. They provide
+    // the same services than open_t
+    template<typename T>
+    requires pdb_type<T>
+    class radix_t<node_t<T>> {
+
+    private:
+
+        // INVARIANT: a radix heap consists of 1 + digits(pdbval_t) buckets.
+        // The first bucket contains all nodes whose g-value equals the g-value
+        // of the last node extracted, last; the i-th bucket (i>0) contains all
+        // nodes whose g-value differs from last in the (i-1)-th bit as the
+        // most significant one. Thus, the minimum g-value is always found in
+        // the first non-empty bucket
+        std::vector<std::vector<node_t<T>>> _queue;
+        size_t _size;                        // number of elements in the queue
+        int _last;                     // index of the last element extracted
+
+        // return the bucket where a node with the given g-value is stored
+        size_t _bucket (const int idx) const {
+            return std::bit_width (unsigned (idx ^ _last));
+        }
+
+        // return the index of the first non-empty bucket. If the heap is
+        // empty, the number of buckets is returned
+        size_t _first () const {
+            size_t i = 0;
+            while (i < _queue.size () && !_queue[i].size ()) {
+                i++;
+            }
+            return i;
+        }
+
+        // return the position within the i-th bucket of the node with the
+        // minimum g-value
+        size_t _argmin (const size_t i) const {
+            size_t loc = 0;
+            for (size_t j = 1 ; j < _queue[i].size () ; j++) {
+                if (_queue[i][j].get_g () < _queue[i][loc].get_g ()) {
+                    loc = j;
+                }
+            }
+            return loc;
+        }
+
+        // ensure the first bucket is not empty, unless the heap is empty, by
+        // redistributing the contents of the first non-empty bucket with
+        // respect to its minimum g-value. Because last is updated, this must
+        // be done only when a node is about to be extracted
+        void _refill () {
+
+            size_t i = _first ();
+            if (!i || i == _queue.size ()) {
+                return;
+            }
+
+            // update last with the minimum g-value in this bucket and
+            // redistribute all its items. Because all of them agree with the
+            // new value of last in all bits above the (i-1)-th one, they are
+            // all moved to buckets with a lower index
+            _last = _queue[i][_argmin (i)].get_g ();
+            std::vector<node_t<T>> bucket;
+            bucket.swap (_queue[i]);
+            for (auto& item : bucket) {
+                _queue[_bucket (item.get_g ())].push_back (std::move (item));
+            }
+        }
+
+    public:
+
+        // Default constructor
+        radix_t ():
+            _queue  { std::vector<std::vector<node_t<T>>> (1 + std::numeric_limits<pdbval_t>::digits,
+                                                            std::vector<node_t<T>>() ) },
+            _size   { 0 },
+            _last   { 0 }
+            { }
+
+        // Copy and assignment constructors are explicitly forbidden
+        radix_t (const radix_t&) = delete;
+        radix_t (radix_t&&) = delete;
+
+        // Assignment and move operators are disallowed as well
+        radix_t& operator=(const radix_t&) = delete;
+        radix_t& operator=(radix_t&&) = delete;
+
+        // get accessors
+        const size_t get_nbbuckets () const
+            { return _queue.size (); }
+        const size_t size () const
+            { return _size; }
+
+        // return the minimum g-value among all nodes stored in the heap. If
+        // the heap is empty, the g-value of the last node extracted is
+        // returned. Note that the heap is not modified, so that nodes with a
+        // g-value between the last node extracted and the one returned can
+        // be still inserted
+        const int get_mini () const {
+            size_t i = _first ();
+            return (!i || i == _queue.size ()) ? _last : int (_queue[i][_argmin (i)].get_g ());
+        }
+
+        // methods
+
+        // add the given item to the bucket corresponding to its g-value. It
+        // returns true if the operation was successful. In case the g-value
+        // is less than the g-value of the last node extracted, an exception
+        // is raised
+        bool insert (const node_t<T>& item) {
+
+            int idx = item.get_g ();
+            if (idx < _last) {
+                throw std::domain_error ("[radix_t::insert] Radix heaps are monotone!");
+            }
+            _queue[_bucket (idx)].push_back (item);
+            _size++;
+
+            // exit with success
+            return true;
+        }
+
+        // pop_front extracts the first item with the minimum index. If the
+        // heap is empty an exception is thrown
+        node_t<T> pop_front () {
+
+            if (!_size) {
+                throw std::domain_error ("[radix_t::pop_front] The heap is empty!");
+            }
+
+            // the minimum is always found in the first bucket once it has
+            // been refilled
+            _refill ();
+            node_t<T> item = std::move (_queue[0].back ());
+            _queue[0].pop_back ();
+            _size--;
+
+            return item;
+        }
+
+        // returns the first element without popping it
+        node_t<T> front () const {
+            size_t i = _first ();
+            return (!i) ? _queue[0].back () : _queue[i][_argmin (i)];
+        }
+
+    }; // class radix_t<node_t<T>>
+
+} // namespace pdb
+
+#endif // _PDBRADIX_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,376 @@
+// -*- coding: utf-8 -*-
+// PDBregion_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 16:08:31.660938114 (1792339711)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of regions of memory used to store the contents of PDBs
+//
+
+#ifndef _PDBREGION_T_H_
+#define _PDBREGION_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<filesystem>
+#include<new>
+#include<stddef.h>
+#include<utility>
+
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+#include "../PDBdefs.h"
+#include "../utils/PDBnuma.h"
+
+namespace pdb {
+
+    // Class definition
+    //
+    // Regions own a contiguous block of bytes which is either anonymous
+    // memory, zero-initialized and writable (and optionally shared with child
+    // processes), a writable view of a file being created, or a read-only
+    // view of an existing file. In the last case, the mapping is shared so
+    // that all processes mapping the same file in the same host share the
+    // same pages of the page cache. Anonymous memory can be backed with
+    // huge pages (see pdb_pages) and its pages can be placed in specific NUMA
+    // nodes (see 'interleave' and 'bind').
+    // Memory is automatically returned to the system when the region is
+    // destroyed
+    class region_t {
+
+    private:
+
+        // INVARIANT: the mapping starts at _base and has _mapped bytes. The
+        // contents of the region are the _length bytes starting at _data,
+        // which lies within the mapping. Mappings of files start at the
+        // beginning of a page (because mmap requires offsets to be aligned to
+        // the page size), and _data skips the bytes not belonging to the
+        // region
+        void* _base;
+        size_t _mapped;
+        uint8_t* _data;
+        size_t _length;
+        bool _readonly;
+
+        // pages actually backing the region, which might differ from those
+        // requested if huge pages were not available
+        pdb_pages _pages;
+
+    public:
+
+        // Default constructor ---regions are created empty
+        region_t () :
+            _base     { nullptr },
+            _mapped   {       0 },
+            _data     { nullptr },
+            _length   {       0 },
+            _readonly {   false },
+            _pages    { pdb_pages::normal }
+            { }
+
+        // Copy constructors and assignments are explicitly forbidden
+        region_t (const region_t&) = delete;
+        region_t& operator=(const region_t&) = delete;
+
+        // regions can be moved, transferring the ownership of the mapping
+        region_t (region_t&& other) noexcept :
+            _base     { std::exchange (other._base, nullptr) },
+            _mapped   { std::exchange (other._mapped, 0) },
+            _data     { std::exchange (other._data, nullptr) },
+            _length   { std::exchange (other._length, 0) },
+            _readonly { std::exchange (other._readonly, false) },
+            _pages    { std::exchange (other._pages, pdb_pages::normal) }
+            { }
+        region_t& operator=(region_t&& other) noexcept {
+            if (this != &other) {
+                release ();
+                _base = std::exchange (other._base, nullptr);
+                _mapped = std::exchange (other._mapped, 0);
+                _data = std::exchange (other._data, nullptr);
+                _length = std::exchange (other._length, 0);
+                _readonly = std::exchange (other._readonly, false);
+                _pages = std::exchange (other._pages, pdb_pages::normal);
+            }
+            return *this;
+        }
+
+        // the destructor unmaps the region
+        ~region_t () {
+            release ();
+        }
+
+        // getters
+        uint8_t* data () {
+            return _data;
+        }
+        const uint8_t* data () const {
+            return _data;
+        }
+        size_t size () const {
+            return _length;
+        }
+        bool readonly () const {
+            return _readonly;
+        }
+        pdb_pages pages () const {
+            return _pages;
+        }
+
+        // return the size in bytes of the given pages
+        static size_t page_size (const pdb_pages pages) {
+            switch (pages) {
+                case pdb_pages::transparent:
+                case pdb_pages::huge_2m:
+                    return size_t (1) << 21;
+                case pdb_pages::huge_1g:
+                    return size_t (1) << 30;
+                default:
+                    return size_t (sysconf (_SC_PAGESIZE));
+            }
+        }
+
+        // methods
+
+        // create an anonymous writable region of length bytes, all of them
+        // initialized to zero. Pages are not committed until they are first
+        // written. If shared is true, the region is shared with all child
+        // processes created with fork afterwards, so that they can
+        // communicate through it. The region is backed with the given pages,
+        // rounding its length up to a multiple of their size. If explicit
+        // huge pages can not be allocated, transparent huge pages are used
+        // instead, and if these are not supported, normal pages are used, so
+        // that 'pages' returns the pages actually used. In case the memory
+        // can not be allocated, bad_alloc is raised
+        void allocate (const size_t length, const bool shared = false,
+                       const pdb_pages pages = pdb_pages::normal) {
+
+            release ();
+            if (!length) {
+                return;
+            }
+            const int flags = (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_ANONYMOUS;
+
+            // explicit huge pages are taken from the pool of the given size
+            if (pages == pdb_pages::huge_2m || pages == pdb_pages::huge_1g) {
+                const size_t page = page_size (pages);
+                const size_t mapped = (length + page - 1) / page * page;
+                const int log2 = (pages == pdb_pages::huge_2m) ? 21 : 30;
+                void* base = mmap (nullptr, mapped, PROT_READ | PROT_WRITE,
+                                   flags | MAP_HUGETLB | (log2 << MAP_HUGE_SHIFT), -1, 0);
+                if (base != MAP_FAILED) {
+                    _base = base;
+                    _mapped = mapped;
+                    _data = static_cast<uint8_t*> (base);
+                    _length = length;
+                    _readonly = false;
+                    _pages = pages;
+                    return;
+                }
+            }
+
+            // transparent huge pages require the region to be aligned to
+            // their size, so that a larger mapping is created and the bytes
+            // before and after the aligned region are returned immediately
+            if (pages != pdb_pages::normal) {
+                const size_t page = page_size (pdb_pages::transparent);
+                const size_t mapped = (length + page - 1) / page * page;
+                void* base = mmap (nullptr, mapped + page, PROT_READ | PROT_WRITE, flags, -1, 0);
+                if (base == MAP_FAILED) {
+                    throw std::bad_alloc ();
+                }
+                uint8_t* start = static_cast<uint8_t*> (base);
+                uint8_t* data = start + (page - reinterpret_cast<uintptr_t> (start) % page) % page;
+                if (data > start) {
+                    munmap (start, size_t (data - start));
+                }
+                munmap (data + mapped, size_t (start + page - data));
+                _base = data;
+                _mapped = mapped;
+                _data = data;
+                _length = length;
+                _readonly = false;
+                _pages = madvise (data, mapped, MADV_HUGEPAGE) ? pdb_pages::normal : pdb_pages::transparent;
+                return;
+            }
+
+            void* base = mmap (nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (base == MAP_FAILED) {
+                throw std::bad_alloc ();
+            }
+            _base = base;
+            _mapped = _length = length;
+            _data = static_cast<uint8_t*> (base);
+            _readonly = false;
+        }
+
+        // create a read-only view of the length bytes starting at offset in
+        // the file found at the given path. In case prefault is true, all
+        // pages are read from the file before returning. The access pattern
+        // is given to the kernel with advice. It returns true if the file
+        // was successfully mapped and false otherwise
+        bool map (const std::filesystem::path& path,
+                  const size_t offset, const size_t length,
+                  const pdb_advice advice = pdb_advice::normal,
+                  const bool prefault = false) {
+
+            release ();
+
+            int fd = open (path.c_str (), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+
+            // verify the file is large enough
+            struct stat info;
+            if (fstat (fd, &info) < 0 || size_t (info.st_size) < offset + length) {
+                close (fd);
+                return false;
+            }
+
+            // the mapping starts at the page containing offset, so that only
+            // the bytes preceding offset in the same page are mapped as well.
+            // The file descriptor can be closed once the file has been mapped
+            // Empty mappings are not allowed, so that at least one byte is
+            // always mapped
+            size_t start = offset - offset % size_t (sysconf (_SC_PAGESIZE));
+            size_t mapped = std::max (offset + length - start, size_t (1));
+            void* base = mmap (nullptr, mapped, PROT_READ,
+                               MAP_SHARED | (prefault ? MAP_POPULATE : 0), fd, off_t (start));
+            close (fd);
+            if (base == MAP_FAILED) {
+                return false;
+            }
+            _base = base;
+            _mapped = mapped;
+            _data = static_cast<uint8_t*> (base) + (offset - start);
+            _length = length;
+            _readonly = true;
+
+            return advise (advice);
+        }
+
+        // create a file at the given path with room for length bytes
+        // starting at offset, which must be a multiple of the page size, and
+        // create a writable shared view of them, initialized to zero. The
+        // length must be strictly positive. All
+        // changes made to the region are eventually written to the file, and
+        // 'sync' can be used to force it. If the file already exists it is
+        // truncated. It returns true if the file was successfully created and
+        // mapped and false otherwise
+        bool create (const std::filesystem::path& path,
+                     const size_t offset, const size_t length) {
+
+            release ();
+            if (offset % size_t (sysconf (_SC_PAGESIZE)) || !length) {
+                return false;
+            }
+
+            int fd = open (path.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                return false;
+            }
+
+            // extend the file with zeroes to make room for the region. The
+            // file descriptor can be closed once the file has been mapped
+            if (ftruncate (fd, off_t (offset + length)) < 0) {
+                close (fd);
+                return false;
+            }
+            void* base = mmap (nullptr, length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, off_t (offset));
+            close (fd);
+            if (base == MAP_FAILED) {
+                return false;
+            }
+            _base = base;
+            _mapped = _length = length;
+            _data = static_cast<uint8_t*> (base);
+            _readonly = false;
+
+            return true;
+        }
+
+        // write all changes made to a region created with 'create' to its
+        // file, and return true if the operation was successful and false
+        // otherwise. Anonymous regions are always synchronized
+        bool sync () {
+            return _base == nullptr || _readonly || !msync (_base, _mapped, MS_SYNC);
+        }
+
+        // give the kernel a hint about the access pattern to this region. It
+        // returns true if the hint was accepted and false otherwise
+        bool advise (const pdb_advice advice) {
+
+            if (_base == nullptr) {
+                return true;
+            }
+
+            int hint = MADV_NORMAL;
+            switch (advice) {
+                case pdb_advice::normal:
+                    hint = MADV_NORMAL;
+                    break;
+                case pdb_advice::random:
+                    hint = MADV_RANDOM;
+                    break;
+                case pdb_advice::sequential:
+                    hint = MADV_SEQUENTIAL;
+                    break;
+                case pdb_advice::willneed:
+                    hint = MADV_WILLNEED;
+                    break;
+            }
+            return !madvise (_base, _mapped, hint);
+        }
+
+        // spread the pages of this region round-robin among all NUMA nodes.
+        // Pages already allocated are moved as well. It returns true if the
+        // operation was successful and false otherwise, e.g., if the kernel
+        // has no NUMA support
+        bool interleave () {
+            return _base == nullptr || numa_interleave (_base, _mapped);
+        }
+
+        // allocate all pages of this region in the given NUMA node. Pages
+        // already allocated are moved as well. It returns true if the
+        // operation was successful and false otherwise, e.g., if the node
+        // does not exist
+        bool bind (const int node) {
+            return _base == nullptr || numa_bind (_base, _mapped, node);
+        }
+
+        // lock all pages of this region in memory so that they are never
+        // swapped out. It returns true if the operation was successful and
+        // false otherwise, e.g., if the limit of locked memory is exceeded
+        bool lock () {
+            return _base == nullptr || !mlock (_data, _length);
+        }
+
+        // unmap the region, if any
+        void release () {
+            if (_base != nullptr) {
+                munmap (_base, _mapped);
+            }
+            _base = nullptr;
+            _mapped = _length = 0;
+            _data = nullptr;
+            _readonly = false;
+            _pages = pdb_pages::normal;
+        }
+
+    }; // class region_t
+
+} // namespace pdb
+
+#endif // _PDBREGION_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,192 @@
+// -*- coding: utf-8 -*-
+// PDBring_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 13:21:09.557102834 (1792329669)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Definition of a circular bucket queue for storing nodes
+//
+
+#ifndef _PDBRING_T_H_
+#define _PDBRING_T_H_
+
+#include<algorithm>
+#include<stddef.h>
+#include<stdexcept>
+#include<vector>
+
+#include "../PDBdefs.h"
+#include "PDBnode_t.h"
+
+namespace pdb {
+
+    // Forward declaration
+    template<typename NodeT>
+    class ring_t;
+
+    // Class definition
+    //
+    // Ring buffers are monotone open lists: once a node has been extracted,
+    // no node with a lower g-value can be inserted. Because the difference
+    // between the g-values of any two nodes simultaneously stored is bounded
+    // by the maximum cost of an operator, only as many buckets as the maximum
+    // cost plus one are needed, and they are reused in a circular fashion.
+    // They provide the same services than open_t
+    template<typename T>
+    requires pdb_type<T>
+    class ring_t<node_t<T>> {
+
+    private:
+
+        // INVARIANT: a ring consists of a vector of buckets whose size is a
+        // power of two. The node with g-value i is stored in the bucket i &
+        // (nbbuckets - 1). All operations preserve the range [mini,maxi] of
+        // values containing items unless size=0 in which case mini=maxi=last,
+        // the g-value of the last node extracted. It is ensured that
+        // maxi-mini < nbbuckets, so that all items in the same bucket have
+        // the same g-value
+        std::vector<std::vector<node_t<T>>> _queue;
+        size_t _size;                        // number of elements in the queue
+        int _mini;                                             // minimum index
+        int _maxi;                                             // maximum index
+        int _last;                     // index of the last element extracted
+
+        // double the number of buckets as many times as necessary to store
+        // all g-values in the range [mini, maxi]
+        void _grow (const int mini, const int maxi) {
+
+            size_t nbbuckets = _queue.size ();
+            while (size_t (maxi - mini) >= nbbuckets) {
+                nbbuckets *= 2;
+            }
+
+            // move all non-empty buckets to their new location
+            std::vector<std::vector<node_t<T>>> queue (nbbuckets);
+            if (_size > 0) {
+                for (auto idx = _mini ; idx <= _maxi ; idx++) {
+                    std::swap (queue [idx & (nbbuckets-1)], _queue [idx & (_queue.size ()-1)]);
+                }
+            }
+            _queue.swap (queue);
+        }
+
+    public:
+
+        // Default constructor
+        ring_t ():
+            _queue  { std::vector<std::vector<node_t<T>>> (1, std::vector<node_t<T>>() ) },
+            _size   { 0 },
+            _mini   { 0 },
+            _maxi   { 0 },
+            _last   { 0 }
+            { }
+
+        // Explicit constructor - the number of buckets should be equal to the
+        // maximum cost of an operator plus one. It is anyway rounded up to
+        // the next power of two. If it is not enough, it grows automatically
+        explicit ring_t (size_t capacity):
+            ring_t ()
+            {
+                _grow (0, int (capacity) - 1);
+            }
+
+        // Copy and assignment constructors are explicitly forbidden
+        ring_t (const ring_t&) = delete;
+        ring_t (ring_t&&) = delete;
+
+        // Assignment and move operators are disallowed as well
+        ring_t& operator=(const ring_t&) = delete;
+        ring_t& operator=(ring_t&&) = delete;
+
+        // get accessors
+        const size_t get_nbbuckets () const
+            { return _queue.size (); }
+        const size_t size () const
+            { return _size; }
+        const size_t size (const int idx) const {
+            return (_size > 0 && idx >= _mini && idx <= _maxi) ? _queue[idx & (_queue.size ()-1)].size () : 0;
+        }
+        const int get_mini () const
+            { return _mini; }
+        const int get_maxi () const
+            { return _maxi; }
+
+        // methods
+
+        // add the given item to the bucket corresponding to its g-value. It
+        // returns true if the operation was successful. In case the g-value
+        // is less than the g-value of the last node extracted, an exception
+        // is raised. If the number of buckets is not enough, it is increased
+        bool insert (const node_t<T>& item) {
+
+            // this node should be stored in the bucket corresponding to its
+            // g-value
+            int idx = item.get_g ();
+            if (idx < _last) {
+                throw std::domain_error ("[ring_t::insert] Ring buffers are monotone!");
+            }
+
+            // compute the new range and ensure there are enough buckets
+            int mini = (_size == 0) ? idx : std::min (idx, _mini);
+            int maxi = (_size == 0) ? idx : std::max (idx, _maxi);
+            if (size_t (maxi - mini) >= _queue.size ()) {
+                _grow (mini, maxi);
+            }
+
+            // insertion
+            _queue [idx & (_queue.size ()-1)].push_back (item);
+
+            // update internal data
+            _size++;
+            _mini = mini;
+            _maxi = maxi;
+
+            // exit with success
+            return true;
+        }
+
+        // pop_front extracts the first item with the minimum index. If the
+        // ring is empty an exception is thrown
+        node_t<T> pop_front () {
+
+            if (!_size) {
+                throw std::domain_error ("[ring_t::pop_front] The ring is empty!");
+            }
+
+            // extract the last item from the bucket with the minimum index
+            auto& bucket = _queue [_mini & (_queue.size ()-1)];
+            node_t<T> item = std::move (bucket.back ());
+            bucket.pop_back ();
+            _size--;
+            _last = _mini;
+
+            // update the current range
+            if (!_size) {
+                _mini = _maxi = _last;
+            } else {
+                while (!_queue [_mini & (_queue.size ()-1)].size ()) {
+                    _mini++;
+                }
+            }
+
+            return item;
+        }
+
+        // returns the first element without popping it
+        node_t<T> front () {
+            return _queue[_mini & (_queue.size ()-1)].back ();
+        }
+
+    }; // class ring_t<node_t<T>>
+
+} // namespace pdb
+
+#endif // _PDBRING_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
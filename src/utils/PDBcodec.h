@@ -0,0 +1,379 @@
+// -*- coding: utf-8 -*-
+// PDBcodec.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:41:18.072615934 (1792366878)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Compression of independent blocks of bytes
+//
+
+#ifndef _PDBCODEC_H_
+#define _PDBCODEC_H_
+
+#include<algorithm>
+#include<array>
+#include<cstdint>
+#include<functional>
+#include<queue>
+#include<stddef.h>
+#include<utility>
+#include<vector>
+
+namespace pdb {
+
+    namespace codec_impl {
+
+        // Every block is compressed in two stages. First, it is transformed
+        // into a sequence of symbols: literals (0-255) which stand for
+        // themselves, and runs (256+k, 1<=k<32) which repeat the last byte
+        // between 2^k and 2^(k+1)-1 times. The exact length of every run is
+        // given with k extra bits right after its symbol. Second, symbols are
+        // written with a canonical Huffman code computed for every block, so
+        // that every block can be decoded independently of the others.
+        //
+        // Compressed blocks start with a byte describing the method used:
+        //
+        //    stored: the block is copied verbatim. This is used whenever
+        //            compression does not reduce its size
+        //
+        //    huffman: the lengths of the codes of all symbols follow in 4
+        //             bits each (the first one in the least significant
+        //             bits), and then the bit stream with the symbols, where
+        //             the first bit is the least significant bit of every
+        //             byte
+        enum class method : uint8_t {stored, huffman};
+
+        constexpr int nbliterals = 256;
+        constexpr int nbsymbols = nbliterals + 32;
+        constexpr int maxbits = 15;
+        constexpr size_t table_bytes = nbsymbols / 2;
+
+        // return the position of the most significant bit of the given
+        // length, which must be strictly positive
+        inline int log2 (uint32_t length) {
+            return 31 - __builtin_clz (length);
+        }
+
+        // compute in lengths the length of the Huffman code of every symbol
+        // given its frequency, so that no code is longer than maxbits. Codes
+        // are limited halving the frequencies until the longest one fits.
+        // Unused symbols have null length and, if only one symbol is used,
+        // its length is one
+        inline void huffman_lengths (std::array<uint64_t, nbsymbols> freq,
+                                     std::array<uint8_t, nbsymbols>& lengths) {
+
+            lengths.fill (0);
+            for (;;) {
+
+                // nodes are the symbols followed by the internal nodes of
+                // the tree, which record their parent
+                std::vector<int> parent (2 * nbsymbols, -1);
+                using item_t = std::pair<uint64_t, int>;
+                std::priority_queue<item_t, std::vector<item_t>, std::greater<item_t>> queue;
+                for (auto symbol = 0 ; symbol < nbsymbols ; symbol++) {
+                    if (freq[symbol]) {
+                        queue.push ({freq[symbol], symbol});
+                    }
+                }
+                if (queue.empty ()) {
+                    return;
+                }
+                if (queue.size () == 1) {
+                    lengths[queue.top ().second] = 1;
+                    return;
+                }
+                int next = nbsymbols;
+                while (queue.size () > 1) {
+                    auto [f1, n1] = queue.top (); queue.pop ();
+                    auto [f2, n2] = queue.top (); queue.pop ();
+                    parent[n1] = parent[n2] = next;
+                    queue.push ({f1 + f2, next++});
+                }
+
+                // the length of every code is the depth of its symbol
+                int longest = 0;
+                for (auto symbol = 0 ; symbol < nbsymbols ; symbol++) {
+                    if (freq[symbol]) {
+                        int depth = 0;
+                        for (auto node = symbol ; parent[node] >= 0 ; node = parent[node]) {
+                            depth++;
+                        }
+                        lengths[symbol] = uint8_t (depth);
+                        longest = std::max (longest, depth);
+                    }
+                }
+                if (longest <= maxbits) {
+                    return;
+                }
+                for (auto& f : freq) {
+                    if (f) {
+                        f = std::max (uint64_t (1), f >> 1);
+                    }
+                }
+            }
+        }
+
+        // compute the canonical Huffman codes of all symbols given their
+        // lengths, bit reversed so that they can be written least
+        // significant bit first
+        inline void huffman_codes (const std::array<uint8_t, nbsymbols>& lengths,
+                                   std::array<uint16_t, nbsymbols>& codes) {
+
+            std::array<int, maxbits+1> count {};
+            for (auto length : lengths) {
+                count[length]++;
+            }
+            count[0] = 0;
+            std::array<int, maxbits+2> next {};
+            for (auto bits = 1, code = 0 ; bits <= maxbits ; bits++) {
+                code = (code + count[bits-1]) << 1;
+                next[bits] = code;
+            }
+            for (auto symbol = 0 ; symbol < nbsymbols ; symbol++) {
+                int length = lengths[symbol];
+                codes[symbol] = 0;
+                if (length) {
+                    int code = next[length]++;
+                    for (auto i = 0 ; i < length ; i++) {
+                        codes[symbol] |= uint16_t (((code >> i) & 1) << (length - 1 - i));
+                    }
+                }
+            }
+        }
+
+        // writer of a bit stream, least significant bit first
+        class bitwriter {
+            std::vector<uint8_t>& _out;
+            uint64_t _buffer;
+            int _nbbits;
+        public:
+            explicit bitwriter (std::vector<uint8_t>& out) :
+                _out { out }, _buffer { 0 }, _nbbits { 0 } {}
+            void put (const uint64_t value, const int nbbits) {
+                _buffer |= value << _nbbits;
+                _nbbits += nbbits;
+                while (_nbbits >= 8) {
+                    _out.push_back (uint8_t (_buffer));
+                    _buffer >>= 8;
+                    _nbbits -= 8;
+                }
+            }
+            void flush () {
+                if (_nbbits) {
+                    _out.push_back (uint8_t (_buffer));
+                }
+                _buffer = 0;
+                _nbbits = 0;
+            }
+        };
+
+        // reader of a bit stream, least significant bit first. Reading past
+        // the end of the stream is recorded, and zeroes are returned instead.
+        // The stream is exhausted when all bytes have been read and the bits
+        // left are null
+        class bitreader {
+            const uint8_t* _in;
+            const uint8_t* _end;
+            uint64_t _buffer;
+            int _nbbits;
+            bool _overrun;
+        public:
+            bitreader (const uint8_t* in, const size_t length) :
+                _in { in }, _end { in + length }, _buffer { 0 }, _nbbits { 0 }, _overrun { false } {}
+            uint32_t get (const int nbbits) {
+                while (_nbbits < nbbits) {
+                    if (_in == _end) {
+                        _overrun = true;
+                        return 0;
+                    }
+                    _buffer |= uint64_t (*_in++) << _nbbits;
+                    _nbbits += 8;
+                }
+                uint32_t value = uint32_t (_buffer & ((uint64_t (1) << nbbits) - 1));
+                _buffer >>= nbbits;
+                _nbbits -= nbbits;
+                return value;
+            }
+            bool overrun () const {
+                return _overrun;
+            }
+            bool exhausted () const {
+                return _in == _end && !_buffer;
+            }
+        };
+
+    } // namespace codec_impl
+
+    // return the compressed representation of the given length bytes starting
+    // at data, which can be decompressed with 'block_decompress' knowing only
+    // the length of the original data. The length must be less than 2^32
+    inline std::vector<uint8_t> block_compress (const uint8_t* data, const size_t length) {
+
+        using namespace codec_impl;
+
+        // transform the data into symbols, recording the length of every
+        // run separately
+        std::vector<uint16_t> symbols;
+        std::vector<uint32_t> runs;
+        std::array<uint64_t, nbsymbols> freq {};
+        for (size_t i = 0 ; i < length ; ) {
+            uint8_t value = data[i++];
+            symbols.push_back (value);
+            freq[value]++;
+            size_t j = i;
+            while (j < length && data[j] == value) {
+                j++;
+            }
+            if (j - i >= 2) {
+                uint16_t symbol = uint16_t (nbliterals + log2 (uint32_t (j - i)));
+                symbols.push_back (symbol);
+                runs.push_back (uint32_t (j - i));
+                freq[symbol]++;
+                i = j;
+            }
+        }
+
+        // compute the Huffman code of the symbols, and estimate the size of
+        // the block compressed
+        std::array<uint8_t, nbsymbols> lengths;
+        huffman_lengths (freq, lengths);
+        uint64_t nbbits = 0;
+        for (auto symbol = 0 ; symbol < nbsymbols ; symbol++) {
+            nbbits += freq[symbol] * (lengths[symbol] + ((symbol >= nbliterals) ? symbol - nbliterals : 0));
+        }
+
+        // if compression does not pay off, the block is stored
+        std::vector<uint8_t> out;
+        if (1 + table_bytes + (nbbits + 7) / 8 >= 1 + length) {
+            out.reserve (1 + length);
+            out.push_back (uint8_t (method::stored));
+            out.insert (out.end (), data, data + length);
+            return out;
+        }
+
+        // otherwise, write the lengths of all codes and then the symbols
+        out.reserve (1 + table_bytes + (nbbits + 7) / 8);
+        out.push_back (uint8_t (method::huffman));
+        for (auto symbol = 0 ; symbol < nbsymbols ; symbol += 2) {
+            out.push_back (uint8_t (lengths[symbol] | (lengths[symbol+1] << 4)));
+        }
+        std::array<uint16_t, nbsymbols> codes;
+        huffman_codes (lengths, codes);
+        bitwriter writer (out);
+        for (size_t i = 0, j = 0 ; i < symbols.size () ; i++) {
+            uint16_t symbol = symbols[i];
+            writer.put (codes[symbol], lengths[symbol]);
+            if (symbol >= nbliterals) {
+                int k = symbol - nbliterals;
+                writer.put (runs[j++] - (uint32_t (1) << k), k);
+            }
+        }
+        writer.flush ();
+        return out;
+    }
+
+    // decompress the given length bytes starting at data, which must have
+    // been produced with 'block_compress', into the nbbytes bytes starting at
+    // out, which is the length of the original data. It returns true if the
+    // block was successfully decompressed and false if it is corrupted
+    inline bool block_decompress (const uint8_t* data, const size_t length,
+                                  uint8_t* out, const size_t nbbytes) {
+
+        using namespace codec_impl;
+
+        if (!length) {
+            return false;
+        }
+        if (data[0] == uint8_t (method::stored)) {
+            if (length != 1 + nbbytes) {
+                return false;
+            }
+            std::copy (data + 1, data + length, out);
+            return true;
+        }
+        if (data[0] != uint8_t (method::huffman) || length < 1 + table_bytes) {
+            return false;
+        }
+
+        // read the lengths of all codes, and sort the symbols by the length
+        // of their codes as required by canonical decoding. Over-subscribed
+        // codes are rejected
+        std::array<int, maxbits+1> count {};
+        std::array<uint8_t, nbsymbols> lengths;
+        for (auto i = 0 ; i < int (table_bytes) ; i++) {
+            lengths[2*i] = data[1+i] & 0x0f;
+            lengths[2*i+1] = data[1+i] >> 4;
+            count[lengths[2*i]]++;
+            count[lengths[2*i+1]]++;
+        }
+        count[0] = 0;
+        int left = 1;
+        for (auto bits = 1 ; bits <= maxbits ; bits++) {
+            left = (left << 1) - count[bits];
+            if (left < 0) {
+                return false;
+            }
+        }
+        std::array<int, maxbits+2> offsets {};
+        for (auto bits = 1 ; bits <= maxbits ; bits++) {
+            offsets[bits+1] = offsets[bits] + count[bits];
+        }
+        std::array<uint16_t, nbsymbols> sorted;
+        for (auto symbol = 0 ; symbol < nbsymbols ; symbol++) {
+            if (lengths[symbol]) {
+                sorted[offsets[lengths[symbol]]++] = uint16_t (symbol);
+            }
+        }
+
+        // and decode all symbols until the output is full
+        bitreader reader (data + 1 + table_bytes, length - 1 - table_bytes);
+        for (size_t i = 0 ; i < nbbytes ; ) {
+
+            // decode the next symbol one bit at a time
+            int code = 0, first = 0, index = 0, symbol = -1;
+            for (auto bits = 1 ; bits <= maxbits ; bits++) {
+                code |= int (reader.get (1));
+                if (code - count[bits] < first) {
+                    symbol = sorted[index + code - first];
+                    break;
+                }
+                index += count[bits];
+                first = (first + count[bits]) << 1;
+                code <<= 1;
+            }
+            if (symbol < 0 || reader.overrun ()) {
+                return false;
+            }
+
+            if (symbol < nbliterals) {
+                out[i++] = uint8_t (symbol);
+                continue;
+            }
+            int k = symbol - nbliterals;
+            if (!k || !i) {
+                return false;
+            }
+            size_t run = (size_t (1) << k) + reader.get (k);
+            if (reader.overrun () || run > nbbytes - i) {
+                return false;
+            }
+            std::fill (out + i, out + i + run, out[i-1]);
+            i += run;
+        }
+
+        // and verify no byte was left unread, and that the last one was
+        // padded with zeroes
+        return reader.exhausted ();
+    }
+
+} // namespace pdb
+
+#endif // _PDBCODEC_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,131 @@
+// -*- coding: utf-8 -*-
+// PDBcrc32c.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 17:24:05.318260417 (1792344245)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Computation of CRC32C (Castagnoli) checksums
+//
+
+#ifndef _PDBCRC32C_H_
+#define _PDBCRC32C_H_
+
+#include<array>
+#include<cstdint>
+#include<cstring>
+#include<stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include<nmmintrin.h>
+#define PDB_CRC32C_SSE42 1
+#endif
+
+namespace pdb {
+
+    namespace crc32c_impl {
+
+        // reversed polynomial of CRC32C
+        constexpr uint32_t polynomial = 0x82f63b78;
+
+        // lookup table with the CRC of every byte, computed at compile time
+        constexpr std::array<uint32_t, 256> make_table () {
+            std::array<uint32_t, 256> table {};
+            for (uint32_t i = 0 ; i < 256 ; i++) {
+                uint32_t crc = i;
+                for (auto j = 0 ; j < 8 ; j++) {
+                    crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+                }
+                table[i] = crc;
+            }
+            return table;
+        }
+        inline constexpr std::array<uint32_t, 256> table = make_table ();
+
+        // portable implementation which processes the data byte by byte. The
+        // crc is given and returned without the final inversion
+        inline uint32_t software (uint32_t crc, const uint8_t* data, size_t length) {
+            for (size_t i = 0 ; i < length ; i++) {
+                crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+#ifdef PDB_CRC32C_SSE42
+
+        // implementation with the crc32 instruction of SSE4.2 which processes
+        // the data in words of eight bytes. It is compiled for SSE4.2 even if
+        // the rest of the library is not, and thus it must be used only if
+        // the processor supports it
+        __attribute__((target("sse4.2")))
+        inline uint32_t hardware (uint32_t crc, const uint8_t* data, size_t length) {
+
+            // process the unaligned prefix byte by byte
+            while (length && (reinterpret_cast<uintptr_t> (data) & 7)) {
+                crc = _mm_crc32_u8 (crc, *data++);
+                length--;
+            }
+
+#if defined(__x86_64__)
+            uint64_t crc64 = crc;
+            for ( ; length >= 8 ; data += 8, length -= 8) {
+                uint64_t word;
+                std::memcpy (&word, data, 8);
+                crc64 = _mm_crc32_u64 (crc64, word);
+            }
+            crc = uint32_t (crc64);
+#endif
+            for ( ; length >= 4 ; data += 4, length -= 4) {
+                uint32_t word;
+                std::memcpy (&word, data, 4);
+                crc = _mm_crc32_u32 (crc, word);
+            }
+
+            // and the suffix byte by byte
+            while (length--) {
+                crc = _mm_crc32_u8 (crc, *data++);
+            }
+            return crc;
+        }
+
+        // return true if the processor supports SSE4.2. It is computed only
+        // once
+        inline bool has_sse42 () {
+            static const bool supported = __builtin_cpu_supports ("sse4.2");
+            return supported;
+        }
+
+#endif // PDB_CRC32C_SSE42
+
+    } // namespace crc32c_impl
+
+    // return the CRC32C of the given length bytes starting at data. To compute
+    // the checksum of a sequence of blocks, the CRC of the previous ones can be
+    // given in crc. The crc32 instruction is used if the processor supports
+    // it, and a lookup table is used otherwise
+    inline uint32_t crc32c (const uint8_t* data, const size_t length, const uint32_t crc = 0) {
+
+#ifdef PDB_CRC32C_SSE42
+        if (crc32c_impl::has_sse42 ()) {
+            return ~crc32c_impl::hardware (~crc, data, length);
+        }
+#endif
+        return ~crc32c_impl::software (~crc, data, length);
+    }
+
+    // return the CRC32C of the given length bytes starting at data computed
+    // with the lookup table, regardless of the processor
+    inline uint32_t crc32c_software (const uint8_t* data, const size_t length, const uint32_t crc = 0) {
+        return ~crc32c_impl::software (~crc, data, length);
+    }
+
+} // namespace pdb
+
+#endif // _PDBCRC32C_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
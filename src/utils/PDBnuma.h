@@ -0,0 +1,113 @@
+// -*- coding: utf-8 -*-
+// PDBnuma.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 01:58:12.417306925 (1792375092)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Placement of memory among the NUMA nodes of the host
+//
+
+#ifndef _PDBNUMA_H_
+#define _PDBNUMA_H_
+
+#include<algorithm>
+#include<cctype>
+#include<filesystem>
+#include<stddef.h>
+#include<string>
+#include<system_error>
+#include<vector>
+
+#include<linux/mempolicy.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+
+namespace pdb {
+
+    namespace numa_impl {
+
+        // set the memory policy of the given range, which must start at a
+        // page boundary, to mode with the nodes given in mask. Pages already
+        // allocated are moved to honour the new policy. It returns true if
+        // the policy was accepted and false otherwise, e.g., if the kernel
+        // has no NUMA support
+        inline bool mbind (void* address, const size_t length, const int mode,
+                           const std::vector<unsigned long>& mask) {
+
+            // the kernel discards the last bit of the mask, and thus its
+            // length is given with an additional bit
+            const unsigned long maxnode = 1 + 8 * sizeof (unsigned long) * mask.size ();
+            return !syscall (SYS_mbind, address, length, mode, mask.data (), maxnode, MPOL_MF_MOVE);
+        }
+
+        // return a mask with the given nodes
+        inline std::vector<unsigned long> mask (const int first, const int last) {
+            const int bits = 8 * sizeof (unsigned long);
+            std::vector<unsigned long> result (1 + (last - 1) / bits, 0);
+            for (auto node = first ; node < last ; node++) {
+                result[node / bits] |= 1UL << (node % bits);
+            }
+            return result;
+        }
+    }
+
+    // return the number of NUMA nodes of this host, i.e., one plus the
+    // largest node found in /sys/devices/system/node. Hosts without NUMA
+    // support are deemed to have only one node
+    inline int numa_nodes () {
+        static const int nbnodes = [] () {
+            int nodes = 0;
+            std::error_code ec;
+            for (const auto& entry : std::filesystem::directory_iterator ("/sys/devices/system/node", ec)) {
+                const std::string name = entry.path ().filename ().string ();
+                if (name.size () > 4 && name.starts_with ("node") &&
+                    std::all_of (name.begin () + 4, name.end (), [] (unsigned char c) { return std::isdigit (c); })) {
+                    nodes = std::max (nodes, 1 + std::stoi (name.substr (4)));
+                }
+            }
+            return std::max (nodes, 1);
+        } ();
+        return nbnodes;
+    }
+
+    // return the node of the CPU the calling thread runs on. It is
+    // determined only the first time every thread invokes it, so that it is
+    // cheap enough to be used in every lookup, and thus threads are expected
+    // to stay in the same node, e.g., by pinning them
+    inline int numa_node () {
+
+        // the node is constant-initialized so that no guard is necessary to
+        // access it
+        static thread_local int node = -1;
+        if (node < 0) {
+            unsigned cpu = 0, current = 0;
+            node = (syscall (SYS_getcpu, &cpu, &current, nullptr) < 0) ? 0 : int (current);
+        }
+        return node;
+    }
+
+    // spread the pages of the given range, which must start at a page
+    // boundary, round-robin among all nodes. It returns true if the
+    // operation was successful and false otherwise
+    inline bool numa_interleave (void* address, const size_t length) {
+        return numa_impl::mbind (address, length, MPOL_INTERLEAVE, numa_impl::mask (0, numa_nodes ()));
+    }
+
+    // allocate the pages of the given range, which must start at a page
+    // boundary, in the given node. It returns true if the operation was
+    // successful and false otherwise, e.g., if the node does not exist
+    inline bool numa_bind (void* address, const size_t length, const int node) {
+        return numa_impl::mbind (address, length, MPOL_BIND, numa_impl::mask (node, node + 1));
+    }
+
+} // namespace pdb
+
+#endif // _PDBNUMA_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
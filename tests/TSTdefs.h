@@ -25,8 +25,8 @@ constexpr int MAX_VALUE = std::numeric_limits<int>::max ();
 // predefined number of values
 constexpr int MAX_VALUES = 100;
 
-// maximum number of buckets. Because pdbs index the buckets with pdbval_t,
-// which is usually an unsigned byte, the max is 255
+// maximum number of buckets. Open lists index the buckets with pdbval_t, but
+// unit-cost PDBs store their values in bytes, so that the max is 255
 constexpr int MAX_NB_BUCKETS = 255;
 
 // minimum and maximum number of characters in strings randomly generated
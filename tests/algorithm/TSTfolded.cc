@@ -0,0 +1,135 @@
+// -*- coding: utf-8 -*-
+// TSTfolded.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:12:06.301447559 (1792365126)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing folded PDBs
+//
+
+#include "../fixtures/TSTfoldedfixture.h"
+
+using namespace std;
+
+// check that every cell of a folded PDB stores the minimum of all locations
+// mapped to it with both groupings, so that lookups never exceed the values
+// of the original PDB
+// ----------------------------------------------------------------------------
+TEST_F (FoldedFixture, NPancakeFold) {
+
+    // Set the heavy-cost variant
+    npancake_t::init (npancake_variant::heavy_cost);
+
+    auto goal = succListInt (8);
+    for (auto ipattern : generatePatterns (5, 3)) {
+
+        // generate a PDB, write it and read it
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2));
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+
+        // fold it with a random factor and grouping
+        pdb::pdboff_t factor = 1 + rand () % 64;
+        pdb::pdb_grouping grouping = (rand () % 2) ? pdb::pdb_grouping::block : pdb::pdb_grouping::modulo;
+        pdb::folded<pdb::node_t<npancake_t>> fpdb (inpdb, factor, grouping);
+        ASSERT_EQ (fpdb.get_factor (), factor);
+        ASSERT_EQ (fpdb.get_grouping (), grouping);
+        ASSERT_EQ (fpdb.get_encoding (), pdb::pdb_encoding::byte);
+        ASSERT_EQ (fpdb.get_address_space (), inpdb.get_address_space ());
+        ASSERT_EQ (fpdb.capacity (), (inpdb.get_address_space () + factor - 1) / factor);
+        ASSERT_EQ (fpdb.size (), fpdb.capacity ());
+        ASSERT_EQ (fpdb.get_nbbytes (), fpdb.capacity ());
+        ASSERT_EQ (fpdb.get_goal (), goal);
+        ASSERT_EQ (fpdb.get_ppattern (), ipattern);
+
+        // every location is mapped to a cell whose value is never larger,
+        // and every cell equals at least one of its locations
+        vector<bool> found (fpdb.capacity (), false);
+        vector<pdb::pdboff_t> count (fpdb.capacity (), 0);
+        pdb::pdboff_t nblost = 0;
+        for (pdb::pdboff_t idx = 0 ; idx < inpdb.get_address_space () ; idx++) {
+            pdb::pdboff_t cell = fpdb.cell (idx);
+            ASSERT_LT (cell, fpdb.capacity ());
+            ASSERT_LE (fpdb[cell], inpdb[idx]);
+            if (fpdb[cell] == inpdb[idx]) {
+                found[cell] = true;
+            }
+            count[cell]++;
+            nblost += inpdb[idx] - fpdb[cell];
+        }
+        ASSERT_TRUE (all_of (found.begin (), found.end (), [] (bool f) { return f; }));
+        ASSERT_LE (*max_element (count.begin (), count.end ()), factor);
+        ASSERT_DOUBLE_EQ (fpdb.get_loss (), double (nblost) / inpdb.get_address_space ());
+
+        // and lookups are admissible wrt the original PDB
+        for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            ASSERT_LE (fpdb[perm], inpdb[perm]);
+            ASSERT_EQ (fpdb.value (perm), fpdb[perm]);
+        }
+
+        // folding with a factor equal to one preserves all values
+        pdb::folded<pdb::node_t<npancake_t>> identity (inpdb, 1, grouping);
+        ASSERT_EQ (identity.capacity (), inpdb.get_address_space ());
+        ASSERT_EQ (identity.get_loss (), 0.0);
+        for (pdb::pdboff_t idx = 0 ; idx < inpdb.get_address_space () ; idx++) {
+            ASSERT_EQ (identity[idx], inpdb[idx]);
+        }
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that folded PDBs preserve the encoding of the original PDB, and that
+// they can not be created with a null factor or from PDBs encoded modulo 3
+// ----------------------------------------------------------------------------
+TEST_F (FoldedFixture, NPancakeEncodings) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    string ipattern = "----****";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+
+    // nibbles are folded into nibbles
+    auto path = generate_random_path ();
+    ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::nibble));
+    {
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+        pdb::pdboff_t factor = 2 + rand () % 16;
+        pdb::folded<pdb::node_t<npancake_t>> fpdb (inpdb, factor);
+        ASSERT_EQ (fpdb.get_encoding (), pdb::pdb_encoding::nibble);
+        ASSERT_EQ (fpdb.get_nbbytes (), (fpdb.capacity () + 1) / 2);
+        for (pdb::pdboff_t idx = 0 ; idx < inpdb.get_address_space () ; idx++) {
+            ASSERT_LE (fpdb[fpdb.cell (idx)], inpdb[idx]);
+        }
+        ASSERT_THROW (pdb::folded<pdb::node_t<npancake_t>> (inpdb, 0), invalid_argument);
+    }
+
+    // whereas values encoded modulo 3 can not be folded
+    ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::mod3));
+    {
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+        ASSERT_THROW (pdb::folded<pdb::node_t<npancake_t>> (inpdb, 2), invalid_argument);
+    }
+
+    error_code ec;
+    ASSERT_TRUE (std::filesystem::remove(path, ec));
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,351 @@
+// -*- coding: utf-8 -*-
+// TSTheuristic_set.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 02:55:04.381920657 (1792378504)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing heuristic sets
+//
+
+#include<algorithm>
+#include<atomic>
+#include<random>
+#include<thread>
+
+#include "../fixtures/TSTheuristic_setfixture.h"
+
+using namespace std;
+
+// check that values are combined either with their maximum or their sum, and
+// that sums are saturated
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, Combine) {
+
+    using hset = pdb::heuristic_set<pdb::node_t<npancake_t>>;
+    ASSERT_EQ (hset::combine (pdb::pdb_mode::max, {}), 0);
+    ASSERT_EQ (hset::combine (pdb::pdb_mode::add, {}), 0);
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+        vector<pdb::pdbval_t> values (1 + rand () % 10);
+        pdb::pdboff_t sum = 0;
+        for (auto& value : values) {
+            value = pdb::pdbval_t (rand () % 1000);
+            sum += value;
+        }
+        ASSERT_EQ (hset::combine (pdb::pdb_mode::max, values), *max_element (values.begin (), values.end ()));
+        ASSERT_EQ (hset::combine (pdb::pdb_mode::add, values), pdb::pdbval_t (sum));
+    }
+    ASSERT_EQ (hset::combine (pdb::pdb_mode::add, {60000, 60000}), numeric_limits<pdb::pdbval_t>::max ());
+}
+
+// check that the values of heuristic sets are the maximum of the values of
+// all PDBs, both from scratch and wrt the values of the parent, with any
+// encoding
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeMax) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    vector<string> patterns = {"-----***", "***-----", "--*--*-*"};
+    for (auto encoding : {pdb::pdb_encoding::byte, pdb::pdb_encoding::nibble, pdb::pdb_encoding::mod3}) {
+
+        auto paths = generate_pdbs (pdb::pdb_mode::max, goal, patterns, encoding);
+        pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+        ASSERT_TRUE (hset.read ());
+        ASSERT_EQ (hset.get_in_error (), pdb::in_error_message::no_error);
+        ASSERT_EQ (hset.size (), patterns.size ());
+        ASSERT_EQ (hset.get_pdb_mode (), pdb::pdb_mode::max);
+
+        vector<pdb::pdbval_t> values, cvalues;
+        for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+
+            // the value of the permutation is the maximum of all values
+            pdb::pdbval_t h = hset.evaluate (perm, values);
+            ASSERT_EQ (values.size (), patterns.size ());
+            for (size_t j = 0 ; j < hset.size () ; j++) {
+                ASSERT_EQ (values[j], hset[j].value (perm));
+            }
+            ASSERT_EQ (h, *max_element (values.begin (), values.end ()));
+            ASSERT_EQ (hset.evaluate (perm), h);
+
+            // and the value of its children is computed from its values
+            vector<tuple<pdb::pdbval_t, npancake_t>> successors;
+            npancake_t (perm).children (successors);
+            for (const auto& [cost, child] : successors) {
+                pdb::pdbval_t ch = hset.evaluate (child.get_perm (), values, cvalues);
+                for (size_t j = 0 ; j < hset.size () ; j++) {
+                    ASSERT_EQ (cvalues[j], hset[j].value (child.get_perm (), values[j]));
+                }
+                ASSERT_EQ (ch, *max_element (cvalues.begin (), cvalues.end ()));
+            }
+        }
+        remove_pdbs (paths);
+    }
+}
+
+// check that patterns are disjoint only if no symbol is preserved by more
+// than one of them
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, Disjoint) {
+
+    using hset = pdb::heuristic_set<pdb::node_t<npancake_t>>;
+    ASSERT_TRUE (hset::disjoint ({}));
+    ASSERT_TRUE (hset::disjoint ({"--**", "**--"}));
+    ASSERT_TRUE (hset::disjoint ({"-***", "*-**", "**-*"}));
+    ASSERT_FALSE (hset::disjoint ({"--**", "*--*"}));
+    ASSERT_FALSE (hset::disjoint ({"--**", "**---"}));
+
+    // every partition of the symbols into random groups is disjoint, and
+    // adding any other pattern preserving a symbol makes it overlap
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+        const int length = 2 + rand () % 10;
+        const int nbgroups = 1 + rand () % length;
+        vector<string> patterns (nbgroups, string (length, '*'));
+        for (auto j = 0 ; j < length ; j++) {
+            patterns[rand () % nbgroups][j] = '-';
+        }
+        ASSERT_TRUE (hset::disjoint (patterns));
+        string other (length, '*');
+        other[rand () % length] = '-';
+        patterns.push_back (other);
+        ASSERT_FALSE (hset::disjoint (patterns));
+    }
+}
+
+// check that the values of heuristic sets with PDBs in ADD mode are the sum
+// of the values of all PDBs
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeAdd) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    vector<string> patterns = {"----****", "****----"};
+    auto paths = generate_pdbs (pdb::pdb_mode::add, goal, patterns);
+    pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+    ASSERT_TRUE (hset.map ());
+    ASSERT_EQ (hset.get_pdb_mode (), pdb::pdb_mode::add);
+
+    vector<pdb::pdbval_t> values;
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+        auto perm = succListInt (8);
+        shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+        ASSERT_EQ (hset.evaluate (perm, values), hset[0][perm] + hset[1][perm]);
+    }
+    remove_pdbs (paths);
+}
+
+// check that PDBs with different goals or modes are rejected, and that errors
+// loading any PDB are reported
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeMismatch) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // different goals
+    auto goal = succListInt (6);
+    auto other = goal;
+    reverse (other.begin (), other.end ());
+    auto paths = generate_pdbs (pdb::pdb_mode::max, goal, {"---***"});
+    auto others = generate_pdbs (pdb::pdb_mode::max, other, {"***---"});
+    pdb::heuristic_set<pdb::node_t<npancake_t>> goals ({paths[0], others[0]});
+    ASSERT_FALSE (goals.read ());
+    ASSERT_EQ (goals.get_in_error (), pdb::in_error_message::pdb_goal_mismatch);
+    remove_pdbs (others);
+
+    // different modes
+    others = generate_pdbs (pdb::pdb_mode::add, goal, {"***---"});
+    pdb::heuristic_set<pdb::node_t<npancake_t>> modes ({paths[0], others[0]});
+    ASSERT_FALSE (modes.read ());
+    ASSERT_EQ (modes.get_in_error (), pdb::in_error_message::pdb_mode_mismatch);
+    remove_pdbs (others);
+
+    // additive PDBs with overlapping patterns
+    auto overlap = generate_pdbs (pdb::pdb_mode::add, goal, {"---***", "**---*"});
+    pdb::heuristic_set<pdb::node_t<npancake_t>> patterns (overlap);
+    ASSERT_FALSE (patterns.read ());
+    ASSERT_EQ (patterns.get_in_error (), pdb::in_error_message::pdb_patterns_overlap);
+    remove_pdbs (overlap);
+
+    // missing files
+    pdb::heuristic_set<pdb::node_t<npancake_t>> missing ({paths[0], generate_random_path ()});
+    ASSERT_FALSE (missing.read ());
+    ASSERT_EQ (missing.get_in_error (), pdb::in_error_message::file_does_not_exist);
+    remove_pdbs (paths);
+}
+
+// check that heuristic sets can be used simultaneously by several threads
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeConcurrent) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    vector<string> patterns = {"-----***", "***-----", "*-*-*-*-"};
+    auto paths = generate_pdbs (pdb::pdb_mode::max, goal, patterns);
+    pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+    ASSERT_TRUE (hset.read ());
+
+    // evaluate the same permutations serially and with all threads
+    vector<vector<int>> perms (NB_TESTS);
+    vector<pdb::pdbval_t> expected;
+    for (auto& perm : perms) {
+        perm = succListInt (8);
+        shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+        expected.push_back (hset.evaluate (perm));
+    }
+    atomic<bool> ok = true;
+    vector<thread> threads;
+    for (auto id = 0 ; id < 4 ; id++) {
+        threads.push_back (thread ([&hset, &perms, &expected, &ok] () {
+            vector<pdb::pdbval_t> values;
+            for (size_t i = 0 ; i < perms.size () ; i++) {
+                if (hset.evaluate (perms[i], values) != expected[i]) {
+                    ok = false;
+                }
+            }
+        }));
+    }
+    for (auto& ithread : threads) {
+        ithread.join ();
+    }
+    ASSERT_TRUE (ok);
+    remove_pdbs (paths);
+}
+
+// check that evaluations against a bound return the value of the heuristic
+// set when it does not exceed the bound, and otherwise a value larger than the
+// bound which does not exceed it, in both modes
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeBounded) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    for (auto mode : {pdb::pdb_mode::max, pdb::pdb_mode::add}) {
+        vector<string> patterns = (mode == pdb::pdb_mode::max) ?
+            vector<string>{"-----***", "***-----", "--*--*-*"} : vector<string>{"---*****", "***--***", "*****---"};
+        auto paths = generate_pdbs (mode, goal, patterns);
+        pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+        ASSERT_TRUE (hset.read ());
+        pdb::evaluator<pdb::node_t<npancake_t>> eval (hset);
+        ASSERT_EQ (eval.get_order (), vector<size_t>({0, 1, 2}));
+
+        for (auto i = 0 ; i < NB_TESTS ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            const pdb::pdbval_t h = hset.evaluate (perm);
+            const pdb::pdbval_t bound = pdb::pdbval_t (rand () % 10);
+            const pdb::pdbval_t value = eval.evaluate (perm, bound);
+            if (h > bound) {
+                ASSERT_GT (value, bound);
+                ASSERT_LE (value, h);
+            } else {
+                ASSERT_EQ (value, h);
+            }
+            ASSERT_EQ (eval.exceeds (perm, bound), h > bound);
+        }
+
+        // every evaluation either looks up a PDB or saves its lookup
+        ASSERT_EQ (eval.get_nbevaluations (), pdb::pdboff_t (2 * NB_TESTS));
+        ASSERT_EQ (eval.get_nblookups () + eval.get_nbsaved (), 2 * NB_TESTS * hset.size ());
+        ASSERT_LE (eval.get_nbcutoffs (), eval.get_nbevaluations ());
+
+        // and all statistics are discarded when reset
+        eval.reset ();
+        ASSERT_EQ (eval.get_nbevaluations (), 0);
+        ASSERT_EQ (eval.get_nblookups (), 0);
+        ASSERT_EQ (eval.get_nbsaved (), 0);
+        ASSERT_EQ (eval.get_nbcutoffs (), 0);
+        remove_pdbs (paths);
+    }
+}
+
+// check that the PDBs which prune most are looked up first
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeBoundedOrder) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // the first PDB preserves only one symbol and thus its values never
+    // exceed 2, whereas the second one does most of the times
+    auto goal = succListInt (8);
+    auto paths = generate_pdbs (pdb::pdb_mode::max, goal, {"-*******", "-----***"});
+    pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+    ASSERT_TRUE (hset.read ());
+    pdb::evaluator<pdb::node_t<npancake_t>> eval (hset);
+
+    for (pdb::pdboff_t i = 0 ; i < 4 * eval.sort_period ; i++) {
+        auto perm = succListInt (8);
+        shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+        eval.evaluate (perm, 2);
+    }
+    ASSERT_EQ (eval.get_nbprunes (0), 0);
+    ASSERT_GT (eval.get_nbprunes (1), 0);
+    ASSERT_EQ (eval.get_order (), vector<size_t>({1, 0}));
+
+    // and thus the lookups of the first PDB are saved whenever the second
+    // one exceeds the bound
+    ASSERT_GT (eval.get_nbsaved (), 0);
+    ASSERT_LT (eval.get_nblookups (0), eval.get_nblookups (1));
+    remove_pdbs (paths);
+}
+
+// check that the dual values of heuristic sets are the maximum of the
+// combination of the regular values and the dual values, in both modes, that
+// they never exceed the true distance to the goal, and that they are rejected
+// in the heavy-cost variant
+// ----------------------------------------------------------------------------
+TEST_F (HeuristicSetFixture, NPancakeDual) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // the true distance of every permutation is given by a PDB which preserves
+    // all symbols
+    auto goal = succListInt (8);
+    pdb::outpdb<pdb::node_t<npancake_t>> full (pdb::pdb_mode::max, goal, "--------", "--------");
+    full.generate ();
+    for (auto mode : {pdb::pdb_mode::max, pdb::pdb_mode::add}) {
+        vector<string> patterns = (mode == pdb::pdb_mode::max) ?
+            vector<string>{"-----***", "***-----", "--*--*-*"} : vector<string>{"---*****", "***--***", "*****---"};
+        auto paths = generate_pdbs (mode, goal, patterns);
+        pdb::heuristic_set<pdb::node_t<npancake_t>> hset (paths);
+        ASSERT_TRUE (hset.read ());
+
+        vector<pdb::pdbval_t> values (hset.size ()), dvalues (hset.size ());
+        for (auto i = 0 ; i < NB_TESTS ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            for (size_t j = 0 ; j < hset.size () ; j++) {
+                values[j] = hset[j].value (perm);
+                dvalues[j] = hset[j].dual_value (perm);
+            }
+            ASSERT_EQ (hset.evaluate_dual (perm),
+                       max (hset.combine (mode, values), hset.combine (mode, dvalues)));
+            ASSERT_GE (hset.evaluate_dual (perm), hset.evaluate (perm));
+            ASSERT_LE (hset.evaluate_dual (perm), pdb::pdbval_t (full[perm] - 1));
+        }
+
+        npancake_t::init (npancake_variant::heavy_cost, 1);
+        ASSERT_THROW (hset.evaluate_dual (goal), std::invalid_argument);
+        npancake_t::init (npancake_variant::unit, 1);
+        remove_pdbs (paths);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
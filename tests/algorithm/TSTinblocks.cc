@@ -0,0 +1,133 @@
+// -*- coding: utf-8 -*-
+// TSTinblocks.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 00:06:58.914527036 (1792368418)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing compressed PDBs decoded on demand
+//
+
+#include "../fixtures/TSTinblocksfixture.h"
+
+using namespace std;
+
+// check that blocks are decoded only when they are accessed, that the cache
+// never exceeds its size, and that all values are the same generated
+// ----------------------------------------------------------------------------
+TEST_F (InBlocksFixture, NPancakeLazy) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // generate a PDB which takes several blocks
+    auto goal = succListInt (9);
+    string ipattern = "-------**";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // and write it compressed either in bytes or nibbles
+        auto encoding = (rand () % 2) ? pdb::pdb_encoding::byte : pdb::pdb_encoding::nibble;
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, encoding, pdb::pdb_compression::rle));
+
+        // opening the PDB decodes no block at all, and it takes only the
+        // room of the file
+        size_t cache_blocks = 1 + rand () % 4;
+        pdb::inblocks<pdb::node_t<npancake_t>> inblocks (path);
+        ASSERT_EQ (inblocks.open (cache_blocks), outpdb.capacity ());
+        ASSERT_EQ (inblocks.get_compression (), pdb::pdb_compression::rle);
+        ASSERT_EQ (inblocks.get_encoding (), encoding);
+        ASSERT_EQ (inblocks.capacity (), outpdb.capacity ());
+        ASSERT_EQ (inblocks.get_nbcached (), 0);
+        ASSERT_EQ (inblocks.get_nbbytes () + inblocks.get_header ().get_offset (), std::filesystem::file_size (path));
+        ASSERT_TRUE (inblocks.verify (1 + rand () % 4));
+        ASSERT_EQ (inblocks.get_nbcached (), 0);
+
+        // every query decodes at most one block, and it returns the same
+        // value generated
+        for (auto j = 0 ; j < NB_TESTS/10 ; j++) {
+            auto perm = random_perm (goal);
+            auto nbmisses = inblocks.get_nbmisses ();
+            ASSERT_EQ (inblocks[perm], pdb::pdbval_t (outpdb[perm] - 1));
+            ASSERT_EQ (inblocks.value (perm), inblocks[perm]);
+            ASSERT_LE (inblocks.get_nbmisses (), nbmisses + 1);
+            ASSERT_LE (inblocks.get_nbcached (), cache_blocks);
+        }
+        ASSERT_EQ (inblocks.get_nbhits () + inblocks.get_nbmisses (), size_t (3 * NB_TESTS/10));
+
+        // traversing all locations in order decodes every block once
+        pdb::pdboff_t nbmisses = inblocks.get_nbmisses ();
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            ASSERT_EQ (inblocks[idx], pdb::pdbval_t (outpdb[idx] - 1));
+        }
+        ASSERT_LE (inblocks.get_nbmisses (), nbmisses + inblocks.get_header ().get_nbblocks ());
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that errors in compressed PDBs are correctly detected
+// ----------------------------------------------------------------------------
+TEST_F (InBlocksFixture, NPancakeErrors) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        auto goal = succListInt (9);
+        string ipattern = "---******";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+
+        // files which are not compressed or encoded modulo 3 can not be
+        // decoded on demand
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2));
+        pdb::inblocks<pdb::node_t<npancake_t>> uncompressed (path);
+        ASSERT_EQ (uncompressed.open (), 0);
+        ASSERT_EQ (uncompressed.get_in_error (), pdb::in_error_message::pdb_format_not_supported);
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::mod3, pdb::pdb_compression::rle));
+        pdb::inblocks<pdb::node_t<npancake_t>> mod3 (path);
+        ASSERT_EQ (mod3.open (), 0);
+        ASSERT_EQ (mod3.get_in_error (), pdb::in_error_message::pdb_format_not_supported);
+
+        // and the cache must have room for one block at least
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::byte, pdb::pdb_compression::rle));
+        pdb::inblocks<pdb::node_t<npancake_t>> inblocks (path);
+        ASSERT_THROW (inblocks.open (0), invalid_argument);
+        ASSERT_EQ (inblocks.open (), outpdb.capacity ());
+
+        // a block with an unknown method can be opened, but accessing its
+        // locations raises an exception and it is not verified
+        {
+            pdb::pdboff_t loc = inblocks.get_header ().get_offset () + inblocks.get_header ().get_index_bytes ();
+            fstream file (path, ios::binary | ios::in | ios::out);
+            file.seekp (loc);
+            file.put (char (2 + rand () % 254));
+        }
+        pdb::inblocks<pdb::node_t<npancake_t>> corrupted (path);
+        ASSERT_EQ (corrupted.open (), outpdb.capacity ());
+        ASSERT_THROW (corrupted[0], runtime_error);
+        ASSERT_FALSE (corrupted.verify ());
+        ASSERT_EQ (corrupted.get_in_error (), pdb::in_error_message::pdb_checksum_mismatch);
+
+        // missing files can not be opened
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+        pdb::inblocks<pdb::node_t<npancake_t>> missing (path);
+        ASSERT_EQ (missing.open (), 0);
+        ASSERT_EQ (missing.get_in_error (), pdb::in_error_message::file_does_not_exist);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -95,6 +95,10 @@ TEST_F (InPDBFixture, NPancakeUnitMaxRead) {
                 ASSERT_TRUE (false);
             }
 
+            // and check that all g-values were streamed from the file
+            ASSERT_EQ (inpdb.get_nbbytes (), pdb::encoding_bytes (inpdb.get_encoding (), ret));
+            ASSERT_GE (inpdb.get_throughput (), 0.0);
+
             // and check it is a MAX PDB
             ASSERT_EQ (inpdb.get_pdb_mode (), pdb::pdb_mode::max);
 
@@ -114,7 +118,7 @@ TEST_F (InPDBFixture, NPancakeUnitMaxRead) {
 
             // Second, compare the values stored in each PDB are strictly the same
             for (auto idx = 0 ; idx < outpdb.size () ; idx++) {
-                ASSERT_EQ (outpdb[idx], inpdb[idx]);
+                ASSERT_EQ (outpdb[idx]-1, inpdb[idx]);
             }
 
             // finally, remove the file
@@ -205,7 +209,7 @@ TEST_F (InPDBFixture, NPancakeHeavyCostMaxRead) {
 
             // Second, compare the values stored in each PDB are strictly the same
             for (auto idx = 0 ; idx < outpdb.size () ; idx++) {
-                ASSERT_EQ (outpdb[idx], inpdb[idx]);
+                ASSERT_EQ (outpdb[idx]-1, inpdb[idx]);
             }
 
             // finally, remove the file
@@ -216,6 +220,742 @@ TEST_F (InPDBFixture, NPancakeHeavyCostMaxRead) {
 }
 
 
+// check that MAX inPDBs generated for the unit variant of the N-Pancake are
+// correctly mapped in memory
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeUnitMaxMap) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // Use pancakes of length 7
+    int length = 7;
+    auto goal = succListInt (length);
+    vector<pdb::pdb_advice> advices = {pdb::pdb_advice::normal, pdb::pdb_advice::random,
+                                       pdb::pdb_advice::sequential, pdb::pdb_advice::willneed};
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate a MAX PDB with this combination of goal and pattern and
+            // write it to a random path
+            pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            outpdb.generate ();
+            ASSERT_TRUE (outpdb.doctor ());
+            auto path = generate_random_path ();
+            ASSERT_TRUE (outpdb.write (path));
+
+            // map it with a random advice, and randomly prefaulting and
+            // locking its pages. Mapped PDBs are read-only so that they have
+            // to be accessed through a const reference
+            pdb::inpdb<pdb::node_t<npancake_t>> mpdb (path);
+            auto ret = mpdb.map (advices[rand () % advices.size ()], rand () % 2, rand () % 2);
+            const auto& inpdb = mpdb;
+            if (!ret) {
+                cout << inpdb.get_in_error_message () << endl; cout.flush ();
+                ASSERT_TRUE (false);
+            }
+
+            // verify the header has been correctly processed
+            ASSERT_EQ (ret, pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern));
+            ASSERT_EQ (inpdb.get_pdb_mode (), pdb::pdb_mode::max);
+            ASSERT_EQ (inpdb.get_goal (), goal);
+            ASSERT_EQ (inpdb.get_cpattern (), ipattern);
+            ASSERT_EQ (inpdb.get_ppattern (), ipattern);
+
+            // and compare the contents of both PDBs
+            ASSERT_EQ (outpdb.capacity (), inpdb.capacity ());
+            for (auto idx = 0 ; idx < outpdb.size () ; idx++) {
+                ASSERT_EQ (outpdb[idx]-1, inpdb[idx]);
+            }
+
+            // values can be also accessed with permutations
+            for (auto j = 0 ; j < MAX_VALUES ; j++) {
+                auto perm = randInstance (length).get_perm ();
+                ASSERT_EQ (outpdb[perm]-1, inpdb[perm]);
+            }
+
+            // finally, remove the file. Note the mapping is still valid
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(path, ec));
+            ASSERT_EQ (outpdb[0]-1, inpdb[0]);
+        }
+    }
+}
+
+// check that inPDBs mapped in memory are read-only and that errors are
+// correctly reported
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeMapErrors) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // files that do not exist can not be mapped
+    pdb::inpdb<pdb::node_t<npancake_t>> missing (generate_random_path ());
+    ASSERT_EQ (missing.map (), 0);
+    ASSERT_EQ (missing.get_in_error (), pdb::in_error_message::file_does_not_exist);
+
+    // generate a small PDB and write it
+    auto goal = succListInt (6);
+    string ipattern = "---***";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+    ASSERT_TRUE (outpdb.doctor ());
+    auto path = generate_random_path ();
+    ASSERT_TRUE (outpdb.write (path));
+
+    // once mapped, the PDB can be read as usual but it can not be modified
+    pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+    ASSERT_GT (inpdb.map (), 0);
+    for (pdb::pdboff_t i = 0 ; i < inpdb.capacity () ; i++) {
+        ASSERT_EQ (inpdb[i], pdb::pdbval_t (outpdb[i] - 1));
+    }
+    EXPECT_THROW (inpdb.ref (0) = 0, runtime_error);
+
+    // truncated files are detected before being mapped
+    std::filesystem::resize_file (path, std::filesystem::file_size (path) - 1);
+    pdb::inpdb<pdb::node_t<npancake_t>> truncated (path);
+    ASSERT_EQ (truncated.map (), 0);
+    ASSERT_EQ (truncated.get_in_error (), pdb::in_error_message::pdb_incorrect_size);
+
+    error_code ec;
+    ASSERT_TRUE (std::filesystem::remove(path, ec));
+}
+
+// check that PDBs written with both formats are correctly retrieved, and that
+// the header of v2 files describes their contents
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeFormats) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // Use pancakes of length 7
+    int length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate a MAX PDB and write it with both formats
+            pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            outpdb.generate ();
+            auto path1 = generate_random_path ();
+            ASSERT_TRUE (outpdb.write (path1, pdb::pdb_format::v1));
+            auto path2 = generate_random_path ();
+            ASSERT_TRUE (outpdb.write (path2, pdb::pdb_format::v2));
+
+            // read both files
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb1 (path1);
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb2 (path2);
+            ASSERT_EQ (inpdb1.read (), outpdb.capacity ());
+            ASSERT_EQ (inpdb2.read (), outpdb.capacity ());
+            ASSERT_EQ (inpdb1.get_format (), pdb::pdb_format::v1);
+            ASSERT_EQ (inpdb2.get_format (), pdb::pdb_format::v2);
+
+            // the description of both is the same
+            ASSERT_EQ (inpdb2.get_pdb_mode (), pdb::pdb_mode::max);
+            ASSERT_EQ (inpdb2.get_goal (), goal);
+            ASSERT_EQ (inpdb2.get_cpattern (), ipattern);
+            ASSERT_EQ (inpdb2.get_ppattern (), ipattern);
+
+            // and also their contents, which are verified to be correct
+            for (auto idx = 0 ; idx < outpdb.capacity () ; idx++) {
+                ASSERT_EQ (inpdb1[idx], inpdb2[idx]);
+            }
+            ASSERT_TRUE (inpdb1.verify ());
+            ASSERT_TRUE (inpdb2.verify (1 + rand () % 4));
+
+            // the values of v2 files start at a page boundary and the
+            // histogram accounts for all of them
+            const pdb::header_t& header = inpdb2.get_header ();
+            ASSERT_EQ (header.get_offset () % pdb::header_t::page_size, 0);
+            ASSERT_EQ (std::filesystem::file_size (path2), header.get_offset () + outpdb.capacity ());
+            vector<pdb::pdboff_t> histogram (256, 0);
+            for (auto idx = 0 ; idx < outpdb.capacity () ; idx++) {
+                histogram[inpdb2[idx]]++;
+            }
+            ASSERT_EQ (header.get_histogram (), histogram);
+            ASSERT_EQ (header.get_histogram ()[0], 1);
+
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(path1, ec));
+            ASSERT_TRUE (std::filesystem::remove(path2, ec));
+        }
+    }
+}
+
+// check that corrupted v2 files are detected
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeChecksums) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // generate a small PDB and write it
+        auto goal = succListInt (7);
+        string ipattern = "----***";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path));
+
+        // flip one bit of a random value and verify the PDB can be still read
+        // but not verified
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_GT (inpdb.read (), 0);
+        pdb::pdboff_t offset = inpdb.get_header ().get_offset ();
+        pdb::pdboff_t loc = offset + rand () % outpdb.capacity ();
+        {
+            fstream file (path, ios::binary | ios::in | ios::out);
+            file.seekg (loc);
+            char byte = file.get ();
+            file.seekp (loc);
+            file.put (byte ^ char (1 << (rand () % 8)));
+        }
+        pdb::inpdb<pdb::node_t<npancake_t>> corrupted (path);
+        ASSERT_GT (corrupted.map (), 0);
+        ASSERT_FALSE (corrupted.verify (1 + rand () % 4));
+        ASSERT_EQ (corrupted.get_in_error (), pdb::in_error_message::pdb_checksum_mismatch);
+
+        // flip one bit of the goal in the header, which can not be read
+        // anymore
+        {
+            fstream file (path, ios::binary | ios::in | ios::out);
+            file.seekg (pdb::header_t::fixed_bytes);
+            char byte = file.get ();
+            file.seekp (pdb::header_t::fixed_bytes);
+            file.put (byte ^ char (1 << (rand () % 8)));
+        }
+        pdb::inpdb<pdb::node_t<npancake_t>> header (path);
+        ASSERT_EQ (header.read (), 0);
+        ASSERT_EQ (header.get_in_error (), pdb::in_error_message::pdb_header_corrupted);
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that several PDBs are correctly read and mapped simultaneously, and
+// that the errors of every one are reported separately
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeConcurrentLoad) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // generate a random number of PDBs with different patterns and write
+        // them
+        auto goal = succListInt (8);
+        vector<string> patterns = {"-----***", "***-----", "--*--*-*", "*-*-*-*-"};
+        vector<std::filesystem::path> paths;
+        vector<unique_ptr<pdb::outpdb<pdb::node_t<npancake_t>>>> outpdbs;
+        size_t nbbytes = 0;
+        for (auto j = 0 ; j < 1 + rand () % int (patterns.size ()) ; j++) {
+            outpdbs.push_back (make_unique<pdb::outpdb<pdb::node_t<npancake_t>>> (pdb::pdb_mode::max, goal, patterns[j], patterns[j]));
+            outpdbs.back ()->generate ();
+            paths.push_back (generate_random_path ());
+            ASSERT_TRUE (outpdbs.back ()->write (paths.back ()));
+            nbbytes += outpdbs.back ()->capacity ();
+        }
+
+        // read them all with a random number of threads, including zero
+        pdb::inpdbs<pdb::node_t<npancake_t>> inpdbs (paths);
+        ASSERT_EQ (inpdbs.size (), paths.size ());
+        ASSERT_TRUE (inpdbs.read (rand () % 4));
+        ASSERT_EQ (inpdbs.get_nbbytes (), nbbytes);
+
+        // and map them also
+        pdb::inpdbs<pdb::node_t<npancake_t>> mapped (paths);
+        ASSERT_TRUE (mapped.map (rand () % 4));
+
+        // verify their contents are the same generated
+        for (size_t j = 0 ; j < paths.size () ; j++) {
+            ASSERT_EQ (inpdbs[j].get_ppattern (), patterns[j]);
+            ASSERT_EQ (mapped[j].get_ppattern (), patterns[j]);
+            for (pdb::pdboff_t idx = 0 ; idx < outpdbs[j]->capacity () ; idx++) {
+                ASSERT_EQ (inpdbs[j][idx], pdb::pdbval_t ((*outpdbs[j])[idx] - 1));
+                ASSERT_EQ (mapped[j][idx], pdb::pdbval_t ((*outpdbs[j])[idx] - 1));
+            }
+        }
+
+        // remove a random PDB and verify that only its error is reported
+        auto victim = rand () % paths.size ();
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(paths[victim], ec));
+        pdb::inpdbs<pdb::node_t<npancake_t>> missing (paths);
+        ASSERT_FALSE (missing.read (rand () % 4));
+        for (size_t j = 0 ; j < paths.size () ; j++) {
+            ASSERT_EQ (missing[j].get_in_error (),
+                       (j == victim) ? pdb::in_error_message::file_does_not_exist : pdb::in_error_message::no_error);
+        }
+
+        for (size_t j = 0 ; j < paths.size () ; j++) {
+            if (j != victim) {
+                ASSERT_TRUE (std::filesystem::remove(paths[j], ec));
+            }
+        }
+    }
+}
+
+// check that PDBs written with values packed in nibbles are correctly read
+// and mapped
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeNibble) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // generate a PDB whose values fit in a nibble and write it
+        auto goal = succListInt (8);
+        string ipattern = (rand () % 2) ? "-----***" : "--*-*-*-";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        ASSERT_TRUE (outpdb.fits (pdb::pdb_encoding::nibble));
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::nibble));
+
+        // the file takes half the space of the values
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+        ASSERT_EQ (inpdb.get_encoding (), pdb::pdb_encoding::nibble);
+        ASSERT_EQ (inpdb.get_nbbytes (), (outpdb.capacity () + 1) / 2);
+        ASSERT_EQ (std::filesystem::file_size (path),
+                   inpdb.get_header ().get_offset () + (outpdb.capacity () + 1) / 2);
+        ASSERT_TRUE (inpdb.verify ());
+
+        // and its values are the same generated, either read or mapped, even
+        // if packed values can not be referenced
+        pdb::inpdb<pdb::node_t<npancake_t>> mapped (path);
+        ASSERT_EQ (mapped.map (), outpdb.capacity ());
+        ASSERT_TRUE (mapped.verify ());
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            ASSERT_EQ (inpdb[idx], pdb::pdbval_t (outpdb[idx] - 1));
+            ASSERT_EQ (mapped[idx], pdb::pdbval_t (outpdb[idx] - 1));
+        }
+        EXPECT_THROW (inpdb.ref (0) = 0, runtime_error);
+
+        // files with format v1 can not store nibbles
+        EXPECT_THROW (outpdb.write (path, pdb::pdb_format::v1, 1, pdb::pdb_encoding::nibble), invalid_argument);
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+
+    // PDBs with values that do not fit in a nibble can not be written with
+    // it
+    npancake_t::init (npancake_variant::heavy_cost, 1);
+    auto goal = succListInt (8);
+    string ipattern = "-----***";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+    ASSERT_FALSE (outpdb.fits (pdb::pdb_encoding::nibble));
+    EXPECT_THROW (outpdb.write (generate_random_path (), pdb::pdb_format::v2, 1, pdb::pdb_encoding::nibble), out_of_range);
+}
+
+// check that PDBs written with values encoded modulo 3 are correctly
+// recovered, either from the value of the parent or from the abstract goal
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeMod3) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    for (auto ipattern : generatePatterns (4, 4)) {
+
+        // generate a PDB and write it encoded modulo 3
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        ASSERT_TRUE (outpdb.fits (pdb::pdb_encoding::mod3));
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, pdb::pdb_encoding::mod3));
+
+        // the file takes a quarter of the space of the values
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+        ASSERT_EQ (inpdb.get_encoding (), pdb::pdb_encoding::mod3);
+        ASSERT_EQ (inpdb.get_nbbytes (), (outpdb.capacity () + 3) / 4);
+        ASSERT_TRUE (inpdb.verify ());
+
+        // the value of random permutations is recovered from the goal, and
+        // the value of their children from it
+        for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            pdb::pdbval_t h = inpdb.value (perm);
+            ASSERT_EQ (h, pdb::pdbval_t (outpdb[perm] - 1));
+
+            vector<tuple<pdb::pdbval_t, npancake_t>> successors;
+            npancake_t (perm).children (successors);
+            for (auto const& [cost, child] : successors) {
+                ASSERT_EQ (inpdb.value (child.get_perm (), h), pdb::pdbval_t (outpdb[child.get_perm ()] - 1));
+            }
+        }
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+
+    // PDBs whose adjacent values differ in more than one unit can not be
+    // encoded modulo 3
+    npancake_t::init (npancake_variant::heavy_cost, 1);
+    string ipattern = "-----***";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+    ASSERT_FALSE (outpdb.fits (pdb::pdb_encoding::mod3));
+    EXPECT_THROW (outpdb.write (generate_random_path (), pdb::pdb_format::v2, 1, pdb::pdb_encoding::mod3), out_of_range);
+
+    // neither additive PDBs, whose free moves leave abstract states without
+    // any neighbour closer to the goal, even in the unit variant
+    npancake_t::init (npancake_variant::unit, 1);
+    pdb::outpdb<pdb::node_t<npancake_t>> apdb (pdb::pdb_mode::add, goal, "----****", "----****");
+    apdb.generate ();
+    ASSERT_FALSE (apdb.fits (pdb::pdb_encoding::mod3));
+    EXPECT_THROW (apdb.write (generate_random_path (), pdb::pdb_format::v2, 1, pdb::pdb_encoding::mod3), invalid_argument);
+
+    // and files of additive PDBs which claim to be encoded modulo 3 are
+    // rejected
+    auto path = generate_random_path ();
+    ASSERT_TRUE (apdb.write (path));
+    {
+        fstream file (path, ios::binary | ios::in | ios::out);
+        file.seekp (5);
+        file.put (char (pdb::pdb_encoding::mod3));
+    }
+    pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+    ASSERT_EQ (inpdb.read (), 0);
+    ASSERT_EQ (inpdb.get_in_error (), pdb::in_error_message::pdb_format_not_supported);
+    error_code ec;
+    ASSERT_TRUE (std::filesystem::remove(path, ec));
+}
+
+// check that PDBs whose values do not fit in a byte are generated with words,
+// and that they are correctly read and mapped either with tribbles or words
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeWide) {
+
+    // the heavy-cost variant with a large default cost can not bound its
+    // values with bytes, so that PDBs are generated with words
+    npancake_t::init (npancake_variant::heavy_cost, 150);
+    auto goal = succListInt (8);
+    pdb::outpdb<pdb::node_t<npancake_t>> hpdb (pdb::pdb_mode::max, goal, "-*******", "-*******");
+    hpdb.generate ();
+    ASSERT_TRUE (hpdb.doctor ());
+    ASSERT_EQ (hpdb.get_encoding (), pdb::pdb_encoding::word);
+
+    for (auto ipattern : generatePatterns (4, 4)) {
+
+        // generate the PDB from its abstract graph mapping every class to a
+        // cost equal to 300, so that all values but the goal's exceed the
+        // range of bytes
+        npancake_t::init (npancake_variant::heavy_cost, 0);
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        pdb::graph_t graph;
+        outpdb.generate_graph (graph);
+        for (auto i = 0 ; i <= std::numeric_limits<pdb::pdbval_t>::max () ; i++) {
+            graph.set_cost (pdb::pdbval_t (i), 300);
+        }
+        outpdb.generate (graph);
+        ASSERT_TRUE (outpdb.doctor ());
+        ASSERT_EQ (outpdb.get_encoding (), pdb::pdb_encoding::word);
+        ASSERT_FALSE (outpdb.fits (pdb::pdb_encoding::byte));
+        ASSERT_EQ (outpdb.best_encoding (), pdb::pdb_encoding::tribble);
+        EXPECT_THROW (outpdb.write (generate_random_path (), pdb::pdb_format::v2, 1, pdb::pdb_encoding::byte), out_of_range);
+        EXPECT_THROW (outpdb.write (generate_random_path (), pdb::pdb_format::v1), out_of_range);
+        EXPECT_THROW (outpdb.write (generate_random_path (), pdb::pdb_format::v1, 1, pdb::pdb_encoding::tribble), invalid_argument);
+
+        for (auto encoding : {pdb::pdb_encoding::tribble, pdb::pdb_encoding::word}) {
+
+            // write it with the given encoding
+            auto path = generate_random_path ();
+            ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, encoding));
+
+            // and its values are the same generated, either read or mapped
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+            ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+            ASSERT_EQ (inpdb.get_encoding (), encoding);
+            ASSERT_EQ (inpdb.get_nbbytes (), pdb::encoding_bytes (encoding, outpdb.capacity ()));
+            ASSERT_TRUE (inpdb.verify ());
+            pdb::inpdb<pdb::node_t<npancake_t>> mapped (path);
+            ASSERT_EQ (mapped.map (), outpdb.capacity ());
+            ASSERT_TRUE (mapped.verify ());
+            for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+                ASSERT_EQ (inpdb[idx], pdb::pdbval_t (outpdb[idx] - 1));
+                ASSERT_EQ (mapped[idx], pdb::pdbval_t (outpdb[idx] - 1));
+            }
+
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(path, ec));
+        }
+    }
+}
+
+// check that PDBs generated, read and mapped with any pages and placement are
+// the same generated and read by default
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakePlacement) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (8);
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // generate the same PDB by default and with random pages and
+        // placement
+        string ipattern = (rand () % 2) ? "-----***" : "--*-*-*-";
+        auto pages = pdb::pdb_pages (rand () % 4);
+        auto placement = pdb::pdb_placement (rand () % 3);
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        pdb::outpdb<pdb::node_t<npancake_t>> ppdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        ppdb.place (pages, placement);
+        ASSERT_EQ (ppdb.get_pages (), pages);
+        ASSERT_EQ (ppdb.get_placement (), placement);
+        ppdb.generate (false, 1 + rand () % 4);
+        ASSERT_TRUE (ppdb.doctor ());
+        if (pages == pdb::pdb_pages::normal) {
+            ASSERT_EQ (ppdb.get_pages_used (), pdb::pdb_pages::normal);
+        }
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            ASSERT_EQ (ppdb[idx], outpdb[idx]);
+        }
+        auto path = generate_random_path ();
+        ASSERT_TRUE (ppdb.write (path));
+
+        // and read and map it with random pages and placement
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        inpdb.place (pdb::pdb_pages (rand () % 4), placement);
+        ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+        ASSERT_TRUE (inpdb.verify ());
+        pdb::inpdb<pdb::node_t<npancake_t>> mapped (path);
+        mapped.place (pages, placement);
+        ASSERT_EQ (mapped.map (), outpdb.capacity ());
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            ASSERT_EQ (inpdb[idx], pdb::pdbval_t (outpdb[idx] - 1));
+            ASSERT_EQ (mapped[idx], pdb::pdbval_t (outpdb[idx] - 1));
+        }
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that PDBs written with compressed values are correctly read with any
+// encoding and number of threads, whereas they can not be mapped
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeCompressed) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // generate a PDB large enough to take several blocks
+    auto goal = succListInt (9);
+    string ipattern = (rand () % 2) ? "-------**" : "--*-*----";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // and write it compressed with a random encoding
+        auto encoding = pdb::pdb_encoding (rand () % 3);
+        auto path = generate_random_path ();
+        ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1 + rand () % 4, encoding, pdb::pdb_compression::rle));
+
+        // the file is smaller than the values, and all of them are read
+        pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+        ASSERT_EQ (inpdb.read (rand () % 4), outpdb.capacity ());
+        ASSERT_EQ (inpdb.get_compression (), pdb::pdb_compression::rle);
+        ASSERT_EQ (inpdb.get_encoding (), encoding);
+        ASSERT_GT (inpdb.get_header ().get_nbblocks (), (encoding == pdb::pdb_encoding::mod3) ? 0 : 1);
+        ASSERT_LT (std::filesystem::file_size (path),
+                   inpdb.get_header ().get_offset () + pdb::encoding_bytes (encoding, outpdb.capacity ()));
+        ASSERT_EQ (std::filesystem::file_size (path), inpdb.get_header ().get_offset () + inpdb.get_nbbytes ());
+        ASSERT_TRUE (inpdb.verify (1 + rand () % 4));
+
+        // and they are the same generated
+        for (auto j = 0 ; j < NB_TESTS/10 ; j++) {
+            auto perm = succListInt (9);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            ASSERT_EQ (inpdb.value (perm), pdb::pdbval_t (outpdb[perm] - 1));
+        }
+        if (encoding != pdb::pdb_encoding::mod3) {
+            for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+                ASSERT_EQ (inpdb[idx], pdb::pdbval_t (outpdb[idx] - 1));
+            }
+        }
+
+        // compressed files can not be mapped
+        pdb::inpdb<pdb::node_t<npancake_t>> mapped (path);
+        ASSERT_EQ (mapped.map (), 0);
+        ASSERT_EQ (mapped.get_in_error (), pdb::in_error_message::pdb_format_not_supported);
+
+        // nor written with format v1
+        EXPECT_THROW (outpdb.write (path, pdb::pdb_format::v1, 1, encoding, pdb::pdb_compression::rle), invalid_argument);
+
+        // corrupting the end of the last block in the index is detected when
+        // reading the file
+        {
+            pdb::pdboff_t loc = inpdb.get_header ().get_offset () + 8 * inpdb.get_header ().get_nbblocks ();
+            fstream file (path, ios::binary | ios::in | ios::out);
+            file.seekg (loc);
+            char byte = file.get ();
+            file.seekp (loc);
+            file.put (byte ^ char (1 << (rand () % 8)));
+        }
+        pdb::inpdb<pdb::node_t<npancake_t>> corrupted (path);
+        ASSERT_EQ (corrupted.read (), 0);
+        ASSERT_EQ (corrupted.get_in_error (), pdb::in_error_message::pdb_block_corrupted);
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that batched lookups of several PDBs return the same values than
+// looking up every permutation separately, with any encoding
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeBatchedLookup) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // generate a number of PDBs with different patterns and write them with
+    // a random encoding
+    auto goal = succListInt (8);
+    vector<string> patterns = {"-----***", "***-----", "--*--*-*"};
+    vector<std::filesystem::path> paths;
+    vector<unique_ptr<pdb::outpdb<pdb::node_t<npancake_t>>>> outpdbs;
+    for (const auto& pattern : patterns) {
+        outpdbs.push_back (make_unique<pdb::outpdb<pdb::node_t<npancake_t>>> (pdb::pdb_mode::max, goal, pattern, pattern));
+        outpdbs.back ()->generate ();
+        paths.push_back (generate_random_path ());
+        ASSERT_TRUE (outpdbs.back ()->write (paths.back (), pdb::pdb_format::v2, 1, pdb::pdb_encoding (rand () % 3)));
+    }
+    pdb::inpdbs<pdb::node_t<npancake_t>> inpdbs (paths);
+    ASSERT_TRUE (inpdbs.read ());
+
+    vector<pdb::pdboff_t> indices;
+    vector<pdb::pdbval_t> values;
+    vector<vector<pdb::pdboff_t>> mindices;
+    vector<vector<pdb::pdbval_t>> mvalues;
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // compute the children of a random permutation
+        auto perm = succListInt (8);
+        shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+        vector<tuple<pdb::pdbval_t, npancake_t>> successors;
+        npancake_t (perm).children (successors);
+        vector<vector<int>> perms;
+        for (auto const& [cost, child] : successors) {
+            perms.push_back (child.get_perm ());
+        }
+
+        // batched lookups of the PDBs generated are the same than separate
+        // lookups
+        for (const auto& outpdb : outpdbs) {
+            outpdb->lookup (perms, indices, values);
+            ASSERT_EQ (values.size (), perms.size ());
+            for (size_t j = 0 ; j < perms.size () ; j++) {
+                ASSERT_EQ (values[j], (*outpdb)[perms[j]]);
+            }
+            outpdb->lookup (successors, indices, values);
+            for (size_t j = 0 ; j < perms.size () ; j++) {
+                ASSERT_EQ (values[j], (*outpdb)[perms[j]]);
+            }
+        }
+
+        // and the values of all children in all PDBs read are the same
+        // computed separately from the value of their parent
+        vector<pdb::pdbval_t> parents;
+        for (size_t j = 0 ; j < inpdbs.size () ; j++) {
+            parents.push_back (inpdbs[j].value (perm));
+        }
+        inpdbs.value (successors, parents, mindices, mvalues);
+        ASSERT_EQ (mvalues.size (), inpdbs.size ());
+        for (size_t j = 0 ; j < inpdbs.size () ; j++) {
+            inpdbs[j].value (successors, parents[j], indices, values);
+            ASSERT_EQ (mvalues[j], values);
+            for (size_t k = 0 ; k < perms.size () ; k++) {
+                ASSERT_EQ (values[k], inpdbs[j].value (perms[k], parents[j]));
+                ASSERT_EQ (values[k], pdb::pdbval_t ((*outpdbs[j])[perms[k]] - 1));
+            }
+        }
+    }
+
+    for (const auto& path : paths) {
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove(path, ec));
+    }
+}
+
+// check that the value of the dual state of a permutation is its value when
+// all symbols are preserved, and that it can be combined with the value of the
+// permutation otherwise, with any encoding, and that dual lookups are rejected
+// in the heavy-cost variant
+// ----------------------------------------------------------------------------
+TEST_F (InPDBFixture, NPancakeDual) {
+
+    // Set the unit variant with a default cost equal to one. Dual lookups are
+    // not admissible with the heavy-cost variant
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // use a random goal, so that dual states are not just inverses
+    auto goal = succListInt (8);
+    shuffle (goal.begin (), goal.end (), mt19937 (rand ()));
+    pdb::outpdb<pdb::node_t<npancake_t>> full (pdb::pdb_mode::max, goal, "--------", "--------");
+    full.generate ();
+    for (auto ipattern : {string ("-----***"), string ("*-*-*-*-"), string ("--------")}) {
+
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        for (auto encoding : {pdb::pdb_encoding::byte, pdb::pdb_encoding::nibble, pdb::pdb_encoding::mod3}) {
+            auto path = generate_random_path ();
+            ASSERT_TRUE (outpdb.write (path, pdb::pdb_format::v2, 1, encoding));
+            pdb::inpdb<pdb::node_t<npancake_t>> inpdb (path);
+            ASSERT_EQ (inpdb.read (), outpdb.capacity ());
+
+            for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+                auto perm = succListInt (8);
+                shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+
+                // the value of the dual state is the value of the dual
+                // permutation, and both are admissible
+                pdb::pdbval_t h = inpdb.value (perm);
+                pdb::pdbval_t dh = inpdb.dual_value (perm);
+                ASSERT_EQ (dh, inpdb.value (inpdb.dual (perm)));
+                ASSERT_EQ (inpdb.max_dual (perm), max (h, dh));
+                ASSERT_LE (dh, pdb::pdbval_t (full[perm] - 1));
+
+                // with all symbols, both states are equally distant from the
+                // goal
+                if (ipattern == "--------") {
+                    ASSERT_EQ (dh, h);
+                }
+            }
+
+            // dual lookups are rejected as soon as the costs depend on the
+            // discs moved
+            auto perm = succListInt (8);
+            npancake_t::init (npancake_variant::heavy_cost, 1);
+            ASSERT_THROW (inpdb.dual_value (perm), std::invalid_argument);
+            ASSERT_THROW (inpdb.max_dual (perm), std::invalid_argument);
+            npancake_t::init (npancake_variant::unit, 1);
+
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(path, ec));
+        }
+    }
+}
+
 // Local Variables:
 // mode:cpp
 // fill-column:80
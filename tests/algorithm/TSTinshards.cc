@@ -0,0 +1,203 @@
+// -*- coding: utf-8 -*-
+// TSTinshards.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 20:34:45.170365925 (1792355685)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing PDBs stored in shards
+//
+
+#include "../fixtures/TSTinshardsfixture.h"
+
+using namespace std;
+
+// check that indices are correctly serialized and deserialized, and that
+// shards cover the whole address space
+// ----------------------------------------------------------------------------
+TEST_F (InShardsFixture, Index) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        auto goal = succListInt (1 + rand () % 20);
+        string pattern (goal.size (), '-');
+        pdb::pdboff_t pspace = 1 + rand () % (1<<20);
+        pdb::pdboff_t length = 1 + rand () % (1<<12);
+        pdb::index_t index (pdb::pdb_mode::max, goal, pattern, pattern, pspace, length);
+
+        // every location belongs to exactly one shard
+        pdb::pdboff_t count = 0;
+        for (pdb::pdboff_t shard = 0 ; shard < index.get_nbshards () ; shard++) {
+            ASSERT_EQ (index.get_first (shard), count);
+            ASSERT_GT (index.get_count (shard), 0);
+            ASSERT_EQ (index.get_shard (index.get_first (shard)), shard);
+            count += index.get_count (shard);
+        }
+        ASSERT_EQ (count, pspace);
+
+        // the index read is the same written
+        auto bytes = index.serialize ();
+        stringstream stream;
+        stream.write (reinterpret_cast<const char*> (bytes.data ()), bytes.size ());
+        pdb::index_t other;
+        pdb::in_error_message error;
+        ASSERT_TRUE (other.deserialize (stream, error));
+        ASSERT_EQ (other.get_mode (), index.get_mode ());
+        ASSERT_EQ (other.get_goal (), index.get_goal ());
+        ASSERT_EQ (other.get_ppattern (), index.get_ppattern ());
+        ASSERT_EQ (other.get_cpattern (), index.get_cpattern ());
+        ASSERT_EQ (other.get_address_space (), pspace);
+        ASSERT_EQ (other.get_shard_length (), length);
+
+        // and it can not be read if any byte is modified
+        bytes[rand () % bytes.size ()] ^= uint8_t (1 << (rand () % 8));
+        stringstream corrupted;
+        corrupted.write (reinterpret_cast<const char*> (bytes.data ()), bytes.size ());
+        ASSERT_FALSE (other.deserialize (corrupted, error));
+    }
+}
+
+// check that PDBs written in shards are correctly read by several threads
+// ----------------------------------------------------------------------------
+TEST_F (InShardsFixture, NPancakeRead) {
+
+    // Set the heavy-cost variant
+    npancake_t::init (npancake_variant::heavy_cost);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // generate a PDB and write it in shards of a random length with a
+        // random number of threads
+        auto goal = succListInt (8);
+        string ipattern = "-----***";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+        pdb::pdboff_t length = 1 + rand () % outpdb.capacity ();
+        ASSERT_TRUE (outpdb.write_shards (path, length, 1 + rand () % 4));
+        ASSERT_TRUE (pdb::index_t::probe (path));
+
+        // read all shards with a random number of threads, where non
+        // positive values use one thread per shard
+        pdb::inshards<pdb::node_t<npancake_t>> inshards (path);
+        ASSERT_EQ (inshards.read (rand () % 6 - 1), outpdb.capacity ());
+        ASSERT_EQ (inshards.get_nbloaded (), inshards.get_nbshards ());
+        ASSERT_EQ (inshards.get_nbbytes (), outpdb.capacity ());
+        ASSERT_EQ (inshards.get_goal (), goal);
+        ASSERT_EQ (inshards.get_ppattern (), ipattern);
+        ASSERT_EQ (inshards.get_cpattern (), ipattern);
+        ASSERT_TRUE (inshards.verify (1 + rand () % 4));
+
+        // and verify their contents are the same generated
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            ASSERT_EQ (inshards[idx], pdb::pdbval_t (outpdb[idx] - 1));
+        }
+
+        remove_shards (path, inshards.get_nbshards ());
+    }
+}
+
+// check that shards are loaded only when they are accessed
+// ----------------------------------------------------------------------------
+TEST_F (InShardsFixture, NPancakeLazy) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        auto goal = succListInt (8);
+        string ipattern = "-----***";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+        pdb::pdboff_t length = 1 + rand () % 1000;
+        ASSERT_TRUE (outpdb.write_shards (path, length));
+
+        // opening the PDB loads no shard at all
+        pdb::inshards<pdb::node_t<npancake_t>> inshards (path);
+        ASSERT_EQ (inshards.open (), outpdb.capacity ());
+        ASSERT_EQ (inshards.get_nbloaded (), 0);
+
+        // every query loads at most one shard, and it returns the same value
+        // generated
+        for (auto j = 0 ; j < 10 ; j++) {
+            auto perm = random_perm (goal);
+            auto nbloaded = inshards.get_nbloaded ();
+            ASSERT_EQ (inshards[perm], pdb::pdbval_t (outpdb[perm] - 1));
+            ASSERT_LE (inshards.get_nbloaded (), nbloaded + 1);
+        }
+
+        // shards can be also loaded explicitly
+        pdb::pdboff_t shard = rand () % inshards.get_nbshards ();
+        ASSERT_TRUE (inshards.load (shard));
+        ASSERT_TRUE (inshards.is_loaded (shard));
+        ASSERT_LE (inshards.get_nbloaded (), 11);
+        ASSERT_TRUE (inshards.verify ());
+
+        remove_shards (path, inshards.get_nbshards ());
+    }
+}
+
+// check that errors in shards are correctly detected
+// ----------------------------------------------------------------------------
+TEST_F (InShardsFixture, NPancakeErrors) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        auto goal = succListInt (7);
+        string ipattern = "----***";
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        auto path = generate_random_path ();
+        pdb::pdboff_t length = 1 + rand () % (outpdb.capacity () / 2);
+        ASSERT_TRUE (outpdb.write_shards (path, length));
+        pdb::pdboff_t nbshards = outpdb.get_index (length).get_nbshards ();
+
+        // a shard with a different length does not match the index
+        ASSERT_TRUE (outpdb.write_shard (path, 0, length + 1));
+        pdb::inshards<pdb::node_t<npancake_t>> mismatch (path);
+        ASSERT_EQ (mismatch.read (), 0);
+        ASSERT_EQ (mismatch.get_in_error (), pdb::in_error_message::pdb_shard_mismatch);
+
+        // a missing shard can not be read. If it is loaded on demand, the
+        // PDB can be opened, but accessing its locations raises an exception
+        error_code ec;
+        ASSERT_TRUE (outpdb.write_shard (path, 0, length));
+        pdb::pdboff_t shard = rand () % nbshards;
+        ASSERT_TRUE (std::filesystem::remove (pdb::index_t::shard_path (path, shard), ec));
+        pdb::inshards<pdb::node_t<npancake_t>> missing (path);
+        ASSERT_EQ (missing.read (), 0);
+        ASSERT_EQ (missing.get_in_error (), pdb::in_error_message::file_could_not_be_opened);
+        pdb::inshards<pdb::node_t<npancake_t>> lazy (path);
+        ASSERT_EQ (lazy.open (), outpdb.capacity ());
+        ASSERT_THROW (lazy[lazy.get_index ().get_first (shard)], runtime_error);
+        ASSERT_FALSE (lazy.load (shard));
+        ASSERT_THROW (lazy.load (nbshards), out_of_range);
+
+        remove_shards (path, nbshards);
+    }
+
+    // PDBs whose values do not fit in a byte can not be written in shards,
+    // and nothing is written, whatever the number of threads
+    npancake_t::init (npancake_variant::heavy_cost, 150);
+    auto goal = succListInt (8);
+    string ipattern = "--******";
+    pdb::outpdb<pdb::node_t<npancake_t>> wide (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    wide.generate ();
+    ASSERT_FALSE (wide.fits (pdb::pdb_encoding::byte));
+    auto path = generate_random_path ();
+    ASSERT_FALSE (wide.write_shards (path, 8, 2));
+    ASSERT_FALSE (std::filesystem::exists (path));
+    ASSERT_FALSE (std::filesystem::exists (pdb::index_t::shard_path (path, 0)));
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -225,8 +225,8 @@ TEST_F (OutPDBFixture, NPancakeUnitMaxRandAccess) {
 
                 // update its value with a random value (which might be the
                 // same than the previous one or not)
-                pdb::pdbval_t newval = pdb::pdbval_t (rand ()%std::numeric_limits<pdb::pdbval_t>::max());
-                pdb[loc] = newval;
+                pdb::pdbval_t newval = pdb::pdbval_t (rand ()%pdb::encoding_max (pdb::pdb_encoding::byte));
+                pdb.ref (loc) = newval;
 
                 // and verify the new value has been correctly set
                 ASSERT_EQ (newval, pdb[loc]);
@@ -299,6 +299,65 @@ TEST_F (OutPDBFixture, NPancakeUnitMaxWrite) {
     }
 }
 
+// check that writing PDBs does not modify them, so that they can be written
+// again or used right after
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeUnitMaxWriteUnchanged) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // Use pancakes of length 8
+    auto length = 8;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+            vector<pdb::pdbval_t> values (pdb.capacity ());
+            for (auto idx = 0 ; idx < pdb.capacity () ; idx++) {
+                values[idx] = pdb[idx];
+            }
+
+            // write the PDB twice with a random format
+            auto format = (rand () % 2) ? pdb::pdb_format::v1 : pdb::pdb_format::v2;
+            vector<std::filesystem::path> paths;
+            for (auto i = 0 ; i < 2 ; i++) {
+                std::filesystem::path temp_file;
+                do {
+                    auto now = std::chrono::system_clock::now().time_since_epoch().count();
+                    temp_file = std::filesystem::temp_directory_path() / (std::to_string(now) + "_" + ipattern + ".max");
+                } while (std::filesystem::exists(temp_file));
+                ASSERT_TRUE (pdb.write (temp_file, format));
+                paths.push_back (temp_file);
+
+                // and verify the PDB is still the same
+                ASSERT_TRUE (pdb.doctor ());
+                for (auto idx = 0 ; idx < pdb.capacity () ; idx++) {
+                    ASSERT_EQ (pdb[idx], values[idx]);
+                }
+            }
+
+            // both files are the same, and they store all values decremented
+            // in one unit
+            std::ifstream in0 (paths[0], std::ios::binary), in1 (paths[1], std::ios::binary);
+            vector<char> contents0 ((std::istreambuf_iterator<char> (in0)), std::istreambuf_iterator<char> ());
+            vector<char> contents1 ((std::istreambuf_iterator<char> (in1)), std::istreambuf_iterator<char> ());
+            ASSERT_EQ (contents0, contents1);
+            size_t offset = contents0.size () - pdb.capacity ();
+            for (auto idx = 0 ; idx < pdb.capacity () ; idx++) {
+                ASSERT_EQ (pdb::pdbval_t (contents0[offset + idx]), values[idx] - 1);
+            }
+
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(paths[0], ec));
+            ASSERT_TRUE (std::filesystem::remove(paths[1], ec));
+        }
+    }
+}
+
 // check that MAX PDBs are correctly generated in the heavy-cost variant of the
 // N-Pancake domain
 // ----------------------------------------------------------------------------
@@ -487,8 +546,8 @@ TEST_F (OutPDBFixture, NPancakeHeavyCostMaxRandAccess) {
 
                 // update its value with a random value (which might be the
                 // same than the previous one or not)
-                pdb::pdbval_t newval = pdb::pdbval_t (rand ()%std::numeric_limits<pdb::pdbval_t>::max());
-                pdb[loc] = newval;
+                pdb::pdbval_t newval = pdb::pdbval_t (rand ()%pdb::encoding_max (pdb::pdb_encoding::byte));
+                pdb.ref (loc) = newval;
 
                 // and verify the new value has been correctly set
                 ASSERT_EQ (newval, pdb[loc]);
@@ -572,9 +631,9 @@ TEST_F (OutPDBFixture, NPancakeHeavyCostMaxWrite) {
 // ----------------------------------------------------------------------------
 TEST_F (OutPDBFixture, NPancakeHeavyCostGenerationOutOfRange) {
 
-    // Set the unit variant with a default cost equal to 150, enough to exceed
-    // the range of pdbval_t
-    npancake_t::init (npancake_variant::heavy_cost, 150);
+    // Set the heavy-cost variant with the largest default cost, enough to
+    // exceed the range of words
+    npancake_t::init (npancake_variant::heavy_cost, std::numeric_limits<pdb::pdbval_t>::max ());
 
     // Use pancakes of length 8
     auto length = 8;
@@ -593,6 +652,644 @@ TEST_F (OutPDBFixture, NPancakeHeavyCostGenerationOutOfRange) {
     EXPECT_THROW (pdb.generate (), runtime_error);
  }
 
+// check that MAX PDBs regenerated from the abstract graph with the cost model
+// of the unit variant are strictly the same than those generated searching in
+// the abstract state space
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeUnitGraphGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate the graph with the heavy-cost variant and a default
+            // cost equal to zero, so that classes are the discs below the
+            // spatula
+            npancake_t::init (npancake_variant::heavy_cost, 0);
+            pdb::outpdb<pdb::node_t<npancake_t>> gpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb::graph_t graph;
+            gpdb.generate_graph (graph);
+
+            // and map every class to a unit cost
+            for (auto i = 0 ; i <= std::numeric_limits<pdb::pdbval_t>::max () ; i++) {
+                graph.set_cost (pdb::pdbval_t (i), 1);
+            }
+            gpdb.generate (graph);
+            ASSERT_TRUE (gpdb.doctor ());
+
+            // generate the same PDB searching in the abstract state space
+            npancake_t::init (npancake_variant::unit, 1);
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (gpdb.size (), pdb.size ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (gpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that MAX PDBs regenerated from the abstract graph with the cost model
+// of the heavy-cost variant are strictly the same than those generated
+// searching in the abstract state space
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostGraphGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate the graph with the heavy-cost variant and a default
+            // cost equal to zero
+            npancake_t::init (npancake_variant::heavy_cost, 0);
+            pdb::outpdb<pdb::node_t<npancake_t>> gpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb::graph_t graph;
+            gpdb.generate_graph (graph);
+
+            // map the class zero to a random default cost, and regenerate
+            // the PDB from the graph
+            pdb::pdbval_t cost = 1 + rand () % length;
+            graph.set_cost (0, cost);
+            gpdb.generate (graph);
+            ASSERT_TRUE (gpdb.doctor ());
+
+            // generate the same PDB searching in the abstract state space
+            npancake_t::init (npancake_variant::heavy_cost, cost);
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (gpdb.size (), pdb.size ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (gpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that the same instance can be regenerated from the abstract graph for
+// different cost models, with the same PDBs generated from scratch
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeGraphRegeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto ipattern : generatePatterns (3, length-3)) {
+
+        // generate the graph with the heavy-cost variant and a default cost
+        // equal to zero, so that classes are the discs below the spatula
+        npancake_t::init (npancake_variant::heavy_cost, 0);
+        pdb::outpdb<pdb::node_t<npancake_t>> gpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        pdb::graph_t graph;
+        gpdb.generate_graph (graph);
+
+        // regenerate the PDB with the unit cost model and then with the
+        // heavy-cost model, several times each
+        for (auto i = 0 ; i < 4 ; i++) {
+            pdb::pdbval_t cost = 1 + rand () % length;
+            for (auto j = 0 ; j <= std::numeric_limits<pdb::pdbval_t>::max () ; j++) {
+                graph.set_cost (pdb::pdbval_t (j), (i % 2) ? pdb::pdbval_t (j) : pdb::pdbval_t (1));
+            }
+            graph.set_cost (0, (i % 2) ? cost : pdb::pdbval_t (1));
+            gpdb.generate (graph);
+            ASSERT_EQ (gpdb.get_nbexpansions (), pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern));
+            ASSERT_TRUE (gpdb.doctor ());
+
+            // and verify it is strictly the same generated from scratch
+            if (i % 2) {
+                npancake_t::init (npancake_variant::heavy_cost, cost);
+            } else {
+                npancake_t::init (npancake_variant::unit, 1);
+            }
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+            ASSERT_EQ (gpdb.size (), pdb.size ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (gpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that graphs can not be used to generate PDBs with different patterns
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeGraphIncompatible) {
+
+    npancake_t::init (npancake_variant::heavy_cost, 0);
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    // generate the graph of a pattern
+    pdb::outpdb<pdb::node_t<npancake_t>> gpdb (pdb::pdb_mode::max, goal, "--*****", "--*****");
+    pdb::graph_t graph;
+    gpdb.generate_graph (graph);
+
+    // and use it with a different one
+    pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, "-*-****", "-*-****");
+    EXPECT_THROW (pdb.generate (graph), invalid_argument);
+}
+
+// check that MAX PDBs generated in parallel in the unit variant of the
+// N-Pancake are strictly the same than those generated with only one thread
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeUnitParallelGeneration) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate the PDB with a random number of threads in the range
+            // [2, 8] and verify it has been correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> ppdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            ppdb.generate (false, 2 + rand () % 7);
+            ASSERT_TRUE (ppdb.doctor ());
+
+            // generate the same PDB with only one thread
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (ppdb.size (), pdb.size ());
+            ASSERT_EQ (ppdb.get_nbexpansions (), pdb.get_nbexpansions ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (ppdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that MAX PDBs generated in parallel in the heavy-cost variant of the
+// N-Pancake are strictly the same than those generated with only one thread
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostParallelGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // set the default cost corresponding to this pattern
+            npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+
+            // generate the PDB with a random number of threads in the range
+            // [2, 8] and verify it has been correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> ppdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            ppdb.generate (false, 2 + rand () % 7);
+            ASSERT_TRUE (ppdb.doctor ());
+
+            // generate the same PDB with only one thread
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (ppdb.size (), pdb.size ());
+            ASSERT_EQ (ppdb.get_nbexpansions (), pdb.get_nbexpansions ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (ppdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that the parallel generation of MAX PDBs correctly detects the case
+// out of bounds returning an exception in the heavy-cost variant of the
+// N-Pancake
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostParallelGenerationOutOfRange) {
+
+    // Set the largest default cost, enough to exceed the range of words
+    npancake_t::init (npancake_variant::heavy_cost, std::numeric_limits<pdb::pdbval_t>::max ());
+
+    // consider simply the case that preserves the first symbol in the goal
+    // state of the 8-Pancake
+    auto length = 8;
+    auto goal = succListInt (length);
+    string ipattern = "-" + string (length-1, '*');
+    pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+
+    // and generate the pdb. Check that a runtime_error is generated
+    EXPECT_THROW (pdb.generate (false, 4), runtime_error);
+}
+
+// check that MAX PDBs generated in the heavy-cost variant of the N-Pancake with
+// several worker processes are strictly the same than those generated with
+// only one thread
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostWorkersGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // set the default cost corresponding to this pattern
+            npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+
+            // generate the PDB with a random number of workers in the range
+            // [1, 4] and verify it has been correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> wpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            wpdb.generate_workers (1 + rand () % 4);
+            ASSERT_TRUE (wpdb.doctor ());
+
+            // generate the same PDB with only one thread
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (wpdb.size (), pdb.size ());
+            ASSERT_EQ (wpdb.get_nbexpansions (), pdb.get_nbexpansions ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (wpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that PDBs of the heavy-cost variant of the N-Pancake whose values are
+// stored in words are generated by worker processes strictly the same than
+// with only one thread
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostWorkersGenerationWide) {
+
+    // pancakes of length 12 bound their values beyond the range of bytes
+    auto length = 12;
+    auto goal = succListInt (length);
+    for (auto ipattern : {string ("---*********"), string ("*-*-*-******")}) {
+
+        npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+        pdb::outpdb<pdb::node_t<npancake_t>> wpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        wpdb.generate_workers (2 + rand () % 3);
+        ASSERT_EQ (wpdb.get_encoding (), pdb::pdb_encoding::word);
+        ASSERT_TRUE (wpdb.doctor ());
+
+        pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        pdb.generate (false, 1);
+        ASSERT_EQ (wpdb.size (), pdb.size ());
+        ASSERT_EQ (wpdb.get_nbexpansions (), pdb.get_nbexpansions ());
+        for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+            ASSERT_EQ (wpdb[idx], pdb[idx]);
+        }
+    }
+}
+
+// check that errors in worker processes are reported to the caller
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostWorkersGenerationOutOfRange) {
+
+    // Set the largest default cost, enough to exceed the range of words
+    npancake_t::init (npancake_variant::heavy_cost, std::numeric_limits<pdb::pdbval_t>::max ());
+
+    // consider simply the case that preserves the first symbol in the goal
+    // state of the 8-Pancake
+    auto length = 8;
+    auto goal = succListInt (length);
+    string ipattern = "-" + string (length-1, '*');
+    pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+
+    // and generate the pdb. Check that a runtime_error is generated
+    EXPECT_THROW (pdb.generate_workers (1 + rand () % 4), runtime_error);
+    EXPECT_THROW (pdb.generate_workers (0), invalid_argument);
+}
+
+// check that MAX PDBs generated in the heavy-cost variant of the N-Pancake with
+// ring buffers are strictly the same than those generated with open_t
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostRingGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // set the default cost corresponding to this pattern
+            npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+
+            // generate the PDB with a ring buffer and verify it has been
+            // correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> rpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            rpdb.generate<pdb::ring_t> ();
+            ASSERT_TRUE (rpdb.doctor ());
+
+            // generate the same PDB with the default open list
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (rpdb.size (), pdb.size ());
+            ASSERT_EQ (rpdb.get_nbexpansions (), pdb.get_nbexpansions ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (rpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that MAX PDBs generated in the heavy-cost variant of the N-Pancake with
+// radix heaps are strictly the same than those generated with open_t, also
+// when expanding nodes in parallel
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostRadixGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // set the default cost corresponding to this pattern
+            npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+
+            // generate the PDB with a radix heap using either one or two
+            // threads and verify it has been correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> rpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            rpdb.generate<pdb::radix_t> (false, 1 + rand () % 2);
+            ASSERT_TRUE (rpdb.doctor ());
+
+            // generate the same PDB with the default open list
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+
+            // and verify they are strictly the same
+            ASSERT_EQ (rpdb.size (), pdb.size ());
+            for (auto idx = 0 ; idx < pdb.size () ; idx++) {
+                ASSERT_EQ (rpdb[idx], pdb[idx]);
+            }
+        }
+    }
+}
+
+// check that PDBs generated directly in their output file are written exactly
+// like those generated in memory
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostMapGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    // return a unique path in the temporary directory
+    auto unique_path = [] (const string& suffix) {
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + suffix);
+        } while (std::filesystem::exists(path));
+        return path;
+    };
+
+    // return the contents of the given file
+    auto contents = [] (const std::filesystem::path& path) {
+        std::ifstream in (path, std::ios::binary);
+        return vector<char> (std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char> ());
+    };
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // set the default cost corresponding to this pattern
+            npancake_t::init (npancake_variant::heavy_cost, get_default_cost_npancake (goal, ipattern));
+
+            // generate the PDB in its output file using either one or two
+            // threads, verify it has been correctly generated and write it
+            auto mpath = unique_path ("_" + ipattern + ".mmap");
+            pdb::outpdb<pdb::node_t<npancake_t>> mpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            mpdb.map (mpath);
+            mpdb.generate (false, 1 + rand () % 2);
+            ASSERT_TRUE (mpdb.doctor ());
+            ASSERT_TRUE (mpdb.write (mpath));
+
+            // generate the same PDB in memory and write it to another file
+            auto path = unique_path ("_" + ipattern + ".max");
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb.generate ();
+            ASSERT_TRUE (pdb.write (path));
+
+            // and verify both files are strictly the same
+            ASSERT_EQ (contents (mpath), contents (path));
+
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(mpath, ec));
+            ASSERT_TRUE (std::filesystem::remove(path, ec));
+        }
+    }
+}
+
+// check that PDBs finished in their output file are consumed, and that they
+// can not be written to it with any other format
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeMapFinished) {
+
+    npancake_t::init (npancake_variant::unit, 1);
+    auto goal = succListInt (7);
+    string ipattern = "---****";
+
+    // return a unique path in the temporary directory
+    auto unique_path = [] (const string& suffix) {
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + suffix);
+        } while (std::filesystem::exists(path));
+        return path;
+    };
+
+    // return the contents of the given file
+    auto contents = [] (const std::filesystem::path& path) {
+        std::ifstream in (path, std::ios::binary);
+        return vector<char> (std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char> ());
+    };
+
+    // the same PDB generated in memory is used as a reference
+    auto path = unique_path (".max");
+    pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    pdb.generate ();
+    ASSERT_TRUE (pdb.write (path));
+
+    auto mpath = unique_path (".mmap");
+    auto other = unique_path (".other");
+    pdb::outpdb<pdb::node_t<npancake_t>> mpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    mpdb.map (mpath);
+    for (auto i = 0 ; i < 2 ; i++) {
+
+        // the file being mapped can only be written with format v2
+        mpdb.generate ();
+        ASSERT_FALSE (mpdb.get_finished ());
+        ASSERT_TRUE (mpdb.doctor ());
+        EXPECT_THROW (mpdb.write (mpath, pdb::pdb_format::v1), invalid_argument);
+        ASSERT_TRUE (mpdb.write (mpath));
+        ASSERT_TRUE (mpdb.get_finished ());
+        ASSERT_EQ (contents (mpath), contents (path));
+
+        // once finished, the PDB can not be used anymore, and the file is
+        // left untouched
+        EXPECT_THROW (mpdb.doctor (), invalid_argument);
+        EXPECT_THROW (mpdb.write (mpath), invalid_argument);
+        EXPECT_THROW (mpdb.write (other), invalid_argument);
+        EXPECT_THROW (mpdb.write_shards (other), invalid_argument);
+        ASSERT_EQ (contents (mpath), contents (path));
+        ASSERT_FALSE (std::filesystem::exists (other));
+    }
+
+    error_code ec;
+    ASSERT_TRUE (std::filesystem::remove(mpath, ec));
+    ASSERT_TRUE (std::filesystem::remove(path, ec));
+}
+
+// check that ADD PDBs of the heavy-cost variant of the N-Pancake charge only
+// the moves of the symbols preserved by the p-pattern, with all open lists,
+// threads, workers and from the abstract graph
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeHeavyCostAddGeneration) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 2 ; nbsymbols <= 5 ; nbsymbols++) {
+        for (auto cpattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // preserve in the p-pattern a random non-empty subset of the
+            // symbols preserved in the c-pattern
+            string ppattern = cpattern;
+            for (auto& symbol : ppattern) {
+                symbol = (symbol == '-' && rand () % 2) ? '-' : '*';
+            }
+            if (ppattern.find ('-') == string::npos) {
+                ppattern[cpattern.find ('-')] = '-';
+            }
+
+            // set the default cost corresponding to the c-pattern
+            pdb::pdbval_t cost = get_default_cost_npancake (goal, cpattern);
+            npancake_t::init (npancake_variant::heavy_cost, cost);
+            auto expected = additive_npancake (goal, cpattern, ppattern);
+
+            // generate the PDB with every open list and verify it has been
+            // correctly generated
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::add, goal, cpattern, ppattern);
+            pdb.generate ();
+            ASSERT_TRUE (pdb.doctor ());
+            ASSERT_EQ (pdb.get_nbexpansions (), pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (cpattern));
+            pdb::outpdb<pdb::node_t<npancake_t>> rpdb (pdb::pdb_mode::add, goal, cpattern, ppattern);
+            rpdb.generate<pdb::ring_t> (false, 1 + rand () % 2);
+            pdb::outpdb<pdb::node_t<npancake_t>> xpdb (pdb::pdb_mode::add, goal, cpattern, ppattern);
+            xpdb.generate<pdb::radix_t> (false, 1 + rand () % 2);
+            pdb::outpdb<pdb::node_t<npancake_t>> wpdb (pdb::pdb_mode::add, goal, cpattern, ppattern);
+            wpdb.generate_workers (1 + rand () % 3);
+
+            // and also from the abstract graph
+            npancake_t::init (npancake_variant::heavy_cost, 0);
+            pdb::outpdb<pdb::node_t<npancake_t>> gpdb (pdb::pdb_mode::add, goal, cpattern, ppattern);
+            pdb::graph_t graph;
+            gpdb.generate_graph (graph);
+            graph.set_cost (0, cost);
+            gpdb.generate (graph);
+            ASSERT_TRUE (gpdb.doctor ());
+            npancake_t::init (npancake_variant::heavy_cost, cost);
+
+            // the PDB generated with the default cost charging all moves
+            // dominates the additive one
+            pdb::outpdb<pdb::node_t<npancake_t>> mpdb (pdb::pdb_mode::max, goal, cpattern, ppattern);
+            mpdb.generate ();
+
+            ASSERT_EQ (pdb.capacity (), expected.size ());
+            for (pdb::pdboff_t idx = 0 ; idx < pdb.capacity () ; idx++) {
+                ASSERT_EQ (pdb[idx], expected[idx]);
+                ASSERT_EQ (rpdb[idx], expected[idx]);
+                ASSERT_EQ (xpdb[idx], expected[idx]);
+                ASSERT_EQ (wpdb[idx], expected[idx]);
+                ASSERT_EQ (gpdb[idx], expected[idx]);
+                ASSERT_LE (pdb[idx], mpdb[idx]);
+            }
+        }
+    }
+}
+
+// check that the sum of the values of ADD PDBs whose p-patterns are disjoint
+// never exceeds the cost of the optimal path to the goal in both variants, as
+// every reversal is charged to only one of them
+// ----------------------------------------------------------------------------
+TEST_F (OutPDBFixture, NPancakeAddAdmissible) {
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto variant : {npancake_variant::unit, npancake_variant::heavy_cost}) {
+        npancake_t::init (variant, 1);
+
+        // the cost of the optimal path of every permutation is given by a
+        // PDB which preserves all symbols
+        pdb::outpdb<pdb::node_t<npancake_t>> full (pdb::pdb_mode::max, goal, string (length, '-'), string (length, '-'));
+        full.generate ();
+
+        for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+            // split the symbols randomly among a number of p-patterns, and
+            // use either the same c-pattern or one preserving all symbols
+            const int nbpatterns = 2 + rand () % 3;
+            vector<string> ppatterns (nbpatterns, string (length, '*'));
+            for (auto j = 0 ; j < length ; j++) {
+                ppatterns[rand () % nbpatterns][j] = '-';
+            }
+            vector<unique_ptr<pdb::outpdb<pdb::node_t<npancake_t>>>> apdbs;
+            for (const auto& ppattern : ppatterns) {
+                if (ppattern.find ('-') == string::npos) {
+                    continue;
+                }
+                const string cpattern = (rand () % 2) ? ppattern : string (length, '-');
+                apdbs.push_back (make_unique<pdb::outpdb<pdb::node_t<npancake_t>>> (pdb::pdb_mode::add, goal, cpattern, ppattern));
+                apdbs.back ()->generate ();
+                ASSERT_TRUE (apdbs.back ()->doctor ());
+            }
+
+            // and verify the sum of their values is admissible for every
+            // permutation
+            auto perm = goal;
+            do {
+                pdb::pdboff_t h = 0;
+                for (const auto& apdb : apdbs) {
+                    h += (*apdb)[perm] - 1;
+                }
+                ASSERT_LE (h, pdb::pdboff_t (full[perm] - 1));
+            } while (next_permutation (perm.begin (), perm.end ()));
+        }
+    }
+
+    // every state one reversal away from the goal is at most one unit away in
+    // the unit variant
+    npancake_t::init (npancake_variant::unit, 1);
+    vector<int> small = succListInt (5);
+    pdb::outpdb<pdb::node_t<npancake_t>> left (pdb::pdb_mode::add, small, "--***", "--***");
+    left.generate ();
+    pdb::outpdb<pdb::node_t<npancake_t>> right (pdb::pdb_mode::add, small, "**---", "**---");
+    right.generate ();
+    for (auto perm : {vector<int>{5, 4, 3, 2, 1}, vector<int>{3, 2, 1, 4, 5}}) {
+        ASSERT_LE ((left[perm] - 1) + (right[perm] - 1), 1);
+    }
+}
 
 // Local Variables:
 // mode:cpp
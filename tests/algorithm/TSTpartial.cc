@@ -0,0 +1,109 @@
+// -*- coding: utf-8 -*-
+// TSTpartial.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 01:00:36.917462508 (1792371636)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing partial PDBs
+//
+
+#include "../fixtures/TSTpartialfixture.h"
+
+using namespace std;
+
+// check that partial PDBs store exactly the locations whose values exceed the
+// threshold, and that all other locations are looked up as zero
+// ----------------------------------------------------------------------------
+TEST_F (PartialFixture, NPancakeThreshold) {
+
+    // Set the heavy-cost variant
+    npancake_t::init (npancake_variant::heavy_cost);
+
+    auto goal = succListInt (8);
+    for (auto ipattern : generatePatterns (5, 3)) {
+
+        // generate a PDB and keep only the locations above a random
+        // threshold
+        pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+        outpdb.generate ();
+        pdb::pdbval_t threshold = pdb::pdbval_t (rand () % 64);
+        pdb::partial<pdb::node_t<npancake_t>> ppdb (outpdb, threshold);
+        ASSERT_EQ (ppdb.get_threshold (), threshold);
+        ASSERT_EQ (ppdb.get_address_space (), outpdb.capacity ());
+        ASSERT_EQ (ppdb.get_goal (), goal);
+        ASSERT_EQ (ppdb.get_ppattern (), ipattern);
+
+        // every location is stored if and only if its value exceeds the
+        // threshold, and otherwise its value is zero
+        pdb::pdboff_t nbentries = 0, nbtotal = 0, nblost = 0;
+        for (pdb::pdboff_t idx = 0 ; idx < outpdb.capacity () ; idx++) {
+            pdb::pdbval_t value = pdb::pdbval_t (outpdb[idx] - 1);
+            nbtotal += value;
+            if (value > threshold) {
+                ASSERT_TRUE (ppdb.contains (idx));
+                ASSERT_EQ (ppdb[idx], value);
+                nbentries++;
+            } else {
+                ASSERT_FALSE (ppdb.contains (idx));
+                ASSERT_EQ (ppdb[idx], 0);
+                nblost += value;
+            }
+        }
+        ASSERT_EQ (ppdb.get_nbentries (), nbentries);
+        ASSERT_DOUBLE_EQ (ppdb.get_loss (), double (nblost) / outpdb.capacity ());
+        ASSERT_DOUBLE_EQ (ppdb.get_retained (), nbtotal ? 1.0 - double (nblost) / nbtotal : 1.0);
+
+        // and lookups are admissible wrt the original PDB
+        for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+            auto perm = succListInt (8);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            ASSERT_LE (ppdb[perm], outpdb[perm] - 1);
+            ASSERT_EQ (ppdb.value (perm), ppdb[perm]);
+        }
+    }
+}
+
+// check that partial PDBs spanning several buckets are correctly looked up,
+// and that the memory they take decreases with the threshold
+// ----------------------------------------------------------------------------
+TEST_F (PartialFixture, NPancakeBuckets) {
+
+    // Set the unit variant with a default cost equal to one
+    npancake_t::init (npancake_variant::unit, 1);
+
+    auto goal = succListInt (9);
+    string ipattern = "-------**";
+    pdb::outpdb<pdb::node_t<npancake_t>> outpdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+    outpdb.generate ();
+    ASSERT_GT (outpdb.capacity (), pdb::pdboff_t (1) << pdb::partial<pdb::node_t<npancake_t>>::bucket_bits);
+
+    pdb::pdboff_t nbbytes = numeric_limits<pdb::pdboff_t>::max ();
+    double retained = 1.0;
+    for (pdb::pdbval_t threshold = 0 ; threshold < 12 ; threshold++) {
+        pdb::partial<pdb::node_t<npancake_t>> ppdb (outpdb, threshold);
+        ASSERT_LE (ppdb.get_nbbytes (), nbbytes);
+        ASSERT_LE (ppdb.get_retained (), retained);
+        nbbytes = ppdb.get_nbbytes ();
+        retained = ppdb.get_retained ();
+
+        for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+            pdb::pdboff_t idx = rand () % outpdb.capacity ();
+            pdb::pdbval_t value = pdb::pdbval_t (outpdb[idx] - 1);
+            ASSERT_EQ (ppdb[idx], (value > threshold) ? value : 0);
+        }
+    }
+
+    // with a threshold above all values nothing is stored at all
+    pdb::partial<pdb::node_t<npancake_t>> empty (outpdb, numeric_limits<pdb::pdbval_t>::max ());
+    ASSERT_EQ (empty.get_nbentries (), 0);
+    ASSERT_EQ (empty.get_retained (), 0.0);
+    ASSERT_EQ (empty[rand () % outpdb.capacity ()], 0);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,47 @@
+// -*- coding: utf-8 -*-
+// TSTarenafixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 15:31:08.572294110 (1792337468)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing arena_t and bucket_t
+//
+
+#ifndef _TSTARENAFIXTURE_H_
+#define _TSTARENAFIXTURE_H_
+
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/PDBarena_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing arenas and the buckets backed by
+// them
+class ArenaFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+};
+
+#endif // _TSTARENAFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
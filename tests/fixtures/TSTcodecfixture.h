@@ -0,0 +1,71 @@
+// -*- coding: utf-8 -*-
+// TSTcodecfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:58:04.390125817 (1792367884)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing the compression of blocks of bytes
+//
+
+#ifndef _TSTCODECFIXTURE_H_
+#define _TSTCODECFIXTURE_H_
+
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/utils/PDBcodec.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing the compression of blocks
+class CodecFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a vector with the given number of random bytes
+        std::vector<uint8_t> randBytes (const size_t nbbytes) {
+
+            std::vector<uint8_t> bytes (nbbytes);
+            for (auto& byte : bytes) {
+                byte = uint8_t (rand () % 256);
+            }
+            return bytes;
+        }
+
+        // return a vector with the given number of bytes made of runs of
+        // random lengths up to maxrun, with values taken from a small
+        // alphabet as in PDBs
+        std::vector<uint8_t> randRuns (const size_t nbbytes, const int maxrun) {
+
+            std::vector<uint8_t> bytes;
+            bytes.reserve (nbbytes);
+            while (bytes.size () < nbbytes) {
+                uint8_t value = uint8_t (rand () % 16);
+                size_t length = std::min (nbbytes - bytes.size (), size_t (1 + rand () % maxrun));
+                bytes.insert (bytes.end (), length, value);
+            }
+            return bytes;
+        }
+};
+
+#endif // _TSTCODECFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,56 @@
+// -*- coding: utf-8 -*-
+// TSTcrc32cfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 18:06:13.842217530 (1792346773)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing the computation of CRC32C checksums
+//
+
+#ifndef _TSTCRC32CFIXTURE_H_
+#define _TSTCRC32CFIXTURE_H_
+
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/utils/PDBcrc32c.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing CRC32C checksums
+class CRC32CFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a vector with the given number of random bytes
+        std::vector<uint8_t> randBytes (const size_t nbbytes) {
+
+            std::vector<uint8_t> bytes (nbbytes);
+            for (auto& byte : bytes) {
+                byte = uint8_t (rand () % 256);
+            }
+            return bytes;
+        }
+};
+
+#endif // _TSTCRC32CFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
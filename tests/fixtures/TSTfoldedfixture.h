@@ -0,0 +1,60 @@
+// -*- coding: utf-8 -*-
+// TSTfoldedfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:09:41.662058140 (1792364981)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing folded PDBs
+//
+
+#ifndef _TSTFOLDEDFIXTURE_H_
+#define _TSTFOLDEDFIXTURE_H_
+
+#include<algorithm>
+#include<filesystem>
+#include<random>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBfolded.h"
+#include "../../src/algorithm/PDBinpdb.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing folded PDBs
+class FoldedFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+
+    // return a random path in the temporary directory which does not exist
+    std::filesystem::path generate_random_path () {
+
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + ".pdb");
+        } while (std::filesystem::exists(path));
+        return path;
+    }
+};
+
+#endif // _TSTFOLDEDFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,58 @@
+// -*- coding: utf-8 -*-
+// TSTgraphfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 11:02:45.118305521 (1792321365)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture used to test abstract state graphs
+//
+
+#ifndef _TSTGRAPHFIXTURE_H_
+#define _TSTGRAPHFIXTURE_H_
+
+#include<chrono>
+#include<filesystem>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../src/structs/PDBgraph_t.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing abstract state graphs
+class GraphFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+
+    // return a unique path in the temporary directory with the given suffix
+    std::filesystem::path unique_path (const std::string& suffix) {
+        std::filesystem::path temp_file;
+        auto temp_dir = std::filesystem::temp_directory_path();
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            temp_file = temp_dir / (std::to_string(now) + "_" + suffix);
+        } while (std::filesystem::exists(temp_file));
+        return temp_file;
+    }
+};
+
+#endif // _TSTGRAPHFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,67 @@
+// -*- coding: utf-8 -*-
+// TSTheaderfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 19:02:41.517338902 (1792350161)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing header_t
+//
+
+#ifndef _TSTHEADERFIXTURE_H_
+#define _TSTHEADERFIXTURE_H_
+
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/PDBheader_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing headers
+class HeaderFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a random pattern of the given length
+        std::string random_pattern (const int length) {
+
+            std::string pattern;
+            for (auto i = 0 ; i < length ; i++) {
+                pattern += (rand () % 2) ? '-' : '*';
+            }
+            return pattern;
+        }
+
+        // return a stream with the binary representation of the given header
+        std::stringstream to_stream (const pdb::header_t& header) {
+
+            auto bytes = header.serialize ();
+            std::stringstream stream;
+            stream.write (reinterpret_cast<const char*> (bytes.data ()), bytes.size ());
+            return stream;
+        }
+};
+
+#endif // _TSTHEADERFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,86 @@
+// -*- coding: utf-8 -*-
+// TSTheuristic_setfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 02:52:30.604173952 (1792378350)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing heuristic sets
+//
+
+#ifndef _TSTHEURISTIC_SETFIXTURE_H_
+#define _TSTHEURISTIC_SETFIXTURE_H_
+
+#include<chrono>
+#include<filesystem>
+#include<string>
+#include<system_error>
+#include<vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBevaluator.h"
+#include "../../src/algorithm/PDBheuristic_set.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing heuristic sets
+class HeuristicSetFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+
+    // return a path in the temporary directory which does not exist
+    std::filesystem::path generate_random_path () {
+
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + ".pdb");
+        } while (std::filesystem::exists(path));
+        return path;
+    }
+
+    // generate a PDB of the N-Pancake with the given goal and pattern for
+    // every pattern, and write them in new files with the given mode and
+    // encoding. It returns the paths to all files
+    std::vector<std::filesystem::path> generate_pdbs (const pdb::pdb_mode mode, const std::vector<int>& goal,
+                                                      const std::vector<std::string>& patterns,
+                                                      const pdb::pdb_encoding encoding = pdb::pdb_encoding::byte) {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& pattern : patterns) {
+            pdb::outpdb<pdb::node_t<npancake_t>> outpdb (mode, goal, pattern, pattern);
+            outpdb.generate ();
+            paths.push_back (generate_random_path ());
+            EXPECT_TRUE (outpdb.write (paths.back (), pdb::pdb_format::v2, 1, encoding));
+        }
+        return paths;
+    }
+
+    // remove all files in the given paths
+    void remove_pdbs (const std::vector<std::filesystem::path>& paths) {
+        std::error_code ec;
+        for (const auto& path : paths) {
+            std::filesystem::remove (path, ec);
+        }
+    }
+};
+
+#endif // _TSTHEURISTIC_SETFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
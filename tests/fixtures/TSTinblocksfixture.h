@@ -0,0 +1,69 @@
+// -*- coding: utf-8 -*-
+// TSTinblocksfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 00:04:21.526093114 (1792368261)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing compressed PDBs decoded on demand
+//
+
+#ifndef _TSTINBLOCKSFIXTURE_H_
+#define _TSTINBLOCKSFIXTURE_H_
+
+#include<algorithm>
+#include<filesystem>
+#include<random>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBinblocks.h"
+#include "../../src/algorithm/PDBinpdb.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing compressed PDBs decoded on demand
+class InBlocksFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+
+    // return a random path in the temporary directory which does not exist
+    std::filesystem::path generate_random_path () {
+
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + ".pdb");
+        } while (std::filesystem::exists(path));
+        return path;
+    }
+
+    // return a random permutation of the given goal
+    std::vector<int> random_perm (const std::vector<int>& goal) {
+
+        static thread_local std::mt19937 rng (rand ());
+        std::vector<int> perm (goal);
+        std::shuffle (perm.begin (), perm.end (), rng);
+        return perm;
+    }
+};
+
+#endif // _TSTINBLOCKSFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
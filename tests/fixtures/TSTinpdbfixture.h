@@ -14,12 +14,14 @@
 #define _TSTINPDBFIXTURE_H_
 
 #include<filesystem>
+#include<fstream>
 
 #include "gtest/gtest.h"
 
 #include "../TSTdefs.h"
 #include "../TSThelpers.h"
 #include "../../src/algorithm/PDBinpdb.h"
+#include "../../src/algorithm/PDBinpdbs.h"
 #include "../../src/algorithm/PDBoutpdb.h"
 #include "../../domains/n-pancake/npancake_t.h"
 
@@ -0,0 +1,78 @@
+// -*- coding: utf-8 -*-
+// TSTinshardsfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 20:31:08.915203477 (1792355468)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing PDBs stored in shards
+//
+
+#ifndef _TSTINSHARDSFIXTURE_H_
+#define _TSTINSHARDSFIXTURE_H_
+
+#include<algorithm>
+#include<filesystem>
+#include<random>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBinshards.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing PDBs stored in shards
+class InShardsFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+
+    // return a random path in the temporary directory which does not exist
+    std::filesystem::path generate_random_path () {
+
+        std::filesystem::path path;
+        do {
+            auto now = std::chrono::system_clock::now().time_since_epoch().count();
+            path = std::filesystem::temp_directory_path() / (std::to_string(now) + ".pdb");
+        } while (std::filesystem::exists(path));
+        return path;
+    }
+
+    // remove the index found at the given path and all its shards
+    void remove_shards (const std::filesystem::path& path, const pdb::pdboff_t nbshards) {
+
+        std::error_code ec;
+        std::filesystem::remove (path, ec);
+        for (pdb::pdboff_t shard = 0 ; shard < nbshards ; shard++) {
+            std::filesystem::remove (pdb::index_t::shard_path (path, shard), ec);
+        }
+    }
+
+    // return a random permutation of the given goal
+    std::vector<int> random_perm (const std::vector<int>& goal) {
+
+        static thread_local std::mt19937 rng (rand ());
+        std::vector<int> perm (goal);
+        std::shuffle (perm.begin (), perm.end (), rng);
+        return perm;
+    }
+};
+
+#endif // _TSTINSHARDSFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -14,7 +14,13 @@
 #define _TSTOUTPDBFIXTURE_H_
 
 #include<filesystem>
+#include<functional>
+#include<limits>
+#include<memory>
+#include<queue>
 #include<stdexcept>
+#include<tuple>
+#include<vector>
 
 #include "gtest/gtest.h"
 
@@ -56,6 +62,55 @@ protected:
 
         return cost;
     }
+
+    // return the values of the additive PDB of the N-Pancake with the given
+    // goal and patterns, incremented in one unit as in outpdbs. They are
+    // computed with Dijkstra's algorithm in the abstract state space induced
+    // by the cpattern, where the reversals whose disc below the spatula is
+    // not preserved by the ppattern are free
+    std::vector<pdb::pdbval_t> additive_npancake (const std::vector<int>& goal,
+                                                  const std::string& cpattern, const std::string& ppattern) {
+
+        pdb::pdboff_t cspace = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (cpattern);
+        pdb::pdboff_t pspace = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ppattern);
+        pdb::pdb_t<pdb::node_t<npancake_t>> cpdb (pdb::pdboff_t (0));
+        cpdb.init (goal, cpattern);
+        pdb::pdb_t<pdb::node_t<npancake_t>> ppdb (pdb::pdboff_t (0));
+        ppdb.init (goal, ppattern);
+
+        std::vector<size_t> distance (cspace, std::numeric_limits<size_t>::max ());
+        std::priority_queue<std::tuple<size_t, pdb::pdboff_t>,
+                            std::vector<std::tuple<size_t, pdb::pdboff_t>>,
+                            std::greater<std::tuple<size_t, pdb::pdboff_t>>> open;
+        pdb::pdboff_t source = cpdb.rank (cpdb.mask (goal));
+        distance[source] = 0;
+        open.push ({0, source});
+        std::vector<pdb::pdbval_t> values (pspace, pdb::pdbval_t (std::numeric_limits<pdb::pdbval_t>::max ()));
+        while (!open.empty ()) {
+            auto [g, rank] = open.top ();
+            open.pop ();
+            if (g > distance[rank]) {
+                continue;
+            }
+
+            // annotate the value of this state in the PDB
+            auto perm = cpdb.unrank (rank);
+            auto prank = ppdb.rank (ppdb.mask (perm));
+            values[prank] = std::min (values[prank], pdb::pdbval_t (g + 1));
+
+            std::vector<std::tuple<pdb::pdbval_t, npancake_t>> successors;
+            npancake_t (perm).children (successors);
+            for (const auto& [cost, child] : successors) {
+                size_t charged = ppdb.preserves (child.get_owner ()) ? cost : 0;
+                auto crank = cpdb.rank (child.get_perm ());
+                if (g + charged < distance[crank]) {
+                    distance[crank] = g + charged;
+                    open.push ({g + charged, crank});
+                }
+            }
+        }
+        return values;
+    }
 };
 
 #endif // _TSTOUTPDBFIXTURE_H_
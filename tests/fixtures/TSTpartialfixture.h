@@ -0,0 +1,47 @@
+// -*- coding: utf-8 -*-
+// TSTpartialfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 19-10-2026 00:58:12.284716093 (1792371492)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Fixture for testing partial PDBs
+//
+
+#ifndef _TSTPARTIALFIXTURE_H_
+#define _TSTPARTIALFIXTURE_H_
+
+#include<algorithm>
+#include<random>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/algorithm/PDBpartial.h"
+#include "../../src/algorithm/PDBoutpdb.h"
+#include "../../domains/n-pancake/npancake_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing partial PDBs
+class PartialFixture : public ::testing::Test {
+
+protected:
+
+    void SetUp () override {
+
+        // just initialize the random seed to make sure that every iteration is
+        // performed over different random data
+        srand (time (nullptr));
+    }
+};
+
+#endif // _TSTPARTIALFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -18,6 +18,7 @@
 #include<cstdlib>
 #include<ctime>
 #include<random>
+#include<thread>
 #include<tuple>
 #include<vector>
 
@@ -0,0 +1,70 @@
+// -*- coding: utf-8 -*-
+// TSTregionfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 16:47:19.238815470 (1792342039)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing region_t
+//
+
+#ifndef _TSTREGIONFIXTURE_H_
+#define _TSTREGIONFIXTURE_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/PDBregion_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing regions
+class RegionFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a unique path in the temporary directory
+        std::filesystem::path unique_path () {
+
+            std::filesystem::path path;
+            do {
+                auto now = std::chrono::system_clock::now().time_since_epoch().count();
+                path = std::filesystem::temp_directory_path() / (std::to_string(now) + ".region");
+            } while (std::filesystem::exists(path));
+            return path;
+        }
+
+        // write the given bytes to a new file and return its path
+        std::filesystem::path write_bytes (const std::vector<uint8_t>& bytes) {
+
+            auto path = unique_path ();
+            std::ofstream out (path, std::ios::binary);
+            out.write (reinterpret_cast<const char*> (bytes.data ()), bytes.size ());
+            return path;
+        }
+};
+
+#endif // _TSTREGIONFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,59 @@
+// -*- coding: utf-8 -*-
+// TSTringfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 13:58:21.447021913 (1792331901)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing ring_t
+//
+
+#ifndef _TSTRINGFIXTURE_H_
+#define _TSTRINGFIXTURE_H_
+
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/PDBring_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing ring buffers
+class RingFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a vector with nbitems nodes of random instances of the
+        // 5-Pancake with a random g-value in the range [lower, upper]
+        std::vector<pdb::node_t<npancake_t>> randItems (const int nbitems, const int lower, const int upper) {
+
+            std::vector<pdb::node_t<npancake_t>> values;
+            for (auto j = 0 ; j < nbitems ; j++) {
+                values.push_back (pdb::node_t<npancake_t> (randInstance (5),
+                                                           pdb::pdbval_t (lower + rand () % (1 + upper - lower))));
+            }
+
+            return values;
+        }
+};
+
+#endif // _TSTRINGFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,134 @@
+// -*- coding: utf-8 -*-
+// TSTarena_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 15:33:52.004417936 (1792337632)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing arenas and buckets
+//
+
+#include "../fixtures/TSTarenafixture.h"
+
+using namespace std;
+
+// Checks that chunks released to an arena are reused
+// ----------------------------------------------------------------------------
+TEST_F (ArenaFixture, Reuse) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create an arena with a random chunk size
+        auto chunk_size = 1 + rand () % 100;
+        pdb::arena_t<string> arena (chunk_size);
+        ASSERT_EQ (arena.get_chunk_size (), chunk_size);
+        ASSERT_EQ (arena.get_live_bytes (), 0);
+        ASSERT_EQ (arena.get_reserved_bytes (), 0);
+
+        // request a random number of chunks
+        auto nbchunks = 1 + rand () % MAX_VALUES;
+        vector<string*> chunks;
+        for (auto j = 0 ; j < nbchunks ; j++) {
+            chunks.push_back (arena.allocate ());
+        }
+        ASSERT_EQ (arena.get_nbchunks (), nbchunks);
+        ASSERT_EQ (arena.get_live_bytes (), nbchunks * chunk_size * sizeof (string));
+        ASSERT_EQ (arena.get_reserved_bytes (), arena.get_live_bytes ());
+
+        // release all of them and verify they are all served again without
+        // requesting new ones
+        for (auto chunk : chunks) {
+            arena.release (chunk);
+        }
+        ASSERT_EQ (arena.get_live_bytes (), 0);
+        ASSERT_EQ (arena.get_reserved_bytes (), nbchunks * chunk_size * sizeof (string));
+        for (auto j = 0 ; j < nbchunks ; j++) {
+            ASSERT_NE (find (chunks.begin (), chunks.end (), arena.allocate ()), chunks.end ());
+        }
+        ASSERT_EQ (arena.get_nbchunks (), nbchunks);
+
+        // finally, release half of them and return them to the system
+        for (auto j = 0 ; j < nbchunks/2 ; j++) {
+            arena.release (chunks[j]);
+        }
+        arena.shrink ();
+        ASSERT_EQ (arena.get_nbchunks (), nbchunks - nbchunks/2);
+        ASSERT_EQ (arena.get_reserved_bytes (), arena.get_live_bytes ());
+    }
+}
+
+// Checks that buckets store and retrieve items in the same order than vectors
+// ----------------------------------------------------------------------------
+TEST_F (ArenaFixture, BucketPushPop) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        pdb::arena_t<string> arena (1 + rand () % 10);
+        pdb::bucket_t<string> bucket (arena);
+        vector<string> values;
+
+        // randomly push and pop items and verify the bucket behaves as a
+        // vector
+        for (auto j = 0 ; j < MAX_VALUES ; j++) {
+            if (values.size () && !(rand () % 3)) {
+                ASSERT_EQ (bucket.back (), values.back ());
+                bucket.pop_back ();
+                values.pop_back ();
+            } else {
+                string item = randString (MIN_NB_CHARS, MAX_NB_CHARS);
+                bucket.push_back (item);
+                values.push_back (item);
+            }
+            ASSERT_EQ (bucket.size (), values.size ());
+            for (auto k = 0 ; k < values.size () ; k++) {
+                ASSERT_EQ (bucket[k], values[k]);
+            }
+
+            // only the chunks necessary to store all items are in use
+            auto nbchunks = (values.size () + arena.get_chunk_size () - 1) / arena.get_chunk_size ();
+            ASSERT_EQ (arena.get_live_bytes (), nbchunks * arena.get_chunk_size () * sizeof (string));
+        }
+
+        // once the bucket is cleared, all chunks are available for reuse
+        bucket.clear ();
+        ASSERT_TRUE (bucket.empty ());
+        ASSERT_EQ (arena.get_live_bytes (), 0);
+    }
+}
+
+// Checks that chunks released by a bucket are reused by other buckets sharing
+// the same arena
+// ----------------------------------------------------------------------------
+TEST_F (ArenaFixture, BucketRecycling) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        pdb::arena_t<string> arena (1 + rand () % 10);
+
+        // fill in a bucket, and then drain it while filling another one
+        pdb::bucket_t<string> first (arena), second (arena);
+        for (auto j = 0 ; j < MAX_VALUES ; j++) {
+            first.push_back (randString (MIN_NB_CHARS, MAX_NB_CHARS));
+        }
+        auto reserved = arena.get_reserved_bytes ();
+        while (!first.empty ()) {
+            second.push_back (first.back ());
+            first.pop_back ();
+        }
+
+        // the second bucket required, at most, one additional chunk
+        ASSERT_LE (arena.get_reserved_bytes (), reserved + arena.get_chunk_size () * sizeof (string));
+
+        // buckets can be moved without copying their contents
+        pdb::bucket_t<string> third (std::move (second));
+        ASSERT_EQ (third.size (), MAX_VALUES);
+        ASSERT_EQ (second.size (), 0);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,121 @@
+// -*- coding: utf-8 -*-
+// TSTgraph_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 11:05:12.640018275 (1792321512)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing abstract state graphs
+//
+
+#include "../fixtures/TSTgraphfixture.h"
+
+using namespace std;
+
+// check that graphs are properly created
+// ----------------------------------------------------------------------------
+TEST_F (GraphFixture, Empty) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create an empty graph and verify it has no nodes and edges
+        pdb::graph_t graph;
+        ASSERT_EQ (graph.nbnodes (), 0);
+        ASSERT_EQ (graph.nbedges (), 0);
+
+        // and also that every class is mapped to itself
+        for (auto j = 0 ; j <= std::numeric_limits<pdb::pdbval_t>::max () ; j++) {
+            ASSERT_EQ (graph.get_cost (pdb::pdbval_t (j)), j);
+        }
+    }
+}
+
+// check that the graph of the N-Pancake contains all abstract states and
+// all their edges
+// ----------------------------------------------------------------------------
+TEST_F (GraphFixture, NPancakeSize) {
+
+    // Set the heavy-cost variant with a default cost equal to zero so that
+    // classes are the discs below the spatula
+    npancake_t::init (npancake_variant::heavy_cost, 0);
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    // test all possible patterns with at least 1 symbol and up to length-1
+    // symbols being preserved
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate the graph of this pattern
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb::graph_t graph;
+            pdb.generate_graph (graph);
+
+            // every abstract state has length-1 successors
+            auto space = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern);
+            ASSERT_EQ (graph.nbnodes (), space);
+            ASSERT_EQ (graph.nbedges (), space*(length-1));
+            for (auto node = 0 ; node < graph.nbnodes () ; node++) {
+                ASSERT_EQ (graph.get_offsets ()[1+node] - graph.get_offsets ()[node], length-1);
+            }
+
+            // and all classes are either zero, a disc or the table
+            for (auto cclass : graph.get_classes ()) {
+                ASSERT_LE (cclass, 1+length);
+            }
+        }
+    }
+}
+
+// check that graphs can be written and read back
+// ----------------------------------------------------------------------------
+TEST_F (GraphFixture, NPancakeReadWrite) {
+
+    npancake_t::init (npancake_variant::heavy_cost, 0);
+
+    // Use pancakes of length 7
+    auto length = 7;
+    auto goal = succListInt (length);
+
+    for (auto nbsymbols = 1 ; nbsymbols <= length-1 ; nbsymbols++) {
+        for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+            // generate the graph of this pattern and write it to a file
+            pdb::outpdb<pdb::node_t<npancake_t>> pdb (pdb::pdb_mode::max, goal, ipattern, ipattern);
+            pdb::graph_t graph;
+            pdb.generate_graph (graph);
+            auto temp_file = unique_path (ipattern + ".csr");
+            ASSERT_TRUE (graph.write (temp_file));
+
+            // read it back and verify the contents are strictly the same
+            pdb::graph_t other;
+            ASSERT_TRUE (other.read (temp_file));
+            ASSERT_EQ (other.get_goal (), graph.get_goal ());
+            ASSERT_EQ (other.get_cpattern (), graph.get_cpattern ());
+            ASSERT_EQ (other.get_ppattern (), graph.get_ppattern ());
+            ASSERT_EQ (other.get_source (), graph.get_source ());
+            ASSERT_EQ (other.get_offsets (), graph.get_offsets ());
+            ASSERT_EQ (other.get_targets (), graph.get_targets ());
+            ASSERT_EQ (other.get_classes (), graph.get_classes ());
+            ASSERT_EQ (other.get_pranks (), graph.get_pranks ());
+
+            // the N-Pancake supports additive PDBs, and thus every edge
+            // records whether it is charged in them
+            ASSERT_EQ (graph.get_charged ().size (), graph.nbedges ());
+            ASSERT_EQ (other.get_charged (), graph.get_charged ());
+
+            // finally, remove the file
+            error_code ec;
+            ASSERT_TRUE (std::filesystem::remove(temp_file, ec));
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
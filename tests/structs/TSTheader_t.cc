@@ -0,0 +1,118 @@
+// -*- coding: utf-8 -*-
+// TSTheader_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 19:05:12.083417660 (1792350312)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing headers
+//
+
+#include "../fixtures/TSTheaderfixture.h"
+
+using namespace std;
+
+// Checks that headers are correctly serialized and deserialized
+// ----------------------------------------------------------------------------
+TEST_F (HeaderFixture, Serialize) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create random values and summarize them in a header with a random
+        // block size. Values are stored with a random encoding, and the last
+        // byte might not be full, in which case its unused bits are zeroed
+        auto encoding = pdb::pdb_encoding (rand () % 5);
+        pdb::pdboff_t nbvalues = 1 + rand () % (1<<16);
+        vector<uint8_t> values (pdb::encoding_bytes (encoding, nbvalues));
+        for (auto& value : values) {
+            value = uint8_t (rand ());
+        }
+        if ((nbvalues * pdb::encoding_bits (encoding)) % 8) {
+            values.back () &= uint8_t ((1 << ((nbvalues * pdb::encoding_bits (encoding)) % 8)) - 1);
+        }
+        int n = 1 + rand () % 20;
+        vector<int> goal (n);
+        for (auto j = 0 ; j < n ; j++) {
+            goal[j] = j;
+        }
+
+        // and they might be also compressed
+        auto compression = pdb::pdb_compression (rand () % 2);
+        pdb::header_t header (pdb::pdb_mode::max, goal, random_pattern (n), random_pattern (n),
+                              nbvalues, 1 + rand () % (1<<12), encoding, compression);
+        header.summarize (values);
+
+        // the histogram counts every value once decoded
+        pdb::pdboff_t total = 0;
+        for (auto count : header.get_histogram ()) {
+            total += count;
+        }
+        ASSERT_EQ (total, nbvalues);
+
+        // and all values equal to or larger than 255 are counted in the
+        // last entry
+        pdb::pdboff_t nbwide = 0;
+        for (pdb::pdboff_t j = 0 ; j < nbvalues ; j++) {
+            nbwide += (pdb::encoding_get (values.data (), j, encoding) >= 255);
+        }
+        ASSERT_EQ (header.get_histogram ().back (), nbwide);
+
+        // and verify the header read is the same written
+        auto stream = to_stream (header);
+        pdb::header_t other;
+        pdb::in_error_message error;
+        ASSERT_TRUE (other.deserialize (stream, header.get_offset () + header.get_index_bytes () + values.size (), error));
+        ASSERT_EQ (other.get_mode (), header.get_mode ());
+        ASSERT_EQ (other.get_encoding (), encoding);
+        ASSERT_EQ (other.get_compression (), compression);
+        ASSERT_EQ (other.get_index_bytes (), header.get_index_bytes ());
+        ASSERT_EQ (other.get_goal (), header.get_goal ());
+        ASSERT_EQ (other.get_ppattern (), header.get_ppattern ());
+        ASSERT_EQ (other.get_cpattern (), header.get_cpattern ());
+        ASSERT_EQ (other.get_address_space (), header.get_address_space ());
+        ASSERT_EQ (other.get_offset (), header.get_offset ());
+        ASSERT_EQ (other.get_block_size (), header.get_block_size ());
+        ASSERT_EQ (other.get_histogram (), header.get_histogram ());
+        ASSERT_EQ (other.get_checksums (), header.get_checksums ());
+    }
+}
+
+// Checks that headers of PDBs with more than 2^32 entries are correctly
+// serialized and deserialized
+// ----------------------------------------------------------------------------
+TEST_F (HeaderFixture, LargeAddressSpace) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // no values are necessary to create the header, so that only the
+        // address space and the number of blocks are really large
+        pdb::pdboff_t pspace = (pdb::pdboff_t (1) << 32) + pdb::pdboff_t (rand ()) * (1 + rand () % 16);
+        vector<int> goal {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+        pdb::header_t header (pdb::pdb_mode::max, goal, random_pattern (16), random_pattern (16), pspace);
+        ASSERT_EQ (header.get_nbblocks (),
+                   (pspace + pdb::header_t::default_block_size - 1) / pdb::header_t::default_block_size);
+        ASSERT_EQ (header.get_offset () % pdb::header_t::page_size, 0);
+
+        // the header read must be the same written
+        auto stream = to_stream (header);
+        pdb::header_t other;
+        pdb::in_error_message error;
+        ASSERT_TRUE (other.deserialize (stream, header.get_offset () + pspace, error));
+        ASSERT_EQ (other.get_address_space (), pspace);
+        ASSERT_EQ (other.get_offset (), header.get_offset ());
+        ASSERT_EQ (other.get_nbblocks (), header.get_nbblocks ());
+        ASSERT_EQ (other.get_checksums ().size (), header.get_nbblocks ());
+
+        // and files with a different size must be rejected
+        auto truncated = to_stream (header);
+        ASSERT_FALSE (other.deserialize (truncated, header.get_offset () + pspace - 1, error));
+        ASSERT_EQ (error, pdb::in_error_message::pdb_incorrect_size);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -326,6 +326,45 @@ TEST_F (OpenFixture, NPancakeInsertRemove) {
     }
 }
 
+// Checks that the memory of open lists is recycled among buckets, so that it
+// does not exceed the memory required to store the nodes simultaneously in
+// the open list
+// ----------------------------------------------------------------------------
+TEST_F (OpenFixture, NPancakeRecycling) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create an open list with small chunks so that many of them are used
+        pdb::open_t<pdb::node_t<npancake_t>> open (1, 1 + rand () % 8);
+        ASSERT_EQ (open.get_live_bytes (), 0);
+        ASSERT_EQ (open.get_reserved_bytes (), 0);
+
+        // populate it and drain it in increasing order of their index,
+        // inserting after every extraction a new node in a greater bucket as in
+        // a uniform-cost search
+        populate (open, MAX_VALUES);
+        auto peak = open.get_live_bytes ();
+        for (auto j = 0 ; j < 10*MAX_VALUES && open.size () ; j++) {
+            auto item = open.pop_front ();
+            if (item.get_g () < 255) {
+                open.insert (pdb::node_t<npancake_t> (item.get_state (), item.get_g () + 1));
+            }
+            ASSERT_LE (open.get_live_bytes (), open.get_reserved_bytes ());
+            peak = max (peak, open.get_live_bytes ());
+        }
+
+        // because chunks released are reused, no more memory than the peak
+        // of live memory has ever been reserved
+        ASSERT_EQ (open.get_reserved_bytes (), peak);
+
+        // once drained, no chunk is in use
+        while (open.size ()) {
+            open.pop_front ();
+        }
+        ASSERT_EQ (open.get_live_bytes (), 0);
+    }
+}
+
 // Local Variables:
 // mode:cpp
 // fill-column:80
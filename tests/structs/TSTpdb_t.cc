@@ -232,6 +232,144 @@ TEST_F (PDBFixture, PartialPermutations) {
     }
 }
 
+// Check that unranking is the inverse of ranking for all partial permutations
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, Unrank) {
+
+    // Test all the patterns of the N-Pancake with 4<= N <= 8
+    for (auto length = 4 ; length <= 8 ; length++) {
+        for (auto nbsymbols = 1; nbsymbols <= length ; nbsymbols++) {
+            for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+                // use a random goal, so that symbols are not sorted
+                auto goal = succListInt (length);
+                shuffle (goal.begin (), goal.end (), mt19937 (rand ()));
+                pdb::pdboff_t space_size = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern);
+                pdb::pdb_t<pdb::node_t<npancake_t>> pdb (space_size);
+                pdb.init (goal, ipattern);
+
+                // every rank is mapped to a partial permutation which contains
+                // exactly the preserved symbols and is ranked back to it
+                for (pdb::pdboff_t index = 0 ; index < space_size ; index++) {
+                    auto perm = pdb.unrank (index);
+                    ASSERT_EQ (count_if (perm.begin (), perm.end (),
+                                         [] (int symbol) { return symbol != pdb::NONPAT; }),
+                               nbsymbols);
+                    ASSERT_EQ (pdb.mask (perm), perm);
+                    ASSERT_EQ (pdb.rank (perm), index);
+                }
+            }
+        }
+    }
+}
+
+// Check that ranking permutations from their inverse returns the same rank,
+// and that the inverse can be shared among PDBs with different patterns
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, RankInverse) {
+
+    // Test all the patterns of the N-Pancake with 4<= N <= 8
+    for (auto length = 4 ; length <= 8 ; length++) {
+
+        // use a random goal, so that symbols are not sorted
+        auto goal = succListInt (length);
+        shuffle (goal.begin (), goal.end (), mt19937 (rand ()));
+        for (auto nbsymbols = 1; nbsymbols <= length ; nbsymbols++) {
+            for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+                pdb::pdboff_t space_size = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern);
+                pdb::pdb_t<pdb::node_t<npancake_t>> pdb (space_size);
+                pdb.init (goal, ipattern);
+
+                // the full pattern is used to compute the inverse of random
+                // permutations
+                pdb::pdb_t<pdb::node_t<npancake_t>> full (pdb::pdboff_t (0));
+                full.init (goal, string (length, '-'));
+
+                vector<int> inverse;
+                for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+                    auto perm = succListInt (length);
+                    shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+                    full.invert (perm, inverse);
+                    for (auto j = 0 ; j < length ; j++) {
+                        ASSERT_EQ (inverse[perm[j]], j);
+                    }
+                    ASSERT_EQ (pdb.rank_inverse (inverse), pdb.rank (perm));
+
+                    // and also with the inverse of masked permutations
+                    auto masked = pdb.mask (perm);
+                    pdb.invert (masked, inverse);
+                    ASSERT_EQ (pdb.rank_inverse (inverse), pdb.rank (perm));
+                }
+
+                // permutations with a different length are rejected
+                ASSERT_THROW (pdb.invert (succListInt (length+1), inverse), std::invalid_argument);
+            }
+        }
+    }
+}
+
+// check that dual states are involutions which are computed along with the
+// inverse of permutations, and that they can be ranked from their locations
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, Dual) {
+
+    // Test all the patterns of the N-Pancake with 4<= N <= 8
+    for (auto length = 4 ; length <= 8 ; length++) {
+
+        // the dual of permutations wrt the identity is their inverse. Note
+        // that symbols start from 1
+        pdb::pdb_t<pdb::node_t<npancake_t>> identity (pdb::pdboff_t (0));
+        identity.init (succListInt (length), string (length, '-'));
+        for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+            auto perm = succListInt (length);
+            shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+            auto dual = identity.dual (perm);
+            for (auto j = 0 ; j < length ; j++) {
+                ASSERT_EQ (dual[perm[j]-1], j+1);
+            }
+        }
+
+        // use a random goal, so that symbols are not sorted
+        auto goal = succListInt (length);
+        shuffle (goal.begin (), goal.end (), mt19937 (rand ()));
+        for (auto nbsymbols = 1; nbsymbols <= length ; nbsymbols++) {
+            for (auto ipattern : generatePatterns (nbsymbols, length-nbsymbols)) {
+
+                pdb::pdboff_t space_size = pdb::pdb_t<pdb::node_t<npancake_t>>::address_space (ipattern);
+                pdb::pdb_t<pdb::node_t<npancake_t>> pdb (space_size);
+                pdb.init (goal, ipattern);
+
+                // the goal is its own dual
+                ASSERT_EQ (pdb.dual (goal), goal);
+
+                vector<int> inverse, dinverse, expected;
+                for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+                    auto perm = succListInt (length);
+                    shuffle (perm.begin (), perm.end (), mt19937 (rand ()));
+
+                    // the dual of the dual is the permutation itself
+                    auto dual = pdb.dual (perm);
+                    ASSERT_EQ (pdb.dual (dual), perm);
+
+                    // and the locations of both are computed simultaneously
+                    pdb.invert (perm, inverse, dinverse);
+                    pdb.invert (perm, expected);
+                    ASSERT_EQ (inverse, expected);
+                    pdb.invert (dual, expected);
+                    ASSERT_EQ (dinverse, expected);
+                    ASSERT_EQ (pdb.rank_inverse (dinverse), pdb.rank (dual));
+                }
+
+                // partial permutations have no dual
+                if (nbsymbols < length) {
+                    ASSERT_THROW (pdb.invert (pdb.mask (goal), inverse, dinverse), std::invalid_argument);
+                }
+            }
+        }
+    }
+}
+
 // check that instances of the N-Pancake can be inserted in PDBs
 // ----------------------------------------------------------------------------
 TEST_F (PDBFixture, NPancakeInsert) {
@@ -406,6 +544,217 @@ TEST_F (PDBFixture, NPancakeLookUpPartialPermutation) {
     }
 }
 
+// checks that values packed in nibbles are correctly written and read
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, NibbleInsert) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create a PDB with a random number of locations, which might be odd,
+        // with values packed in nibbles
+        pdb::pdboff_t capacity = 1 + rand () % MAX_VALUES;
+        pdb::pdb_t<pdb::node_t<npancake_t>> pdb (capacity, pdb::pdb_encoding::nibble);
+        ASSERT_EQ (pdb.get_encoding (), pdb::pdb_encoding::nibble);
+        ASSERT_EQ (pdb.capacity (), capacity);
+        ASSERT_EQ (pdb.get_address ().size (), (capacity + 1) / 2);
+
+        // write random values at random locations, and keep a copy of them
+        vector<pdb::pdbval_t> expected (capacity, pdb::pdbzero);
+        for (auto j = 0 ; j < MAX_VALUES ; j++) {
+            pdb::pdboff_t index = rand () % capacity;
+            expected[index] = pdb::pdbval_t (rand () % 16);
+            pdb.insert (index, expected[index]);
+        }
+
+        // and verify all locations store the expected value, so that no
+        // value overwrites its neighbour
+        for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+            ASSERT_EQ (pdb[index], expected[index]);
+            ASSERT_EQ (pdb.at (index), expected[index]);
+            ASSERT_EQ (pdb.load (index), expected[index]);
+        }
+
+        // values which do not fit in a nibble can not be written, and
+        // locations can not be referenced
+        EXPECT_THROW (pdb.insert (rand () % capacity, pdb::pdbval_t (16 + rand () % 240)), out_of_range);
+        EXPECT_THROW (pdb.update (rand () % capacity, pdb::pdbval_t (16 + rand () % 240)), out_of_range);
+        EXPECT_THROW (pdb.ref (0) = 0, runtime_error);
+    }
+}
+
+// checks that concurrent updates of values packed in nibbles are never lost
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, NibbleUpdate) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a PDB with values packed in nibbles, and update all its
+        // locations with random values from several threads, so that
+        // neighbour locations are updated simultaneously
+        pdb::pdboff_t capacity = 1 + rand () % (1 << 16);
+        pdb::pdb_t<pdb::node_t<npancake_t>> pdb (capacity, pdb::pdb_encoding::nibble);
+        int nbthreads = 2 + rand () % 3;
+        vector<vector<pdb::pdbval_t>> values (nbthreads, vector<pdb::pdbval_t> (capacity));
+        for (auto& ivalues : values) {
+            for (auto& value : ivalues) {
+                value = pdb::pdbval_t (1 + rand () % 15);
+            }
+        }
+        vector<thread> threads;
+        for (auto id = 0 ; id < nbthreads ; id++) {
+            threads.push_back (thread ([&pdb, &values, capacity, id] () {
+                for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+                    pdb.update (index, values[id][index]);
+                }
+            }));
+        }
+        for (auto& ithread : threads) {
+            ithread.join ();
+        }
+
+        // every location must keep the minimum value, and it is counted once
+        ASSERT_EQ (pdb.size (), capacity);
+        for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+            pdb::pdbval_t minimum = values[0][index];
+            for (auto id = 1 ; id < nbthreads ; id++) {
+                minimum = min (minimum, values[id][index]);
+            }
+            ASSERT_EQ (pdb.at (index), minimum);
+        }
+    }
+}
+
+
+// checks that values packed in tribbles and words are correctly written and
+// read
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, WideInsert) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create a PDB with a random number of locations, which might be odd,
+        // with values packed either in tribbles or words
+        pdb::pdb_encoding encoding = (rand () % 2) ? pdb::pdb_encoding::tribble : pdb::pdb_encoding::word;
+        pdb::pdboff_t capacity = 1 + rand () % MAX_VALUES;
+        pdb::pdb_t<pdb::node_t<npancake_t>> pdb (capacity, encoding);
+        ASSERT_EQ (pdb.get_encoding (), encoding);
+        ASSERT_EQ (pdb.capacity (), capacity);
+        ASSERT_EQ (pdb.get_address ().size (), pdb::encoding_bytes (encoding, capacity));
+
+        // write random values at random locations, and keep a copy of them
+        const pdb::pdboff_t range = pdb::encoding_max (encoding) + 1;
+        vector<pdb::pdbval_t> expected (capacity, pdb::pdbzero);
+        for (auto j = 0 ; j < MAX_VALUES ; j++) {
+            pdb::pdboff_t index = rand () % capacity;
+            expected[index] = pdb::pdbval_t (rand () % range);
+            pdb.insert (index, expected[index]);
+        }
+
+        // and verify all locations store the expected value, so that no
+        // value overwrites its neighbour
+        for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+            ASSERT_EQ (pdb[index], expected[index]);
+            ASSERT_EQ (pdb.at (index), expected[index]);
+            ASSERT_EQ (pdb.load (index), expected[index]);
+        }
+
+        // tribbles can not be updated concurrently, and values which do not
+        // fit in them can not be written. Locations can not be referenced
+        if (encoding == pdb::pdb_encoding::tribble) {
+            EXPECT_THROW (pdb.update (rand () % capacity, 1), runtime_error);
+            EXPECT_THROW (pdb.insert (rand () % capacity, pdb::pdbval_t (range + rand () % range)), out_of_range);
+        }
+        EXPECT_THROW (pdb.ref (0) = 0, runtime_error);
+    }
+}
+
+// checks that concurrent updates of values packed in words are never lost
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, WordUpdate) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a PDB with values packed in words, and update all its
+        // locations with random values from several threads
+        pdb::pdboff_t capacity = 1 + rand () % (1 << 16);
+        pdb::pdb_t<pdb::node_t<npancake_t>> pdb (capacity, pdb::pdb_encoding::word);
+        int nbthreads = 2 + rand () % 3;
+        vector<vector<pdb::pdbval_t>> values (nbthreads, vector<pdb::pdbval_t> (capacity));
+        for (auto& ivalues : values) {
+            for (auto& value : ivalues) {
+                value = pdb::pdbval_t (1 + rand () % std::numeric_limits<pdb::pdbval_t>::max ());
+            }
+        }
+        vector<thread> threads;
+        for (auto id = 0 ; id < nbthreads ; id++) {
+            threads.push_back (thread ([&pdb, &values, capacity, id] () {
+                for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+                    pdb.update (index, values[id][index]);
+                }
+            }));
+        }
+        for (auto& ithread : threads) {
+            ithread.join ();
+        }
+
+        // every location must keep the minimum value, and it is counted once
+        ASSERT_EQ (pdb.size (), capacity);
+        for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+            pdb::pdbval_t minimum = values[0][index];
+            for (auto id = 1 ; id < nbthreads ; id++) {
+                minimum = min (minimum, values[id][index]);
+            }
+            ASSERT_EQ (pdb.at (index), minimum);
+        }
+    }
+}
+
+
+// checks that replicated PDBs return the same values from every thread
+// ----------------------------------------------------------------------------
+TEST_F (PDBFixture, Replicate) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a PDB with a random encoding, pages and placement, and
+        // write random values at random locations
+        auto encoding = pdb::pdb_encoding (rand () % 5);
+        auto pages = pdb::pdb_pages (rand () % 4);
+        auto placement = (rand () % 2) ? pdb::pdb_placement::local : pdb::pdb_placement::interleave;
+        pdb::pdboff_t capacity = 1 + rand () % MAX_VALUES;
+        pdb::pdb_t<pdb::node_t<npancake_t>> pdb (capacity, encoding, pages, placement);
+        vector<pdb::pdbval_t> expected (capacity, pdb::pdbzero);
+        for (auto j = 0 ; j < MAX_VALUES ; j++) {
+            pdb::pdboff_t index = rand () % capacity;
+            expected[index] = pdb::pdbval_t (rand () % (1 + pdb::encoding_max (encoding)));
+            pdb.insert (index, expected[index]);
+        }
+        ASSERT_EQ (pdb.get_nbreplicas (), 0);
+
+        // replicate it in a random number of nodes, which might not exist
+        int nbnodes = 1 + rand () % 3;
+        pdb.replicate (nbnodes);
+        ASSERT_EQ (pdb.get_nbreplicas (), size_t (nbnodes));
+
+        // and verify all threads look up the same values
+        vector<thread> threads;
+        atomic<bool> ok = true;
+        for (auto id = 0 ; id < 2 ; id++) {
+            threads.push_back (thread ([&pdb, &expected, &ok, capacity] () {
+                for (pdb::pdboff_t index = 0 ; index < capacity ; index++) {
+                    if (pdb[index] != expected[index] || pdb.at (index) != expected[index]) {
+                        ok = false;
+                    }
+                }
+            }));
+        }
+        for (auto& ithread : threads) {
+            ithread.join ();
+        }
+        ASSERT_TRUE (ok);
+    }
+}
+
 
 // Local Variables:
 // mode:cpp
@@ -0,0 +1,113 @@
+// -*- coding: utf-8 -*-
+// TSTradix_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 14:06:55.581200347 (1792332415)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing radix heaps
+//
+
+#include "../fixtures/TSTradixfixture.h"
+
+using namespace std;
+
+// Checks the creation of empty radix heaps is initialized correctly
+// ----------------------------------------------------------------------------
+TEST_F (RadixFixture, NPancakeEmpty) {
+
+    // create a radix heap to store npancakes
+    pdb::radix_t<pdb::node_t<npancake_t>> radix;
+
+    // now, verify the heap is properly initialized
+    ASSERT_EQ (radix.get_mini (), 0);
+    ASSERT_EQ (radix.get_nbbuckets (), 1 + numeric_limits<pdb::pdbval_t>::digits);
+    ASSERT_EQ (radix.size (), 0);
+    EXPECT_THROW (radix.pop_front (), domain_error);
+}
+
+// Checks that instances of the 5-Pancake are properly sorted in a radix heap in
+// increasing order
+// ----------------------------------------------------------------------------
+TEST_F (RadixFixture, NPancakeInsert) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a radix heap and populate it with random g-values
+        pdb::radix_t<pdb::node_t<npancake_t>> radix;
+        auto values = randItems (MAX_VALUES, 0, MAX_NB_BUCKETS);
+        for (auto v : values) {
+            radix.insert (v);
+        }
+
+        // verify the minimum index
+        auto comp = [] (const pdb::node_t<npancake_t>& n1, const pdb::node_t<npancake_t>& n2) {
+            return n1.get_g () < n2.get_g ();
+        };
+        ASSERT_EQ (radix.get_mini (), (*min_element (values.begin (), values.end (), comp)).get_g ());
+
+        // extract all nodes from the heap and verify they come in increasing
+        // order of their g-value
+        int current = 0;
+        for (auto idx = 1 ; radix.size () ; idx++) {
+            ASSERT_EQ (radix.front ().get_g (), radix.get_mini ());
+            pdb::node_t<npancake_t> item = radix.pop_front ();
+            ASSERT_GE (item.get_g (), current);
+            ASSERT_EQ (radix.size (), values.size () - idx);
+            current = item.get_g ();
+        }
+    }
+}
+
+// Checks that radix heaps behave as monotone open lists when nodes are inserted
+// with g-values not less than the last one extracted, as in Dijkstra's
+// algorithm
+// ----------------------------------------------------------------------------
+TEST_F (RadixFixture, NPancakeMonotone) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a radix heap, and keep a histogram of all g-values inserted
+        auto maxcost = 1 + rand () % MAX_NB_BUCKETS;
+        pdb::radix_t<pdb::node_t<npancake_t>> radix;
+        vector<int> histogram (1 + MAX_NB_BUCKETS);
+        radix.insert (pdb::node_t<npancake_t> (randInstance (5), 0));
+        histogram[0]++;
+
+        // extract nodes and insert a random number of successors with a
+        // g-value which does not exceed the maximum cost
+        int current = 0;
+        int nbitems = 1;
+        while (radix.size ()) {
+            pdb::node_t<npancake_t> item = radix.pop_front ();
+            ASSERT_GE (item.get_g (), current);
+            histogram[item.get_g ()]--;
+            current = item.get_g ();
+
+            if (nbitems < 10*MAX_VALUES) {
+                for (auto child : randItems (rand () % 4, current, min (MAX_NB_BUCKETS, current + maxcost))) {
+                    radix.insert (child);
+                    histogram[child.get_g ()]++;
+                    nbitems++;
+                }
+            }
+        }
+
+        // verify all nodes were extracted
+        for (auto j = 0 ; j < histogram.size () ; j++) {
+            ASSERT_EQ (histogram[j], 0);
+        }
+
+        // and that inserting below the last g-value extracted is forbidden
+        if (current > 0) {
+            EXPECT_THROW (radix.insert (pdb::node_t<npancake_t> (randInstance (5), current - 1)), domain_error);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
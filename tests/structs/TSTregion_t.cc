@@ -0,0 +1,203 @@
+// -*- coding: utf-8 -*-
+// TSTregion_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 16:52:40.779013226 (1792342360)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing regions
+//
+
+#include "../fixtures/TSTregionfixture.h"
+
+using namespace std;
+
+// Checks that anonymous regions are zero-initialized and writable
+// ----------------------------------------------------------------------------
+TEST_F (RegionFixture, Allocate) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        pdb::region_t region;
+        ASSERT_EQ (region.size (), 0);
+        ASSERT_EQ (region.data (), nullptr);
+
+        // allocate a region with a random length, and verify all its
+        // contents are null
+        size_t length = 1 + rand () % (1<<16);
+        region.allocate (length);
+        ASSERT_EQ (region.size (), length);
+        ASSERT_FALSE (region.readonly ());
+        for (size_t j = 0 ; j < length ; j++) {
+            ASSERT_EQ (region.data ()[j], 0);
+        }
+
+        // write a random position and move the region to another one
+        auto loc = rand () % length;
+        region.data ()[loc] = 0xaa;
+        pdb::region_t other (std::move (region));
+        ASSERT_EQ (region.size (), 0);
+        ASSERT_EQ (other.size (), length);
+        ASSERT_EQ (other.data ()[loc], 0xaa);
+    }
+}
+
+// Checks that files are correctly mapped in read-only regions
+// ----------------------------------------------------------------------------
+TEST_F (RegionFixture, Map) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // write a file with random contents
+        vector<uint8_t> bytes (1 + rand () % (1<<16));
+        for (auto& byte : bytes) {
+            byte = uint8_t (rand ());
+        }
+        auto path = write_bytes (bytes);
+
+        // map a random range of it and verify its contents
+        size_t offset = rand () % bytes.size ();
+        size_t length = rand () % (1 + bytes.size () - offset);
+        pdb::region_t region;
+        ASSERT_TRUE (region.map (path, offset, length, pdb::pdb_advice::random, rand () % 2));
+        ASSERT_TRUE (region.readonly ());
+        ASSERT_EQ (region.size (), length);
+        for (size_t j = 0 ; j < length ; j++) {
+            ASSERT_EQ (region.data ()[j], bytes[offset + j]);
+        }
+        ASSERT_TRUE (region.advise (pdb::pdb_advice::sequential));
+
+        // ranges beyond the end of the file can not be mapped
+        pdb::region_t beyond;
+        ASSERT_FALSE (beyond.map (path, offset, 1 + bytes.size () - offset));
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove (path, ec));
+    }
+}
+
+// Checks that regions created over files write their contents to them
+// ----------------------------------------------------------------------------
+TEST_F (RegionFixture, Create) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a file with room for a random number of bytes after a
+        // random number of pages
+        size_t offset = (rand () % 4) * size_t (sysconf (_SC_PAGESIZE));
+        size_t length = 1 + rand () % (1<<16);
+        auto path = unique_path ();
+        pdb::region_t region;
+        ASSERT_TRUE (region.create (path, offset, length));
+        ASSERT_FALSE (region.readonly ());
+        ASSERT_EQ (region.size (), length);
+        ASSERT_EQ (std::filesystem::file_size (path), offset + length);
+
+        // write random contents and flush them to the file
+        vector<uint8_t> bytes (length);
+        for (size_t j = 0 ; j < length ; j++) {
+            ASSERT_EQ (region.data ()[j], 0);
+            bytes[j] = region.data ()[j] = uint8_t (rand ());
+        }
+        ASSERT_TRUE (region.sync ());
+
+        // and verify they are found in the file right after offset
+        pdb::region_t view;
+        ASSERT_TRUE (view.map (path, offset, length));
+        for (size_t j = 0 ; j < length ; j++) {
+            ASSERT_EQ (view.data ()[j], bytes[j]);
+        }
+
+        // offsets must be aligned to the page size
+        pdb::region_t unaligned;
+        ASSERT_FALSE (unaligned.create (unique_path (), 1, length));
+
+        error_code ec;
+        ASSERT_TRUE (std::filesystem::remove (path, ec));
+    }
+}
+
+// Checks that anonymous regions backed with huge pages are zero-initialized
+// and writable, and that they fall back to smaller pages when necessary
+// ----------------------------------------------------------------------------
+TEST_F (RegionFixture, HugePages) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        for (auto pages : {pdb::pdb_pages::normal, pdb::pdb_pages::transparent,
+                           pdb::pdb_pages::huge_2m, pdb::pdb_pages::huge_1g}) {
+
+            // allocate a region with a random length and the given pages
+            pdb::region_t region;
+            size_t length = 1 + rand () % (1<<22);
+            region.allocate (length, rand () % 2, pages);
+            ASSERT_EQ (region.size (), length);
+            ASSERT_FALSE (region.readonly ());
+
+            // explicit huge pages fall back to transparent huge pages, and
+            // these to normal pages, and the region is aligned to the size
+            // of the pages actually used
+            if (pages == pdb::pdb_pages::normal) {
+                ASSERT_EQ (region.pages (), pdb::pdb_pages::normal);
+            } else if (pages == pdb::pdb_pages::transparent) {
+                ASSERT_NE (region.pages (), pdb::pdb_pages::huge_2m);
+                ASSERT_NE (region.pages (), pdb::pdb_pages::huge_1g);
+            } else {
+                ASSERT_TRUE (region.pages () == pages || region.pages () == pdb::pdb_pages::transparent ||
+                             region.pages () == pdb::pdb_pages::normal);
+            }
+            ASSERT_EQ (reinterpret_cast<uintptr_t> (region.data ()) % pdb::region_t::page_size (region.pages ()), 0);
+
+            // verify all its contents are null and write them
+            for (size_t j = 0 ; j < length ; j += 1 + rand () % 4096) {
+                ASSERT_EQ (region.data ()[j], 0);
+                region.data ()[j] = uint8_t (j);
+            }
+            region.data ()[length - 1] = 0xaa;
+            ASSERT_EQ (region.data ()[length - 1], 0xaa);
+        }
+    }
+}
+
+// Checks that placing the pages of anonymous regions in NUMA nodes preserves
+// their contents
+// ----------------------------------------------------------------------------
+TEST_F (RegionFixture, Placement) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // allocate a region with random contents
+        pdb::region_t region;
+        vector<uint8_t> bytes (1 + rand () % (1<<16));
+        region.allocate (bytes.size ());
+        for (size_t j = 0 ; j < bytes.size () ; j++) {
+            bytes[j] = region.data ()[j] = uint8_t (rand ());
+        }
+
+        // interleave its pages and then bind them to a random node. Either
+        // operation might fail if the kernel has no NUMA support, but the
+        // contents must be preserved anyway
+        region.interleave ();
+        region.bind (rand () % pdb::numa_nodes ());
+        for (size_t j = 0 ; j < bytes.size () ; j++) {
+            ASSERT_EQ (region.data ()[j], bytes[j]);
+        }
+
+        // pages can not be bound to nodes which do not exist
+        ASSERT_FALSE (region.bind (pdb::numa_nodes ()));
+        ASSERT_GE (pdb::numa_node (), 0);
+        ASSERT_LT (pdb::numa_node (), pdb::numa_nodes ());
+
+        // empty regions are trivially placed
+        pdb::region_t empty;
+        ASSERT_TRUE (empty.interleave ());
+        ASSERT_TRUE (empty.bind (0));
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,152 @@
+// -*- coding: utf-8 -*-
+// TSTring_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 14:03:12.318764021 (1792332192)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing ring buffers
+//
+
+#include "../fixtures/TSTringfixture.h"
+
+using namespace std;
+
+// Checks the creation of empty ring buffers is initialized correctly
+// ----------------------------------------------------------------------------
+TEST_F (RingFixture, NPancakeEmpty) {
+
+    // create a ring buffer to store npancakes
+    pdb::ring_t<pdb::node_t<npancake_t>> ring;
+
+    // now, verify the ring is properly initialized
+    ASSERT_EQ (ring.get_mini (), 0);
+    ASSERT_EQ (ring.get_maxi (), 0);
+    ASSERT_EQ (ring.get_nbbuckets (), 1);
+    ASSERT_EQ (ring.size (), 0);
+    EXPECT_THROW (ring.pop_front (), domain_error);
+}
+
+// Checks that ring buffers are created with a number of buckets equal to the
+// next power of two of the capacity requested, and that they do not grow as
+// long as the g-values stored fit in the window
+// ----------------------------------------------------------------------------
+TEST_F (RingFixture, NPancakeCapacity) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a ring buffer with a random capacity in the range [1, 32]
+        auto capacity = 1 + rand () % 32;
+        pdb::ring_t<pdb::node_t<npancake_t>> ring (capacity);
+
+        // compute the minimum power of two which is greater or equal than the
+        // capacity
+        size_t pow2 = 1;
+        while (pow2 < capacity) {
+            pow2 *= 2;
+        }
+        ASSERT_EQ (ring.get_nbbuckets (), pow2);
+
+        // insert items with g-values in a window of size pow2 and verify the
+        // number of buckets does not change
+        auto lower = rand () % (MAX_NB_BUCKETS - 2*pow2);
+        for (auto item : randItems (MAX_VALUES, lower, lower + pow2 - 1)) {
+            ring.insert (item);
+        }
+        ASSERT_EQ (ring.get_nbbuckets (), pow2);
+
+        // and that inserting beyond it makes the ring grow
+        ring.insert (pdb::node_t<npancake_t> (randInstance (5), pdb::pdbval_t (ring.get_mini () + pow2)));
+        ASSERT_GE (ring.get_nbbuckets (), 2*pow2);
+    }
+}
+
+// Checks that instances of the 5-Pancake are properly sorted in a ring buffer
+// in increasing order
+// ----------------------------------------------------------------------------
+TEST_F (RingFixture, NPancakeInsert) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a ring buffer and populate it with random g-values
+        pdb::ring_t<pdb::node_t<npancake_t>> ring;
+        auto values = randItems (MAX_VALUES, 0, MAX_NB_BUCKETS);
+        for (auto v : values) {
+            ring.insert (v);
+        }
+
+        // verify the minimum and maximum indices
+        auto comp = [] (const pdb::node_t<npancake_t>& n1, const pdb::node_t<npancake_t>& n2) {
+            return n1.get_g () < n2.get_g ();
+        };
+        ASSERT_EQ (ring.get_mini (), (*min_element (values.begin (), values.end (), comp)).get_g ());
+        ASSERT_EQ (ring.get_maxi (), (*max_element (values.begin (), values.end (), comp)).get_g ());
+
+        // extract all nodes from the ring and verify they come in increasing
+        // order of their g-value
+        int current = 0;
+        for (auto idx = 1 ; ring.size () ; idx++) {
+            pdb::node_t<npancake_t> item = ring.pop_front ();
+            ASSERT_GE (item.get_g (), current);
+            ASSERT_EQ (ring.size (), values.size () - idx);
+            current = item.get_g ();
+        }
+    }
+}
+
+// Checks that ring buffers behave as monotone open lists when nodes are
+// inserted with g-values not less than the last one extracted, as in Dijkstra's
+// algorithm
+// ----------------------------------------------------------------------------
+TEST_F (RingFixture, NPancakeMonotone) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a ring buffer sized with a random maximum cost, and keep a
+        // histogram of all g-values inserted
+        auto maxcost = 1 + rand () % 16;
+        pdb::ring_t<pdb::node_t<npancake_t>> ring (1 + maxcost);
+        vector<int> histogram (2*MAX_NB_BUCKETS);
+        ring.insert (pdb::node_t<npancake_t> (randInstance (5), 0));
+        histogram[0]++;
+
+        // extract nodes and insert a random number of successors with a
+        // g-value which does not exceed the maximum cost
+        int current = 0;
+        int nbitems = 1;
+        while (ring.size ()) {
+            pdb::node_t<npancake_t> item = ring.pop_front ();
+            ASSERT_GE (item.get_g (), current);
+            histogram[item.get_g ()]--;
+            current = item.get_g ();
+
+            if (nbitems < 10*MAX_VALUES && current + maxcost <= MAX_NB_BUCKETS) {
+                for (auto child : randItems (rand () % 4, current, current + maxcost)) {
+                    ring.insert (child);
+                    histogram[child.get_g ()]++;
+                    nbitems++;
+                }
+            }
+
+            // the number of buckets never exceeds the window
+            ASSERT_LE (ring.get_nbbuckets (), 32);
+        }
+
+        // verify all nodes were extracted
+        for (auto j = 0 ; j < histogram.size () ; j++) {
+            ASSERT_EQ (histogram[j], 0);
+        }
+
+        // and that inserting below the last g-value extracted is forbidden
+        if (current > 0) {
+            EXPECT_THROW (ring.insert (pdb::node_t<npancake_t> (randInstance (5), current - 1)), domain_error);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
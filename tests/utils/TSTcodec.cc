@@ -0,0 +1,105 @@
+// -*- coding: utf-8 -*-
+// TSTcodec.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 23:59:47.811203466 (1792367987)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing the compression of blocks of bytes
+//
+
+#include "../fixtures/TSTcodecfixture.h"
+
+using namespace std;
+
+// Checks that random bytes, which can not be compressed, are stored and
+// correctly recovered
+// ----------------------------------------------------------------------------
+TEST_F (CodecFixture, Random) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        auto data = randBytes (1 + rand () % (1<<16));
+        auto compressed = pdb::block_compress (data.data (), data.size ());
+        ASSERT_LE (compressed.size (), 1 + data.size ());
+
+        vector<uint8_t> out (data.size ());
+        ASSERT_TRUE (pdb::block_decompress (compressed.data (), compressed.size (), out.data (), out.size ()));
+        ASSERT_EQ (out, data);
+    }
+}
+
+// Checks that bytes with runs and a small alphabet are compressed and
+// correctly recovered
+// ----------------------------------------------------------------------------
+TEST_F (CodecFixture, Runs) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        auto data = randRuns (1 + rand () % (1<<16), 1 + rand () % 64);
+        auto compressed = pdb::block_compress (data.data (), data.size ());
+        if (data.size () > 1024) {
+            ASSERT_LT (compressed.size (), data.size ());
+        }
+
+        vector<uint8_t> out (data.size ());
+        ASSERT_TRUE (pdb::block_decompress (compressed.data (), compressed.size (), out.data (), out.size ()));
+        ASSERT_EQ (out, data);
+    }
+
+    // a single run of any length is compressed into a few bytes
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+        vector<uint8_t> data (1 + rand () % (1<<20), uint8_t (rand ()));
+        auto compressed = pdb::block_compress (data.data (), data.size ());
+        vector<uint8_t> out (data.size ());
+        ASSERT_TRUE (pdb::block_decompress (compressed.data (), compressed.size (), out.data (), out.size ()));
+        ASSERT_EQ (out, data);
+        if (data.size () > 1024) {
+            ASSERT_LT (compressed.size (), 1 + pdb::codec_impl::table_bytes + 16);
+        }
+    }
+
+    // and the empty sequence is also compressed
+    auto compressed = pdb::block_compress (nullptr, 0);
+    ASSERT_TRUE (pdb::block_decompress (compressed.data (), compressed.size (), nullptr, 0));
+}
+
+// Checks that corrupted blocks are detected, either because they are
+// truncated or because their contents are not consistent
+// ----------------------------------------------------------------------------
+TEST_F (CodecFixture, Corrupted) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        auto data = randRuns (1024 + rand () % (1<<14), 1 + rand () % 16);
+        auto compressed = pdb::block_compress (data.data (), data.size ());
+        vector<uint8_t> out (data.size ());
+
+        // blocks decompressed into a much different length are rejected.
+        // Small differences are detected with the checksums of the blocks
+        ASSERT_FALSE (pdb::block_decompress (compressed.data (), compressed.size (), out.data (), out.size () / 2));
+        vector<uint8_t> larger (2 * data.size ());
+        ASSERT_FALSE (pdb::block_decompress (compressed.data (), compressed.size (), larger.data (), larger.size ()));
+
+        // and so are truncated blocks or those with an unknown method
+        ASSERT_FALSE (pdb::block_decompress (compressed.data (), 1 + rand () % pdb::codec_impl::table_bytes,
+                                             out.data (), out.size ()));
+        ASSERT_FALSE (pdb::block_decompress (compressed.data (), 0, out.data (), out.size ()));
+        auto unknown = compressed;
+        unknown[0] = uint8_t (2 + rand () % 254);
+        ASSERT_FALSE (pdb::block_decompress (unknown.data (), unknown.size (), out.data (), out.size ()));
+
+        // flipping bits might produce a valid block, but never crashes
+        auto flipped = compressed;
+        size_t loc = 1 + rand () % (flipped.size () - 1);
+        flipped[loc] ^= uint8_t (1 << (rand () % 8));
+        pdb::block_decompress (flipped.data (), flipped.size (), out.data (), out.size ());
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
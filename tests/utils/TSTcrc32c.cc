@@ -0,0 +1,67 @@
+// -*- coding: utf-8 -*-
+// TSTcrc32c.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 18-10-2026 18:09:27.105382619 (1792346967)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Unit tests for testing CRC32C checksums
+//
+
+#include <cstring>
+
+#include "../fixtures/TSTcrc32cfixture.h"
+
+using namespace std;
+
+// Checks the checksums of well-known sequences
+// ----------------------------------------------------------------------------
+TEST_F (CRC32CFixture, KnownValues) {
+
+    const char* digits = "123456789";
+    ASSERT_EQ (pdb::crc32c (reinterpret_cast<const uint8_t*> (digits), strlen (digits)), 0xe3069283);
+    ASSERT_EQ (pdb::crc32c_software (reinterpret_cast<const uint8_t*> (digits), strlen (digits)), 0xe3069283);
+
+    // the checksum of the empty sequence is null
+    ASSERT_EQ (pdb::crc32c (nullptr, 0), 0);
+
+    // and the checksum of 32 null bytes is also known
+    vector<uint8_t> zeroes (32, 0);
+    ASSERT_EQ (pdb::crc32c (zeroes.data (), zeroes.size ()), 0x8a9136aa);
+}
+
+// Checks that the checksums computed with and without hardware support are the
+// same, regardless of the alignment of the data
+// ----------------------------------------------------------------------------
+TEST_F (CRC32CFixture, Software) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        auto bytes = randBytes (1 + rand () % 4096);
+        size_t start = rand () % bytes.size ();
+        size_t length = rand () % (bytes.size () - start + 1);
+        ASSERT_EQ (pdb::crc32c (bytes.data () + start, length),
+                   pdb::crc32c_software (bytes.data () + start, length));
+    }
+}
+
+// Checks that checksums can be computed incrementally
+// ----------------------------------------------------------------------------
+TEST_F (CRC32CFixture, Incremental) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        auto bytes = randBytes (1 + rand () % 4096);
+        size_t split = rand () % (bytes.size () + 1);
+        uint32_t crc = pdb::crc32c (bytes.data (), split);
+        ASSERT_EQ (pdb::crc32c (bytes.data () + split, bytes.size () - split, crc),
+                   pdb::crc32c (bytes.data (), bytes.size ()));
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End: